@@ -0,0 +1,13 @@
+#ifndef HEADER_GAENARI_CONFIG_H
+#define HEADER_GAENARI_CONFIG_H
+
+// this file(gaenari-config.h) is generated by cmake.
+
+#define GAENARI_VERSION_MAJOR	1
+#define GAENARI_VERSION_MINOR	2
+#define GAENARI_VERSION_PATCH	
+#define GAENARI_VERSION_TWEAK	
+#define __QuOtE__(name)			#name
+#define GAENARI_VERSION			__QuOtE__(1.2)
+
+#endif // HEADER_GAENARI_CONFIG_H
@@ -0,0 +1,201 @@
+#ifndef HEADER_GAENARI_GAENARI_COMMON_BINARY_FILE_HPP
+#define HEADER_GAENARI_GAENARI_COMMON_BINARY_FILE_HPP
+
+namespace gaenari {
+namespace common {
+
+// read-only binary file of a header, the sections and the string table, loaded by memory mapping.
+// (ex: method::decision_tree::mapped_tree, supul::snapshot::mapped_forest)
+//
+//   offset          | content
+//   ----------------+----------------------------------------------------------------------
+//   0               | header. (header_t)
+//   ...             | sections. (ex: names, plain old data arrays)
+//   strings offset  | string table. (see mapped_strings)
+//   ----------------+----------------------------------------------------------------------
+//
+// header_t is the plain old data of the file, and has the common members,
+//   char     magic[8];
+//   uint32_t version;
+//   uint32_t byte_order;
+//   uint64_t file_size;
+// the header is written at last, after the offsets and the counts of the sections are known.
+//
+// binary_file_writer w;
+// if (not w.open(path, sizeof(header))) ... error ...
+// header.nodes_offset = w.padding(64);
+// w.write_bytes(nodes.data(), sizeof(node) * nodes.size());
+// header.string_count = w.write_strings(strings, header.strings_offset);
+// ...
+// if (not w.close(header)) ... error ...
+//
+// mapped_file f;
+// f.open(path);
+// binary_file_reader r(f.data(), f.size());
+// if (r.read_header(magic, version, byte_order, header) != binary_file_status::ok) ... error ...
+// r.seek(header.names_offset, header.nodes_offset);
+// if (not r.read_string(name)) ... invalid ...
+//
+// the errors are returned, and the caller raises its own exception.
+
+// result of binary_file_reader::read_header(...).
+enum class binary_file_status {
+	ok,
+	invalid,						// too small, bad magic or file size mis-match.
+	not_supported_version,
+	different_byte_order,			// the file of a different platform.
+};
+
+class binary_file_writer {
+public:
+	binary_file_writer()  = default;
+	~binary_file_writer() = default;
+
+public:
+	// create the file, and reserve the header of header_size bytes. returns false if failed.
+	bool open(_in const std::string& path, _in size_t header_size);
+
+	// write at the current position.
+	template <typename T>
+	inline void write_value(_in const T& v) {write_bytes(&v, sizeof(v));}
+	void write_bytes(_in const void* p, _in size_t size);
+
+	// length(4) and bytes.
+	void write_string(_in const std::string& s);
+
+	// zero padding to the alignment, and returns the aligned position.
+	size_t padding(_in size_t alignment);
+
+	// current position.
+	size_t tell(void);
+
+	// write the string table at the aligned position. (see mapped_strings)
+	// offset is set to the position of the section, and returns the string count.
+	size_t write_strings(_in const string_table& strings, _out uint64_t& offset);
+
+	// set header.file_size, write the header at the beginning, and close. returns false if failed.
+	template <typename header_t>
+	bool close(_in _out header_t& header);
+
+protected:
+	std::ofstream file;
+};
+
+class binary_file_reader {
+public:
+	binary_file_reader(_in const void* base, _in size_t size): base{static_cast<const char*>(base)}, size{size} {}
+	~binary_file_reader() = default;
+
+public:
+	// copy the header, and check the magic, the version, the byte order and the file size.
+	template <typename header_t>
+	binary_file_status read_header(_in const char* magic, _in uint32_t version, _in uint32_t byte_order, _out header_t& header) const;
+
+	// read [pos, end) with the following read functions.
+	void seek(_in uint64_t pos, _in uint64_t end);
+
+	// read at the current position. returns false if out of the range.
+	template <typename T>
+	bool read_value(_out T& v);
+
+	// length(4) and bytes. returns false if out of the range.
+	bool read_string(_out std::string& s);
+
+	// attach the string table section from offset to the end of the file. (see mapped_strings)
+	// returns false if invalid or the string count is not count.
+	bool attach_strings(_in _out mapped_strings& strings, _in uint64_t offset, _in uint64_t count) const;
+
+protected:
+	const char* base = nullptr;
+	size_t size = 0;
+	size_t pos = 0;
+	size_t end = 0;
+};
+
+// implementation.
+
+inline bool binary_file_writer::open(_in const std::string& path, _in size_t header_size) {
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (not file.is_open()) return false;
+	// header is written at last.
+	for (size_t i=0; i<header_size; i++) file.put('\0');
+	return true;
+}
+
+inline void binary_file_writer::write_bytes(_in const void* p, _in size_t size) {
+	file.write(static_cast<const char*>(p), static_cast<std::streamsize>(size));
+}
+
+inline void binary_file_writer::write_string(_in const std::string& s) {
+	write_value(static_cast<uint32_t>(s.size()));
+	write_bytes(s.data(), s.size());
+}
+
+inline size_t binary_file_writer::padding(_in size_t alignment) {
+	auto pos = tell();
+	for (; pos % alignment != 0; pos++) file.put('\0');
+	return pos;
+}
+
+inline size_t binary_file_writer::tell(void) {
+	return static_cast<size_t>(file.tellp());
+}
+
+inline size_t binary_file_writer::write_strings(_in const string_table& strings, _out uint64_t& offset) {
+	offset = static_cast<uint64_t>(padding(mapped_strings::alignment));
+	return mapped_strings::write(file, strings);
+}
+
+template <typename header_t>
+inline bool binary_file_writer::close(_in _out header_t& header) {
+	header.file_size = static_cast<uint64_t>(tell());
+	file.seekp(0);
+	write_value(header);
+	file.close();
+	return not file.fail();
+}
+
+template <typename header_t>
+inline binary_file_status binary_file_reader::read_header(_in const char* magic, _in uint32_t version, _in uint32_t byte_order, _out header_t& header) const {
+	if ((not base) or (size < sizeof(header))) return binary_file_status::invalid;
+	memcpy(&header, base, sizeof(header));
+	if (memcmp(header.magic, magic, sizeof(header.magic)) != 0) return binary_file_status::invalid;
+	if (header.version != version) return binary_file_status::not_supported_version;
+	if (header.byte_order != byte_order) return binary_file_status::different_byte_order;
+	if (header.file_size != size) return binary_file_status::invalid;
+	return binary_file_status::ok;
+}
+
+inline void binary_file_reader::seek(_in uint64_t pos, _in uint64_t end) {
+	this->end = static_cast<size_t>(std::min(end, static_cast<uint64_t>(size)));
+	this->pos = static_cast<size_t>(std::min(pos, static_cast<uint64_t>(this->end)));
+}
+
+template <typename T>
+inline bool binary_file_reader::read_value(_out T& v) {
+	if (end - pos < sizeof(v)) return false;
+	memcpy(&v, base + pos, sizeof(v));
+	pos += sizeof(v);
+	return true;
+}
+
+inline bool binary_file_reader::read_string(_out std::string& s) {
+	uint32_t length = 0;
+	if (not read_value(length)) return false;
+	if (end - pos < length) return false;
+	s.assign(base + pos, length);
+	pos += length;
+	return true;
+}
+
+inline bool binary_file_reader::attach_strings(_in _out mapped_strings& strings, _in uint64_t offset, _in uint64_t count) const {
+	if ((offset > size) or (offset % mapped_strings::alignment != 0)) return false;
+	if (not strings.attach(base + offset, size - static_cast<size_t>(offset))) return false;
+	if (strings.size() != count) {strings.detach(); return false;}
+	return true;
+}
+
+} // common
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_COMMON_BINARY_FILE_HPP
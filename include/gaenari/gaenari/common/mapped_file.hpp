@@ -0,0 +1,119 @@
+#ifndef HEADER_GAENARI_GAENARI_COMMON_MAPPED_FILE_HPP
+#define HEADER_GAENARI_GAENARI_COMMON_MAPPED_FILE_HPP
+
+namespace gaenari {
+namespace common {
+
+// read-only memory mapped file.
+//
+// the file is mapped to memory without reading it.
+// the pages are loaded on access, and the os can drop them under memory pressure.
+// so, a file larger than the physical memory can be accessed like an array.
+//
+// mapped_file f;
+// f.open("/temp/data.bin");
+// auto p = static_cast<const uint8_t*>(f.data());
+// for (size_t i=0; i<f.size(); i++) ... p[i] ...
+// f.close();
+//
+// - remove_on_close : the file is removed after unmapped. (ex: temporary spill file)
+class mapped_file {
+public:
+	mapped_file()  = default;
+	~mapped_file() {close();}
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+public:
+	void open(_in const std::string& path, _in bool remove_on_close = false);
+	void close(void);
+	inline bool        is_open(void) const {return opened;}
+	inline const void* data(void)    const {return ptr;}
+	inline size_t      size(void)    const {return length;}
+	inline const std::string& get_path(void) const {return path;}
+
+protected:
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = NULL;
+#else
+	int fd = -1;
+#endif
+	bool opened = false;
+	bool remove_on_close = false;
+	const void* ptr = nullptr;
+	size_t length = 0;
+	std::string path;
+};
+
+// implementation.
+
+#ifdef _WIN32
+// windows version.
+inline void mapped_file::open(_in const std::string& path, _in bool remove_on_close) {
+	close();
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) THROW_GAENARI_ERROR("fail to open file: " + path);
+	LARGE_INTEGER file_size;
+	if (not GetFileSizeEx(file, &file_size)) {close(); THROW_GAENARI_ERROR("fail to get file size: " + path);}
+	length = static_cast<size_t>(file_size.QuadPart);
+	this->path = path;
+	this->remove_on_close = remove_on_close;
+	opened = true;
+	// empty file can not be mapped.
+	if (length == 0) return;
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (not mapping) {close(); THROW_GAENARI_ERROR("fail to ::CreateFileMappingA, GetLastError: " + std::to_string(GetLastError()));}
+	ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (not ptr) {close(); THROW_GAENARI_ERROR("fail to ::MapViewOfFile, GetLastError: " + std::to_string(GetLastError()));}
+}
+
+inline void mapped_file::close(void) {
+	if (ptr) UnmapViewOfFile(ptr);
+	if (mapping) CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+	ptr = nullptr;
+	mapping = NULL;
+	file = INVALID_HANDLE_VALUE;
+	if (opened and remove_on_close) ::remove(path.c_str());
+	opened = false;
+	remove_on_close = false;
+	length = 0;
+	path.clear();
+}
+#else
+// linux version.
+inline void mapped_file::open(_in const std::string& path, _in bool remove_on_close) {
+	close();
+	fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) THROW_GAENARI_ERROR("fail to open file: " + path);
+	struct stat st;
+	if (fstat(fd, &st) != 0) {close(); THROW_GAENARI_ERROR("fail to get file size: " + path);}
+	length = static_cast<size_t>(st.st_size);
+	this->path = path;
+	this->remove_on_close = remove_on_close;
+	opened = true;
+	// empty file can not be mapped.
+	if (length == 0) return;
+	void* p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+	if (p == MAP_FAILED) {close(); THROW_GAENARI_ERROR("fail to mmap: " + path);}
+	ptr = p;
+}
+
+inline void mapped_file::close(void) {
+	if (ptr) munmap(const_cast<void*>(ptr), length);
+	if (fd >= 0) ::close(fd);
+	ptr = nullptr;
+	fd = -1;
+	if (opened and remove_on_close) ::remove(path.c_str());
+	opened = false;
+	remove_on_close = false;
+	length = 0;
+	path.clear();
+}
+#endif // _WIN32
+
+} // common
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_COMMON_MAPPED_FILE_HPP
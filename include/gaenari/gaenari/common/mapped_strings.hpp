@@ -0,0 +1,163 @@
+#ifndef HEADER_GAENARI_GAENARI_COMMON_MAPPED_STRINGS_HPP
+#define HEADER_GAENARI_GAENARI_COMMON_MAPPED_STRINGS_HPP
+
+namespace gaenari {
+namespace common {
+
+// string table section of a memory mapped binary file.
+//
+// string_table is written as a section of a binary file,
+// and the strings are looked up on the mapped memory by binary search without building a string_table.
+//
+//   offset          | content
+//   ----------------+----------------------------------------------------------------------
+//   0               | count(8)
+//   8               | entries. {id(8), offset(8), length(4), reserved(4)} * count. (sorted by id)
+//                   | order. entry index(4) * count. (sorted by string)
+//                   | bytes.
+//   ----------------+----------------------------------------------------------------------
+//
+// the section starts at an 8-byte aligned offset.
+//
+// mapped_strings::write(file, strings);
+// ...
+// mapped_strings s;
+// if (not s.attach(p, size)) ... invalid ...
+// auto id = s.get_id("abc");
+class mapped_strings {
+public:
+	mapped_strings()  = default;
+	~mapped_strings() = default;
+
+	struct entry {
+		int64_t  id;				// string table id.
+		uint64_t offset;			// offset in the bytes.
+		uint32_t length;
+		uint32_t reserved;
+	};
+
+	static constexpr size_t alignment = 8;
+
+public:
+	// write the string table at the current position of file. (alignment is required)
+	// returns the string count.
+	static size_t write(_in _out std::ofstream& file, _in const string_table& strings);
+
+	// attach the section of the mapped memory. returns false if invalid.
+	bool attach(_in const void* p, _in size_t size);
+
+	// detach.
+	void detach(void);
+
+	// string count.
+	inline size_t size(void) const {return count;}
+
+	// string of the id. exception if not existed.
+	std::string get_string(_in size_t id) const;
+
+	// id of the string. max size_t if not existed.
+	// a duplicated string has many ids, and the id of string_table::get_id(...) is returned.
+	size_t get_id(_in const std::string& s) const;
+
+protected:
+	inline std::string_view entry_string(_in const entry& e) const {return std::string_view(bytes + e.offset, e.length);}
+
+protected:
+	const entry* entries = nullptr;		// points the mapped memory.
+	const uint32_t* order = nullptr;	// points the mapped memory.
+	const char* bytes = nullptr;		// points the mapped memory.
+	size_t count = 0;
+};
+
+static_assert(sizeof(mapped_strings::entry) == 24, "invalid mapped_strings::entry size.");
+
+// implementation.
+
+inline size_t mapped_strings::write(_in _out std::ofstream& file, _in const string_table& strings) {
+	auto write_value = [&](const auto& v) {file.write(reinterpret_cast<const char*>(&v), sizeof(v));};
+
+	// ids may have holes(nullptr), get_string_noexept(...) returns an empty string for them.
+	std::vector<std::pair<int, const std::string*>> items;
+	const int last_id = strings.get_last_id();
+	const int empty_id = strings.get_id(std::string{});
+	for (int id=0; id<=last_id; id++) {
+		const auto& s = strings.get_string_noexept(id);
+		if (s.empty() and (id != empty_id)) continue;
+		items.emplace_back(id, &s);
+	}
+
+	// a duplicated string has many ids, and the id of strings.get_id(...) comes first.
+	std::vector<uint32_t> sorted(items.size());
+	std::iota(sorted.begin(), sorted.end(), 0);
+	std::stable_sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) {
+		const auto& sa = *items[a].second;
+		const auto& sb = *items[b].second;
+		if (sa != sb) return sa < sb;
+		return (strings.get_id(sa) == items[a].first) and (strings.get_id(sb) != items[b].first);
+	});
+
+	if (static_cast<size_t>(file.tellp()) % alignment != 0) THROW_GAENARI_INTERNAL_ERROR0;
+	write_value(static_cast<uint64_t>(items.size()));
+	uint64_t offset = 0;
+	for (const auto& item: items) {
+		entry e = {static_cast<int64_t>(item.first), offset, static_cast<uint32_t>(item.second->size()), 0};
+		write_value(e);
+		offset += item.second->size();
+	}
+	for (const auto i: sorted) write_value(i);
+	for (const auto& item: items) file.write(item.second->data(), item.second->size());
+	return items.size();
+}
+
+inline bool mapped_strings::attach(_in const void* p, _in size_t size) {
+	detach();
+	const auto* base = static_cast<const char*>(p);
+	uint64_t n = 0;
+	if ((not base) or (reinterpret_cast<uintptr_t>(base) % alignment != 0) or (size < sizeof(n))) return false;
+	memcpy(&n, base, sizeof(n));
+	if ((size - sizeof(n)) / (sizeof(entry) + sizeof(uint32_t)) < n) return false;
+
+	const auto* _entries = reinterpret_cast<const entry*>(base + sizeof(n));
+	const auto* _order   = reinterpret_cast<const uint32_t*>(_entries + n);
+	const auto* _bytes   = reinterpret_cast<const char*>(_order + n);
+	const size_t bytes_size = size - static_cast<size_t>(_bytes - base);
+	for (size_t i=0; i<n; i++) {
+		if ((_entries[i].offset > bytes_size) or (_entries[i].length > bytes_size - _entries[i].offset)) return false;
+		if ((i > 0) and (_entries[i-1].id >= _entries[i].id)) return false;
+		if (_order[i] >= n) return false;
+	}
+
+	entries = _entries;
+	order   = _order;
+	bytes   = _bytes;
+	count   = static_cast<size_t>(n);
+	return true;
+}
+
+inline void mapped_strings::detach(void) {
+	entries = nullptr;
+	order = nullptr;
+	bytes = nullptr;
+	count = 0;
+}
+
+inline std::string mapped_strings::get_string(_in size_t id) const {
+	// binary search by id.
+	const auto* end = entries + count;
+	const auto* find = std::lower_bound(entries, end, id, [](const entry& e, size_t v) {return static_cast<size_t>(e.id) < v;});
+	if ((find == end) or (static_cast<size_t>(find->id) != id)) THROW_GAENARI_ERROR("string id not found: " + std::to_string(id));
+	return std::string(entry_string(*find));
+}
+
+inline size_t mapped_strings::get_id(_in const std::string& s) const {
+	// binary search by string.
+	const auto* end = order + count;
+	const auto* find = std::lower_bound(order, end, std::string_view(s), [&](uint32_t i, std::string_view v) {return entry_string(entries[i]) < v;});
+	if ((find == end) or (entry_string(entries[*find]) != s)) return std::numeric_limits<size_t>::max();
+	return static_cast<size_t>(entries[*find].id);
+}
+
+} // common
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_COMMON_MAPPED_STRINGS_HPP
@@ -89,6 +89,13 @@ inline COUNTABLE map_count(_in const std::map<K,COUNTABLE>& m) {
 	return ret;
 }
 
+template<typename K, typename COUNTABLE, size_t N>
+inline COUNTABLE map_count(_in const small_flat_map<K,COUNTABLE,N>& m) {
+	COUNTABLE ret = 0;
+	for (const auto& it: m) ret += it.second;
+	return ret;
+}
+
 template<typename K,typename V>
 inline const V& map_find(const std::map<K,V>& m, const K& k, const V& def) {
 	const auto& f = m.find(k);
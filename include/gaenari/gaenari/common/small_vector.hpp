@@ -0,0 +1,276 @@
+#ifndef HEADER_GAENARI_GAENARI_COMMON_SMALL_VECTOR_HPP
+#define HEADER_GAENARI_GAENARI_COMMON_SMALL_VECTOR_HPP
+
+namespace gaenari {
+namespace common {
+
+// vector with inline storage of N items.
+//
+// up to N items are stored in the object itself without heap allocation.
+// more than N items, they overflow to the heap like std::vector.
+// the inline storage and the heap pointer share the same memory,
+// so small_vector<size_t,1> is 16 bytes. (std::vector is 24 bytes + heap allocation)
+//
+// small_vector<size_t,1> v = {3};	// inline, no allocation
+// v.push_back(5);					// overflow to the heap
+// for (auto& i: v) ...
+template <typename T, size_t N>
+class small_vector {
+	static_assert(N > 0, "small_vector needs inline storage.");
+public:
+	using value_type     = T;
+	using size_type      = size_t;
+	using iterator       = T*;
+	using const_iterator = const T*;
+	using reference      = T&;
+	using const_reference= const T&;
+
+public:
+	small_vector() noexcept {}
+	small_vector(_in std::initializer_list<T> l) {assign(l.begin(), l.end());}
+	small_vector(_in const small_vector& s) {assign(s.begin(), s.end());}
+	small_vector(_in small_vector&& s) noexcept {move_from(s);}
+	~small_vector() {clear(); release();}
+
+	small_vector& operator=(_in const small_vector& s) {
+		if (this != &s) {clear(); assign(s.begin(), s.end());}
+		return *this;
+	}
+
+	small_vector& operator=(_in small_vector&& s) noexcept {
+		if (this != &s) {clear(); release(); move_from(s);}
+		return *this;
+	}
+
+	small_vector& operator=(_in std::initializer_list<T> l) {
+		clear();
+		assign(l.begin(), l.end());
+		return *this;
+	}
+
+public:
+	inline size_t size(void)     const {return count;}
+	inline bool   empty(void)    const {return count == 0;}
+	inline size_t capacity(void) const {return cap;}
+
+	// items are stored in the object itself.
+	inline bool is_inline(void) const {return cap == N;}
+
+	inline T*       data(void)       {return is_inline() ? reinterpret_cast<T*>(storage.buf) : storage.heap;}
+	inline const T* data(void) const {return is_inline() ? reinterpret_cast<const T*>(storage.buf) : storage.heap;}
+
+	inline T&       operator[](_in size_t i)       {return data()[i];}
+	inline const T& operator[](_in size_t i) const {return data()[i];}
+	inline T&       front(void)       {return data()[0];}
+	inline const T& front(void) const {return data()[0];}
+	inline T&       back(void)        {return data()[count-1];}
+	inline const T& back(void)  const {return data()[count-1];}
+
+	inline iterator       begin(void)        {return data();}
+	inline iterator       end(void)          {return data() + count;}
+	inline const_iterator begin(void)  const {return data();}
+	inline const_iterator end(void)    const {return data() + count;}
+	inline const_iterator cbegin(void) const {return data();}
+	inline const_iterator cend(void)   const {return data() + count;}
+
+public:
+	inline void push_back(_in const T& v) {emplace_back(v);}
+	inline void push_back(_in T&& v)      {emplace_back(std::move(v));}
+
+	template <typename... args_t>
+	inline T& emplace_back(args_t&&... args) {
+		if (count == cap) {
+			// v can be an item of this. construct it before growing.
+			T v(std::forward<args_t>(args)...);
+			reserve(static_cast<size_t>(cap) * 2);
+			return *new (data() + count++) T(std::move(v));
+		}
+		return *new (data() + count++) T(std::forward<args_t>(args)...);
+	}
+
+	inline void pop_back(void) {
+		data()[--count].~T();
+	}
+
+	// insert v before pos.
+	inline iterator insert(_in const_iterator pos, _in T v) {
+		const size_t index = static_cast<size_t>(pos - begin());
+		emplace_back(std::move(v));
+		std::rotate(begin() + index, end() - 1, end());
+		return begin() + index;
+	}
+
+	// erase the item at pos.
+	inline iterator erase(_in const_iterator pos) {
+		const size_t index = static_cast<size_t>(pos - begin());
+		std::move(begin() + index + 1, end(), begin() + index);
+		pop_back();
+		return begin() + index;
+	}
+
+	inline void clear(void) {
+		T* p = data();
+		for (uint32_t i=0; i<count; i++) p[i].~T();
+		count = 0;
+	}
+
+	// the heap memory is kept. (like std::vector)
+	inline void reserve(_in size_t n) {
+		if (n <= cap) return;
+		if (n > std::numeric_limits<uint32_t>::max()) THROW_GAENARI_ERROR("too many items of small_vector.");
+		T* p   = static_cast<T*>(::operator new(sizeof(T) * n));
+		T* old = data();
+		for (uint32_t i=0; i<count; i++) {
+			new (p + i) T(std::move(old[i]));
+			old[i].~T();
+		}
+		// the inline storage and the heap pointer share the memory.
+		// items are moved out, then the heap pointer is set.
+		release();
+		storage.heap = p;
+		cap = static_cast<uint32_t>(n);
+	}
+
+	inline void resize(_in size_t n) {
+		reserve(n);
+		while (count > n) pop_back();
+		while (count < n) emplace_back();
+	}
+
+public:
+	friend inline bool operator==(_in const small_vector& a, _in const small_vector& b) {
+		return (a.count == b.count) and std::equal(a.begin(), a.end(), b.begin());
+	}
+	friend inline bool operator!=(_in const small_vector& a, _in const small_vector& b) {
+		return not (a == b);
+	}
+
+protected:
+	template <typename it_t>
+	inline void assign(_in it_t first, _in it_t last) {
+		reserve(static_cast<size_t>(std::distance(first, last)));
+		for (; first!=last; ++first) new (data() + count++) T(*first);
+	}
+
+	// s must be cleared and released.
+	inline void move_from(_in _out small_vector& s) noexcept {
+		if (s.is_inline()) {
+			T* p = s.data();
+			for (uint32_t i=0; i<s.count; i++) {
+				new (reinterpret_cast<T*>(storage.buf) + i) T(std::move(p[i]));
+				p[i].~T();
+			}
+			count = s.count;
+		} else {
+			storage.heap = s.storage.heap;
+			count = s.count;
+			cap   = s.cap;
+			s.cap = N;
+		}
+		s.count = 0;
+	}
+
+	// free the heap memory. items must be destroyed.
+	inline void release(void) {
+		if (is_inline()) return;
+		::operator delete(storage.heap);
+		cap = N;
+	}
+
+protected:
+	union storage_t {
+		storage_t() {}
+		~storage_t() {}
+		T* heap;
+		alignas(T) unsigned char buf[sizeof(T) * N];
+	} storage;
+	uint32_t count = 0;
+	uint32_t cap   = static_cast<uint32_t>(N);	// N means inline.
+};
+
+// sorted (key, value) map on small_vector.
+//
+// the map of a few keys(ex: label count of a tree node) is a contiguous array without heap allocation.
+// the interface is a subset of std::map, and the iteration is in key order like std::map.
+// it's a flat array, so insert and erase are O(n). use it only for small maps.
+template <typename key_t, typename value_t, size_t N>
+class small_flat_map {
+public:
+	using key_type       = key_t;
+	using mapped_type    = value_t;
+	using value_type     = std::pair<key_t, value_t>;
+	using container      = small_vector<value_type, N>;
+	using iterator       = typename container::iterator;
+	using const_iterator = typename container::const_iterator;
+
+public:
+	small_flat_map()  = default;
+	~small_flat_map() = default;
+	small_flat_map(_in std::initializer_list<value_type> l) {for (const auto& it: l) emplace(it.first, it.second);}
+
+public:
+	inline size_t size(void)  const {return items.size();}
+	inline bool   empty(void) const {return items.empty();}
+	inline void   clear(void)       {items.clear();}
+
+	inline iterator       begin(void)       {return items.begin();}
+	inline iterator       end(void)         {return items.end();}
+	inline const_iterator begin(void) const {return items.begin();}
+	inline const_iterator end(void)   const {return items.end();}
+
+	inline iterator lower_bound(_in const key_t& k) {
+		return std::lower_bound(items.begin(), items.end(), k, [](const value_type& a, const key_t& b) {return a.first < b;});
+	}
+	inline const_iterator lower_bound(_in const key_t& k) const {
+		return std::lower_bound(items.begin(), items.end(), k, [](const value_type& a, const key_t& b) {return a.first < b;});
+	}
+
+	inline iterator find(_in const key_t& k) {
+		auto it = lower_bound(k);
+		return ((it != end()) and (it->first == k)) ? it : end();
+	}
+	inline const_iterator find(_in const key_t& k) const {
+		auto it = lower_bound(k);
+		return ((it != end()) and (it->first == k)) ? it : end();
+	}
+
+	inline size_t count(_in const key_t& k) const {return (find(k) == end()) ? 0 : 1;}
+
+	// returns (iterator, inserted). not inserted if k already exists.
+	inline std::pair<iterator,bool> emplace(_in const key_t& k, _in const value_t& v) {
+		auto it = lower_bound(k);
+		if ((it != end()) and (it->first == k)) return {it, false};
+		return {items.insert(it, value_type{k, v}), true};
+	}
+
+	// keys in ascending order are appended at the end without search.
+	inline iterator emplace_hint(_in const_iterator hint, _in const key_t& k, _in const value_t& v) {
+		if ((hint == end()) and (empty() or (items.back().first < k))) {
+			items.emplace_back(k, v);
+			return end() - 1;
+		}
+		return emplace(k, v).first;
+	}
+
+	inline value_t& operator[](_in const key_t& k) {
+		return emplace(k, value_t{}).first->second;
+	}
+
+	inline size_t erase(_in const key_t& k) {
+		auto it = find(k);
+		if (it == end()) return 0;
+		items.erase(it);
+		return 1;
+	}
+
+	friend inline bool operator==(_in const small_flat_map& a, _in const small_flat_map& b) {return a.items == b.items;}
+	friend inline bool operator!=(_in const small_flat_map& a, _in const small_flat_map& b) {return a.items != b.items;}
+
+protected:
+	container items;
+};
+
+} // common
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_COMMON_SMALL_VECTOR_HPP
@@ -0,0 +1,269 @@
+#ifndef HEADER_GAENARI_GAENARI_COMMON_THREAD_POOL_HPP
+#define HEADER_GAENARI_GAENARI_COMMON_THREAD_POOL_HPP
+
+namespace gaenari {
+namespace common {
+
+// simple fixed size work-stealing thread pool.
+//
+// each worker has its own task deque.
+// - a task submitted from a worker is pushed to the back of the worker's deque.
+// - the worker pops its own tasks from the back(lifo, cache-friendly for recursive tasks).
+// - an idle worker steals from the front of the other deques(fifo, usually bigger tasks).
+// - a task submitted from outside of the pool is pushed to the shared deque.
+//
+// the calling thread also joins the work in parallel_for(...) and task_group::wait(),
+// so it is safe to call them inside of a task(nested call).
+//
+// ex)
+// common::thread_pool pool{4};
+// std::vector<double> r(100);
+// pool.parallel_for(r.size(), [&r](size_t i) {
+//		r[i] = heavy(i);
+// });
+class thread_pool {
+public:
+	using task_t = std::function<void()>;
+
+public:
+	thread_pool() = delete;
+	// thread_count : total thread count including the calling thread.
+	//                0 means std::thread::hardware_concurrency().
+	//                1 means no worker thread, run in the calling thread.
+	inline thread_pool(_in size_t thread_count) {
+		if (thread_count == 0) thread_count = std::thread::hardware_concurrency();
+		if (thread_count == 0) thread_count = 1;
+		// queues[0, thread_count-1) : each worker.
+		// queues[thread_count-1]    : shared.
+		for (size_t i=0; i<thread_count; i++) queues.emplace_back(std::make_unique<queue_t>());
+		for (size_t i=1; i<thread_count; i++) workers.emplace_back([this, i]() {worker_main(i-1);});
+	}
+	inline ~thread_pool() {
+		{
+			std::lock_guard<std::mutex> l(mutex);
+			stop = true;
+		}
+		cv.notify_all();
+		for (auto& worker: workers) worker.join();
+	}
+
+public:
+	// total thread count including the calling thread.
+	inline size_t size(void) const {
+		return workers.size() + 1;
+	}
+
+	// add a task.
+	// the task must not throw. (use task_group to get the exception.)
+	inline void submit(_in task_t task) {
+		if (workers.empty()) {
+			task();
+			return;
+		}
+		auto& queue = *queues[get_queue_index()];
+		pending.fetch_add(1);
+		{
+			std::lock_guard<std::mutex> l(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+		{
+			// empty lock to prevent the lost wake-up.
+			std::lock_guard<std::mutex> l(mutex);
+		}
+		cv.notify_one();
+	}
+
+	// run one pending task in the calling thread.
+	// returns false if there is no pending task.
+	inline bool run_pending_task(void) {
+		task_t task;
+		if (not pop_task(get_queue_index(), task)) return false;
+		task();
+		return true;
+	}
+
+	// call fn(0), fn(1), ..., fn(count-1) in parallel and wait for all.
+	// the order of calls is not guaranteed.
+	// if fn throws, the first exception is re-thrown to the caller after all calls are finished.
+	inline void parallel_for(_in size_t count, _in const std::function<void(size_t)>& fn) {
+		if (count == 0) return;
+		if (workers.empty() or (count == 1)) {
+			for (size_t i=0; i<count; i++) fn(i);
+			return;
+		}
+
+		// shared between the caller and the helper tasks.
+		// helper tasks can start after this function returns, so it's shared_ptr.
+		struct state_t {
+			std::atomic<size_t> next{0};
+			std::atomic<size_t> done{0};
+			size_t count = 0;
+			const std::function<void(size_t)>* fn = nullptr;
+			std::mutex mutex;
+			std::condition_variable cv;
+			std::exception_ptr error;
+		};
+		auto state = std::make_shared<state_t>();
+		state->count = count;
+		state->fn = &fn;
+
+		// claim the index one by one.
+		auto run = [](_in const std::shared_ptr<state_t>& state) {
+			for (;;) {
+				size_t i = state->next.fetch_add(1);
+				if (i >= state->count) break;
+				try {
+					(*state->fn)(i);
+				} catch (...) {
+					std::lock_guard<std::mutex> l(state->mutex);
+					if (not state->error) state->error = std::current_exception();
+				}
+				if (state->done.fetch_add(1) + 1 == state->count) {
+					std::lock_guard<std::mutex> l(state->mutex);
+					state->cv.notify_all();
+				}
+			}
+		};
+
+		// helpers.
+		size_t helper_count = std::min(workers.size(), count - 1);
+		for (size_t i=0; i<helper_count; i++) submit([state, run]() {run(state);});
+
+		// the caller also works, and waits only for the claimed indexes.
+		run(state);
+		{
+			std::unique_lock<std::mutex> l(state->mutex);
+			state->cv.wait(l, [&state]() {return state->done.load() == state->count;});
+		}
+		if (state->error) std::rethrow_exception(state->error);
+	}
+
+protected:
+	struct queue_t {
+		std::mutex mutex;
+		std::deque<task_t> tasks;
+	};
+
+	// the queue index of the calling thread.
+	// a worker uses its own queue, and the others use the shared queue.
+	inline size_t get_queue_index(void) const {
+		const auto& current = get_current();
+		if (current.first == this) return current.second;
+		return queues.size() - 1;
+	}
+
+	// (pool, worker index) of the current thread.
+	static inline std::pair<const thread_pool*, size_t>& get_current(void) {
+		thread_local std::pair<const thread_pool*, size_t> current{nullptr, 0};
+		return current;
+	}
+
+	// pop from the back of own queue, or steal from the front of the other queues.
+	inline bool pop_task(_in size_t index, _out task_t& task) {
+		if (pending.load() == 0) return false;
+		size_t count = queues.size();
+		for (size_t i=0; i<count; i++) {
+			auto& queue = *queues[(index + i) % count];
+			std::lock_guard<std::mutex> l(queue.mutex);
+			if (queue.tasks.empty()) continue;
+			if (i == 0) {
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			} else {
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+			pending.fetch_sub(1);
+			return true;
+		}
+		return false;
+	}
+
+	inline void worker_main(_in size_t index) {
+		get_current() = {this, index};
+		for (;;) {
+			task_t task;
+			if (pop_task(index, task)) {
+				task();
+				continue;
+			}
+			std::unique_lock<std::mutex> l(mutex);
+			cv.wait(l, [this]() {return stop or (pending.load() != 0);});
+			if (stop) return;
+		}
+	}
+
+protected:
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<queue_t>> queues;
+	std::atomic<size_t> pending{0};
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool stop = false;
+};
+
+// a group of tasks that can be waited together.
+// tasks can add more tasks to the same group while running.
+// ex)
+// common::task_group group{pool};
+// group.run([&]() {
+//		...
+//		group.run([&]() {...});
+// });
+// group.wait();
+class task_group {
+public:
+	task_group() = delete;
+	inline task_group(_in thread_pool& pool): pool{pool} {}
+	inline ~task_group() {
+		// do not leave running tasks that refer to this.
+		try { wait(); } catch (...) {}
+	}
+
+public:
+	// run the task in the pool.
+	// the exception of the task is re-thrown by wait().
+	inline void run(_in std::function<void()> task) {
+		pending.fetch_add(1);
+		pool.submit([this, task=std::move(task)]() {
+			try {
+				task();
+			} catch (...) {
+				std::lock_guard<std::mutex> l(mutex);
+				if (not error) error = std::current_exception();
+			}
+			// decrement under the lock, so wait() can not return(and destroy this) before the notification.
+			std::lock_guard<std::mutex> l(mutex);
+			if (pending.fetch_sub(1) == 1) cv.notify_all();
+		});
+	}
+
+	// wait for all tasks while running pending tasks in the calling thread.
+	// the first exception of the tasks is re-thrown.
+	inline void wait(void) {
+		for (;;) {
+			if (pending.load() == 0) break;
+			if (pool.run_pending_task()) continue;
+			std::unique_lock<std::mutex> l(mutex);
+			cv.wait_for(l, std::chrono::milliseconds(1), [this]() {return pending.load() == 0;});
+		}
+		std::exception_ptr e;
+		{
+			std::lock_guard<std::mutex> l(mutex);
+			std::swap(e, error);
+		}
+		if (e) std::rethrow_exception(e);
+	}
+
+protected:
+	thread_pool& pool;
+	std::atomic<size_t> pending{0};
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::exception_ptr error;
+};
+
+} // common
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_COMMON_THREAD_POOL_HPP
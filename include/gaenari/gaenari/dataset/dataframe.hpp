@@ -128,6 +128,17 @@ namespace dataset {
 //  dataframe splited = df.split(0.2, true);
 //                                      ---- => return to 20% rows of df.
 //                                              and, df has the remaining 80%.
+//
+//  df.read_spill<repo>({{"csv_file_path","..."},}, {...}, nullptr, "/temp/df.spill", 256 << 20);
+//     ----------                                                   ---------------  --------- => memory budget bytes.
+//                                                                  => spill file path.
+//                                                  => rows are loaded to memory within the budget.
+//                                                     over the budget, all rows are written to the spill file,
+//                                                     and the file is memory mapped. (see spill.hpp)
+//  df.write_spill("/temp/df.spill");
+//  df.open_spill("/temp/df.spill");
+//     ---------- => memory mapped read-only dataframe. split_with_shrink and append are not supported.
+//                   deep_copy and split make an in-memory copy.
 class dataframe {
 public:
 	dataframe() = default;
@@ -156,6 +167,8 @@ protected:
 		int shared_count = 0;
 		// repository context.
 		void* repository_ctx = nullptr;
+		// memory mapped spill file. data points into it, and it's read-only.
+		common::mapped_file* mapped = nullptr;
 	} **_shared_data = nullptr;
 
 	// non-shared data separately for each dataframe.
@@ -224,12 +237,7 @@ public:
 	inline bool read(_in const std::map<std::string,type::variant>& options, _option_in const std::vector<usecols>& usecols = {usecols::all(data_type_t::data_type_string)}, _option_in void* repository_ctx = nullptr) {
 		repository_base* repo = nullptr;
 		size_t i = 0;
-		size_t j = 0;
-		size_t index = 0;
-		size_t data_item_count = 0;
 		size_t count = false;
-		dataset::usecols matched_usecol;
-		column_info column_info;
 		std::vector<std::string> row_data;
 		std::vector<std::string> column_names;
 		std::map<std::string,size_t>::iterator find;
@@ -267,51 +275,7 @@ public:
 		}
 
 		// add columns which matched condition
-		for (i=0; i<column_names.size(); i++) {
-			matched_usecol.clear();
-			// check condition
-			for (const auto& usecol: usecols) {
-				// find last matched_usecol.
-				// matched_usecol can be overwriten.
-				switch (usecol._selection_type) {
-					case usecols::selection_type::selection_type_all:
-						if (true) matched_usecol = usecol;
-						break;
-					case usecols::selection_type::selection_type_first_n:
-						if (i<usecol._first_n) matched_usecol = usecol;
-						break;
-					case usecols::selection_type::selection_type_last_n:
-						if (i>=column_names.size()-usecol._last_n) matched_usecol = usecol;
-						break;
-					case usecols::selection_type::selection_type_indexes:
-						if (usecol._indexes.end() != std::find(usecol._indexes.begin(), usecol._indexes.end(), i)) matched_usecol = usecol;
-						break;
-					case usecols::selection_type::selection_type_names:
-						if (usecol._names.end() != std::find(usecol._names.begin(), usecol._names.end(), column_names[i])) matched_usecol = usecol;
-						break;
-					case usecols::selection_type::selection_type_regexes:
-						for (const auto& regex: usecol._regexes) {
-							std::regex pattern(regex);
-							if (std::regex_search(column_names[i], pattern)) {
-								matched_usecol = usecol;
-								break;
-							}
-						}
-						break;
-					default:
-						THROW_GAENARI_INTERNAL_ERROR0;
-				}
-			}
-
-			if (matched_usecol._data_type != data_type_t::data_type_unknown) {
-				// column has been matched.
-				column_info.clear();
-				column_info.name = column_names[i];
-				column_info.data_type = matched_usecol._data_type;
-				column_info.repository_index = i;
-				shared_data.columns.push_back(column_info);
-			}
-		}
+		match_columns(column_names, usecols, shared_data.columns);
 
 		if (shared_data.columns.empty()) THROW_GAENARI_ERROR("empty matched usecol.");
 
@@ -351,99 +315,7 @@ public:
 
 			// get row pointer to save
 			auto col  = &shared_data.data[i*shared_data.cols];
-			auto size = shared_data.columns.size();
-			for (j=0; j<size; j++) {
-				const auto& column_info = shared_data.columns[j];
-				const auto& column_data = row_data[column_info.repository_index];
-				size_t column_data_type = column_data.index();	// monostate, int, int64_t, double, std::string&.
-				if (column_data_type == 0) THROW_GAENARI_INTERNAL_ERROR0;
-				else if (column_data_type == 1) {	// int
-					auto& int_value = std::get<1>(column_data);
-					switch (column_info.data_type) {
-						case data_type_t::data_type_int:
-						case data_type_t::data_type_string_table:
-							col[j].numeric_int32 = int_value;
-							break;
-						case data_type_t::data_type_int64:
-							col[j].numeric_int64 = static_cast<int64_t>(int_value);
-							break;
-						case data_type_t::data_type_double:
-							col[j].numeric_double = static_cast<double>(int_value);
-							break;
-						case data_type_t::data_type_string:
-							// the type of value from repository is int, but the column type is string.
-							// this is an error because the size of dataframe::strings can become very large.
-						default:
-							THROW_GAENARI_INTERNAL_ERROR0;
-							break;
-					}
-				} else if (column_data_type == 2) {	// int64_t
-					auto& int64_value = std::get<2>(column_data);
-					switch (column_info.data_type) {
-						case data_type_t::data_type_int:
-						case data_type_t::data_type_string_table:
-							col[j].numeric_int32 = static_cast<int>(int64_value);
-							break;
-						case data_type_t::data_type_int64:
-							col[j].numeric_int64 = int64_value;
-							break;
-						case data_type_t::data_type_double:
-							col[j].numeric_double = static_cast<double>(int64_value);
-							break;
-						case data_type_t::data_type_string:
-							// the type of value from repository is int64_t, but the column type is string.
-							// this is an error because the size of dataframe::strings can become very large.
-						default:
-							THROW_GAENARI_INTERNAL_ERROR0;
-							break;
-					}
-				} else if (column_data_type == 3) {	// double
-					auto& double_value = std::get<3>(column_data);
-					switch (column_info.data_type) {
-						case data_type_t::data_type_int:
-							col[j].numeric_int32 = static_cast<int>(double_value);
-							break;
-						case data_type_t::data_type_int64:
-							col[j].numeric_int64 = static_cast<int64_t>(double_value);
-							break;
-						case data_type_t::data_type_double:
-							col[j].numeric_double = double_value;
-							break;
-						case data_type_t::data_type_string_table:
-							// the type of value from repository is int(string table id), but the column type is double.
-							// it is assumed that real type fields cannot represent string table id.
-						case data_type_t::data_type_string:
-							// the type of value from repository is double, but the column type is string table id(int).
-							// this is an error because the size of dataframe::strings can become very large.
-						default:
-							THROW_GAENARI_INTERNAL_ERROR0;
-							break;
-					}
-				} else if (column_data_type == 4) {	// std::string& (std::reference_wrapper<const std::string>)
-					auto& string_value = std::get<4>(column_data).get();
-					switch (column_info.data_type) {
-						case data_type_t::data_type_int:
-							col[j].numeric_int32 = std::stoi(string_value);
-							break;
-						case data_type_t::data_type_int64:
-							col[j].numeric_int64 = std::stoll(string_value);
-							break;
-						case data_type_t::data_type_double:
-							col[j].numeric_double = std::stod(string_value);
-							break;
-						case data_type_t::data_type_string:
-							col[j].index = shared_data.strings.add(string_value);
-							break;
-						case data_type_t::data_type_string_table:
-							// the type of value from repository is string, but the column type is string table id(int).
-							// this is an error because the size of dataframe::strings can become very large.
-						default:
-							THROW_GAENARI_INTERNAL_ERROR0;
-					}
-				} else {
-					THROW_GAENARI_INTERNAL_ERROR0;
-				}
-			}
+			convert_row(row_data, shared_data.columns, shared_data.strings, col);
 
 			i++;
 			return true;
@@ -468,6 +340,125 @@ public:
 		return true;
 	}
 
+	// same as read(...), but the memory is bounded by memory_budget_bytes.
+	// rows are loaded to memory until the budget is exceeded.
+	// then, all rows are written to spill_path sequentially, and the file is memory mapped. (see open_spill(...))
+	// the pages of the mapped rows are loaded on access, and can be dropped by the os.
+	// - memory_budget_bytes : 0 means always spill.
+	// - remove_on_clear     : the spill file is removed when the dataframe is cleared.
+	// returns true if spilled.
+	template <typename repository_t>
+	inline bool read_spill(_in const std::map<std::string,type::variant>& options, _in const std::vector<usecols>& usecols, _option_in void* repository_ctx, _in const std::string& spill_path, _in size_t memory_budget_bytes, _option_in bool remove_on_clear = true) {
+		const double auto_growth_factor = 1.5;
+		std::vector<std::string> column_names;
+
+		// alloc new shared data.
+		auto& shared_data = alloc_shared_data();
+		if (usecols.empty()) THROW_GAENARI_ERROR("usecols empty.");
+		if (not std::is_base_of<repository_base, repository_t>()) THROW_GAENARI_ERROR("repository_t must be derived from repository_base.");
+		auto repo = std::make_unique<repository_t>();
+		if (not repo->open(options, repository_ctx, column_names)) THROW_GAENARI_ERROR("fail to open.");
+		if (column_names.empty()) THROW_GAENARI_ERROR("empty columns.");
+		shared_data.strings.clear();
+		match_columns(column_names, usecols, shared_data.columns);
+		if (shared_data.columns.empty()) THROW_GAENARI_ERROR("empty matched usecol.");
+		const size_t cols = shared_data.columns.size();
+		const size_t row_bytes = sizeof(type::value_raw) * cols;
+
+		// in-memory rows within the budget.
+		const size_t budget_rows = memory_budget_bytes / row_bytes;
+		size_t count = repo->count();
+		const bool auto_growth = (count == std::numeric_limits<size_t>::max());
+		size_t capacity = std::min<size_t>(auto_growth ? 4 : count, budget_rows);
+		type::value_raw* data = nullptr;
+		if (capacity > 0) {
+			data = (type::value_raw*)malloc(row_bytes * capacity);
+			if (not data) THROW_GAENARI_ERROR("not enough memory.");
+		}
+		std::unique_ptr<type::value_raw, decltype(&free)> data_guard(data, &free);
+		spill_writer writer;
+
+		// read rows.
+		size_t i = 0;
+		repo->read([&](const auto& row_data) -> bool {
+			if ((not auto_growth) and (i >= count)) return false;
+			type::value_raw* col = nullptr;
+			if ((not writer.is_open()) and (i == capacity)) {
+				if (capacity < budget_rows) {
+					// grow within the budget.
+					size_t new_capacity = std::min(budget_rows, std::max(capacity + 1, static_cast<size_t>(capacity * auto_growth_factor)));
+					if (not auto_growth) new_capacity = std::min(new_capacity, count);
+					auto t = (type::value_raw*)realloc(data, row_bytes * new_capacity);
+					if (not t) THROW_GAENARI_ERROR("not enough memory.");
+					data_guard.release();
+					data_guard.reset(t);
+					data = t;
+					capacity = new_capacity;
+				} else {
+					// over the budget. move the rows to the spill file.
+					writer.open(spill_path, shared_data.columns);
+					if (i > 0) writer.append(data, i);
+					data_guard.reset();
+					data = nullptr;
+				}
+			}
+			if (writer.is_open()) {
+				col = writer.add_row();
+			} else {
+				col = &data[i * cols];
+				memset(col, 0, row_bytes);
+			}
+			convert_row(row_data, shared_data.columns, shared_data.strings, col);
+			i++;
+			return true;
+		});
+		repo->close();
+
+		bool spilled = writer.is_open();
+		if (spilled) {
+			// all rows are in the spill file.
+			writer.close(shared_data.strings);
+			attach_spill(shared_data, spill_path, remove_on_clear, false);
+		} else {
+			shared_data.data = data_guard.release();
+			shared_data.rows = i;
+			shared_data.cols = cols;
+			shared_data.data_item_count = shared_data.rows * shared_data.cols;
+		}
+
+		// set private data
+		_private_data.clear();
+		_private_data.cols = shared_data.cols;
+		_private_data.rows = shared_data.rows;
+		_private_data.columns = shared_data.columns;
+		return spilled;
+	}
+
+	// open the spill file as a memory mapped read-only dataframe.
+	// - remove_on_clear : the spill file is removed when the dataframe is cleared.
+	inline void open_spill(_in const std::string& path, _option_in bool remove_on_clear = false) {
+		auto& shared_data = alloc_shared_data();
+		attach_spill(shared_data, path, remove_on_clear, true);
+		_private_data.clear();
+		_private_data.cols = shared_data.cols;
+		_private_data.rows = shared_data.rows;
+		_private_data.columns = shared_data.columns;
+	}
+
+	// write the full data(column selection is ignored) and the string table to the spill file.
+	inline void write_spill(_in const std::string& path) const {
+		const auto& shared_data = get_shared_data_const();
+		spill_writer writer;
+		writer.open(path, shared_data.columns);
+		writer.append(shared_data.data, shared_data.rows);
+		writer.close(shared_data.strings);
+	}
+
+	// is the data memory mapped?
+	inline bool is_mapped(void) const {
+		return _shared_data and (*_shared_data) and ((*_shared_data)->mapped);
+	}
+
 	inline void clear(void) {
 		if (not _shared_data) return;
 		if (not (*_shared_data)) {
@@ -480,7 +471,12 @@ public:
 		auto& shared_data = get_shared_data();
 		shared_data.shared_count--;
 		if (shared_data.shared_count < 0) {
-			if (shared_data.data) {
+			if (shared_data.mapped) {
+				// unmap. (the spill file is removed if remove_on_clear)
+				delete shared_data.mapped;
+				shared_data.mapped = nullptr;
+				shared_data.data = nullptr;
+			} else if (shared_data.data) {
 				free(shared_data.data);
 				shared_data.data = nullptr;
 			}
@@ -811,6 +807,7 @@ public:
 
 		// get shared data
 		auto& shared_data = get_shared_data();
+		if (shared_data.mapped) THROW_GAENARI_ERROR("memory mapped dataframe can not be shrinked.");
 
 		// get split indexes to first and second.
 		auto split_index = common::random_shuffle_with_split(shared_data.rows, split_ratio, true, random_seed);
@@ -1157,8 +1154,9 @@ public:
 		auto& shared_data_out = get_shared_data();
 		auto& shared_data_in  = df.get_shared_data_const();
 		
-		// assume it is not selected.
+		// assume it is not selected, and not memory mapped.
 		if (_private_data.selected) return false;
+		if (shared_data_out.mapped) return false;
 
 		// it is assumed that the columns and strings of two dataframes are the same.
 		if (shared_data_out.columns != shared_data_in.columns) return false;
@@ -1185,6 +1183,170 @@ public:
 		return true;
 	}
 
+	// misc read methods.
+protected:
+	// get the columns matched with usecols.
+	static inline void match_columns(_in const std::vector<std::string>& column_names, _in const std::vector<usecols>& usecols, _out std::vector<column_info>& columns) {
+		dataset::usecols matched_usecol;
+		column_info column_info;
+		for (size_t i=0; i<column_names.size(); i++) {
+			matched_usecol.clear();
+			// check condition
+			for (const auto& usecol: usecols) {
+				// find last matched_usecol.
+				// matched_usecol can be overwriten.
+				switch (usecol._selection_type) {
+					case usecols::selection_type::selection_type_all:
+						if (true) matched_usecol = usecol;
+						break;
+					case usecols::selection_type::selection_type_first_n:
+						if (i<usecol._first_n) matched_usecol = usecol;
+						break;
+					case usecols::selection_type::selection_type_last_n:
+						if (i>=column_names.size()-usecol._last_n) matched_usecol = usecol;
+						break;
+					case usecols::selection_type::selection_type_indexes:
+						if (usecol._indexes.end() != std::find(usecol._indexes.begin(), usecol._indexes.end(), i)) matched_usecol = usecol;
+						break;
+					case usecols::selection_type::selection_type_names:
+						if (usecol._names.end() != std::find(usecol._names.begin(), usecol._names.end(), column_names[i])) matched_usecol = usecol;
+						break;
+					case usecols::selection_type::selection_type_regexes:
+						for (const auto& regex: usecol._regexes) {
+							std::regex pattern(regex);
+							if (std::regex_search(column_names[i], pattern)) {
+								matched_usecol = usecol;
+								break;
+							}
+						}
+						break;
+					default:
+						THROW_GAENARI_INTERNAL_ERROR0;
+				}
+			}
+
+			if (matched_usecol._data_type != data_type_t::data_type_unknown) {
+				// column has been matched.
+				column_info.clear();
+				column_info.name = column_names[i];
+				column_info.data_type = matched_usecol._data_type;
+				column_info.repository_index = i;
+				columns.push_back(column_info);
+			}
+		}
+	}
+
+	// convert a repository row to the values of columns.
+	// col is zero-filled, and the string is added to strings.
+	static inline void convert_row(_in const std::vector<repository_base::callback_column_type>& row_data, _in const std::vector<column_info>& columns, _in _out common::string_table& strings, _out type::value_raw* col) {
+		for (size_t j=0; j<columns.size(); j++) {
+			const auto& column_info = columns[j];
+			const auto& column_data = row_data[column_info.repository_index];
+			size_t column_data_type = column_data.index();	// monostate, int, int64_t, double, std::string&.
+			if (column_data_type == 0) THROW_GAENARI_INTERNAL_ERROR0;
+			else if (column_data_type == 1) {	// int
+				auto& int_value = std::get<1>(column_data);
+				switch (column_info.data_type) {
+					case data_type_t::data_type_int:
+					case data_type_t::data_type_string_table:
+						col[j].numeric_int32 = int_value;
+						break;
+					case data_type_t::data_type_int64:
+						col[j].numeric_int64 = static_cast<int64_t>(int_value);
+						break;
+					case data_type_t::data_type_double:
+						col[j].numeric_double = static_cast<double>(int_value);
+						break;
+					case data_type_t::data_type_string:
+						// the type of value from repository is int, but the column type is string.
+						// this is an error because the size of dataframe::strings can become very large.
+					default:
+						THROW_GAENARI_INTERNAL_ERROR0;
+						break;
+				}
+			} else if (column_data_type == 2) {	// int64_t
+				auto& int64_value = std::get<2>(column_data);
+				switch (column_info.data_type) {
+					case data_type_t::data_type_int:
+					case data_type_t::data_type_string_table:
+						col[j].numeric_int32 = static_cast<int>(int64_value);
+						break;
+					case data_type_t::data_type_int64:
+						col[j].numeric_int64 = int64_value;
+						break;
+					case data_type_t::data_type_double:
+						col[j].numeric_double = static_cast<double>(int64_value);
+						break;
+					case data_type_t::data_type_string:
+						// the type of value from repository is int64_t, but the column type is string.
+						// this is an error because the size of dataframe::strings can become very large.
+					default:
+						THROW_GAENARI_INTERNAL_ERROR0;
+						break;
+				}
+			} else if (column_data_type == 3) {	// double
+				auto& double_value = std::get<3>(column_data);
+				switch (column_info.data_type) {
+					case data_type_t::data_type_int:
+						col[j].numeric_int32 = static_cast<int>(double_value);
+						break;
+					case data_type_t::data_type_int64:
+						col[j].numeric_int64 = static_cast<int64_t>(double_value);
+						break;
+					case data_type_t::data_type_double:
+						col[j].numeric_double = double_value;
+						break;
+					case data_type_t::data_type_string_table:
+						// the type of value from repository is int(string table id), but the column type is double.
+						// it is assumed that real type fields cannot represent string table id.
+					case data_type_t::data_type_string:
+						// the type of value from repository is double, but the column type is string table id(int).
+						// this is an error because the size of dataframe::strings can become very large.
+					default:
+						THROW_GAENARI_INTERNAL_ERROR0;
+						break;
+				}
+			} else if (column_data_type == 4) {	// std::string& (std::reference_wrapper<const std::string>)
+				auto& string_value = std::get<4>(column_data).get();
+				switch (column_info.data_type) {
+					case data_type_t::data_type_int:
+						col[j].numeric_int32 = std::stoi(string_value);
+						break;
+					case data_type_t::data_type_int64:
+						col[j].numeric_int64 = std::stoll(string_value);
+						break;
+					case data_type_t::data_type_double:
+						col[j].numeric_double = std::stod(string_value);
+						break;
+					case data_type_t::data_type_string:
+						col[j].index = strings.add(string_value);
+						break;
+					case data_type_t::data_type_string_table:
+						// the type of value from repository is string, but the column type is string table id(int).
+						// this is an error because the size of dataframe::strings can become very large.
+					default:
+						THROW_GAENARI_INTERNAL_ERROR0;
+				}
+			} else {
+				THROW_GAENARI_INTERNAL_ERROR0;
+			}
+		}
+	}
+
+	// map the spill file to shared data.
+	static inline void attach_spill(_in _out shared_data& shared_data, _in const std::string& path, _in bool remove_on_clear, _in bool load_strings) {
+		auto mapped = std::make_unique<common::mapped_file>();
+		mapped->open(path, remove_on_clear);
+		auto content = parse_spill(mapped->data(), mapped->size(), load_strings ? &shared_data.strings : nullptr);
+		shared_data.columns = std::move(content.columns);
+		shared_data.rows = content.rows;
+		shared_data.cols = shared_data.columns.size();
+		shared_data.data_item_count = shared_data.rows * shared_data.cols;
+		// the mapping is read-only, dataframe does not write to data.
+		shared_data.data = const_cast<type::value_raw*>(content.data);
+		shared_data.mapped = mapped.release();
+	}
+
 	// misc private methods.
 protected:
 	inline void deep_copy(_in const dataframe& src, _option_in const std::vector<size_t>& selected_row_indexes) {
@@ -1228,6 +1390,9 @@ protected:
 
 		// initialize shared count
 		new_shared_data.shared_count = 0;
+
+		// the copied data is in memory.
+		new_shared_data.mapped = nullptr;
 	}
 };
 
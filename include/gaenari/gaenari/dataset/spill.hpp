@@ -0,0 +1,267 @@
+#ifndef HEADER_GAENARI_GAENARI_DATASET_SPILL_HPP
+#define HEADER_GAENARI_GAENARI_DATASET_SPILL_HPP
+
+namespace gaenari {
+namespace dataset {
+
+// spill file of dataframe.
+//
+// the data array of dataframe(rows * cols of type::value_raw, row-major) is written to a file as it is,
+// and the file is memory mapped to be a read-only dataframe. (see dataframe::open_spill(...))
+// a dataframe larger than the physical memory can be trained, the os pages in the rows on access.
+//
+//   offset          | content
+//   ----------------+----------------------------------------------------------------------
+//   0               | header. magic(8), version(4), reserved(4), rows(8), cols(8), data offset(8), strings offset(8)
+//   48              | columns. data type(4), repository index(8), name length(4), name(...)
+//   data offset     | data. rows * cols * type::value_raw. (64-byte aligned)
+//   strings offset  | string table. count(8), {id(8), length(4), string(...)} * count
+//   ----------------+----------------------------------------------------------------------
+//
+// the values are in the native byte order, it's a temporary file of the same machine.
+//
+// spill_writer w;
+// w.open("/temp/df.spill", columns);
+// auto* row = w.add_row(); row[0].numeric_double = 1.0; ...
+// w.close(strings);
+// dataframe df;
+// df.open_spill("/temp/df.spill");
+class spill_writer {
+public:
+	spill_writer()  = default;
+	~spill_writer() {discard();}
+	spill_writer(const spill_writer&) = delete;
+	spill_writer& operator=(const spill_writer&) = delete;
+
+	static constexpr char     magic[8] = {'G','N','R','S','P','I','L','L'};
+	static constexpr uint32_t version = 1;
+	static constexpr size_t   header_size = 48;
+	static constexpr size_t   data_alignment = 64;
+
+public:
+	// create the spill file.
+	// rows are buffered up to buffer_bytes, and written sequentially.
+	void open(_in const std::string& path, _in const std::vector<column_info>& columns, _in size_t buffer_bytes = static_cast<size_t>(4) << 20);
+
+	// add a row, and return its zero-filled values(cols items) to be set.
+	// the pointer is valid until the next call.
+	type::value_raw* add_row(void);
+
+	// add rows of the row-major array.
+	void append(_in const type::value_raw* data, _in size_t rows);
+
+	// write the string table and the header, and close the file.
+	void close(_in const common::string_table& strings);
+
+	// close and remove the file without completing it.
+	void discard(void);
+
+	inline size_t rows(void) const {return row_count;}
+	inline bool   is_open(void) const {return file.is_open();}
+
+protected:
+	void flush(void);
+	template <typename T> void write(_in const T& v) {file.write(reinterpret_cast<const char*>(&v), sizeof(T));}
+
+protected:
+	std::ofstream file;
+	std::string path;
+	size_t cols = 0;
+	size_t row_count = 0;
+	size_t data_offset = 0;
+	size_t buffer_rows = 0;
+	std::vector<type::value_raw> buffer;
+	size_t buffered = 0;
+};
+
+// the content of a memory mapped spill file.
+struct spill_content {
+	size_t rows = 0;
+	std::vector<column_info> columns;
+	const type::value_raw* data = nullptr;	// points the mapped memory.
+};
+
+// parse the memory mapped spill file. the strings are added to strings. (skipped if nullptr)
+inline spill_content parse_spill(_in const void* p, _in size_t size, _option_in common::string_table* strings);
+
+// implementation.
+
+inline void spill_writer::open(_in const std::string& path, _in const std::vector<column_info>& columns, _in size_t buffer_bytes) {
+	discard();
+	if (columns.empty()) THROW_GAENARI_ERROR("empty spill columns.");
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (not file.is_open()) THROW_GAENARI_ERROR("fail to create spill file: " + path);
+	this->path = path;
+	cols = columns.size();
+	row_count = 0;
+
+	// header. rows and strings offset are written at close.
+	file.write(magic, sizeof(magic));
+	write<uint32_t>(version);
+	write<uint32_t>(0);
+	write<uint64_t>(0);
+	write<uint64_t>(static_cast<uint64_t>(cols));
+	write<uint64_t>(0);
+	write<uint64_t>(0);
+
+	// columns.
+	for (const auto& column: columns) {
+		write<uint32_t>(static_cast<uint32_t>(column.data_type));
+		write<uint64_t>(static_cast<uint64_t>(column.repository_index));
+		write<uint32_t>(static_cast<uint32_t>(column.name.size()));
+		file.write(column.name.data(), column.name.size());
+	}
+
+	// padding for aligned data.
+	auto pos = static_cast<size_t>(file.tellp());
+	data_offset = (pos + data_alignment - 1) / data_alignment * data_alignment;
+	for (; pos<data_offset; pos++) file.put('\0');
+
+	// row buffer.
+	buffer_rows = std::max<size_t>(1, buffer_bytes / (sizeof(type::value_raw) * cols));
+	buffer.assign(buffer_rows * cols, type::value_raw{});
+	buffered = 0;
+	if (not file) THROW_GAENARI_ERROR("fail to write spill file: " + path);
+}
+
+inline type::value_raw* spill_writer::add_row(void) {
+	if (not file.is_open()) THROW_GAENARI_ERROR("spill file is not opened.");
+	if (buffered == buffer_rows) flush();
+	auto* row = &buffer[buffered * cols];
+	for (size_t i=0; i<cols; i++) row[i].index = 0;
+	buffered++;
+	row_count++;
+	return row;
+}
+
+inline void spill_writer::append(_in const type::value_raw* data, _in size_t rows) {
+	if (not file.is_open()) THROW_GAENARI_ERROR("spill file is not opened.");
+	flush();
+	file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(sizeof(type::value_raw) * cols * rows));
+	row_count += rows;
+	if (not file) THROW_GAENARI_ERROR("fail to write spill file: " + path);
+}
+
+inline void spill_writer::flush(void) {
+	if (buffered == 0) return;
+	file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(sizeof(type::value_raw) * cols * buffered));
+	buffered = 0;
+	if (not file) THROW_GAENARI_ERROR("fail to write spill file: " + path);
+}
+
+inline void spill_writer::close(_in const common::string_table& strings) {
+	if (not file.is_open()) THROW_GAENARI_ERROR("spill file is not opened.");
+	flush();
+
+	// string table.
+	const auto strings_offset = static_cast<uint64_t>(file.tellp());
+	// ids may have holes(nullptr). get_string_noexept(...) returns an empty string for them.
+	const int last_id = strings.get_last_id();
+	auto exists = [&](_in int id) {return (not strings.get_string_noexept(id).empty()) or (strings.get_id(std::string{}) == id);};
+	uint64_t count = 0;
+	for (int id=0; id<=last_id; id++) if (exists(id)) count++;
+	write<uint64_t>(count);
+	for (int id=0; id<=last_id; id++) {
+		if (not exists(id)) continue;
+		const auto& s = strings.get_string_noexept(id);
+		write<int64_t>(static_cast<int64_t>(id));
+		write<uint32_t>(static_cast<uint32_t>(s.size()));
+		file.write(s.data(), s.size());
+	}
+
+	// complete the header.
+	file.seekp(16);
+	write<uint64_t>(static_cast<uint64_t>(row_count));
+	file.seekp(32);
+	write<uint64_t>(static_cast<uint64_t>(data_offset));
+	write<uint64_t>(strings_offset);
+	file.close();
+	if (file.fail()) THROW_GAENARI_ERROR("fail to write spill file: " + path);
+	buffer.clear();
+	buffer.shrink_to_fit();
+	path.clear();
+}
+
+inline void spill_writer::discard(void) {
+	if (not file.is_open()) return;
+	file.close();
+	::remove(path.c_str());
+	buffer.clear();
+	buffer.shrink_to_fit();
+	path.clear();
+}
+
+inline spill_content parse_spill(_in const void* p, _in size_t size, _option_in common::string_table* strings) {
+	spill_content ret;
+	const auto* base = static_cast<const char*>(p);
+	size_t pos = 0;
+	auto read = [&](auto& v) {
+		if ((not base) or (pos + sizeof(v) > size)) THROW_GAENARI_ERROR("invalid spill file.");
+		memcpy(&v, base + pos, sizeof(v));
+		pos += sizeof(v);
+	};
+	auto read_string = [&](_in uint32_t length) {
+		if (pos + length > size) THROW_GAENARI_ERROR("invalid spill file.");
+		std::string s(base + pos, length);
+		pos += length;
+		return s;
+	};
+
+	// header.
+	char magic[8] = {0,};
+	uint32_t version = 0, reserved = 0;
+	uint64_t rows = 0, cols = 0, data_offset = 0, strings_offset = 0;
+	read(magic);
+	if (memcmp(magic, spill_writer::magic, sizeof(magic)) != 0) THROW_GAENARI_ERROR("invalid spill file.");
+	read(version);
+	if (version != spill_writer::version) THROW_GAENARI_ERROR("not supported spill file version: " + std::to_string(version));
+	read(reserved);
+	read(rows);
+	read(cols);
+	read(data_offset);
+	read(strings_offset);
+	if ((cols == 0) or (data_offset % spill_writer::data_alignment != 0)) THROW_GAENARI_ERROR("invalid spill file.");
+	if ((data_offset > strings_offset) or (strings_offset > size)) THROW_GAENARI_ERROR("invalid spill file.");
+
+	// the data is rows * cols values exactly. (checked by division first, not to overflow)
+	const uint64_t data_bytes = strings_offset - data_offset;
+	if ((data_bytes % (sizeof(type::value_raw) * cols) != 0) or (data_bytes / (sizeof(type::value_raw) * cols) != rows)) THROW_GAENARI_ERROR("invalid spill file.");
+
+	// columns.
+	for (uint64_t i=0; i<cols; i++) {
+		column_info column;
+		uint32_t data_type = 0, length = 0;
+		uint64_t repository_index = 0;
+		read(data_type);
+		read(repository_index);
+		read(length);
+		column.name = read_string(length);
+		column.data_type = static_cast<data_type_t>(data_type);
+		column.repository_index = static_cast<size_t>(repository_index);
+		ret.columns.push_back(std::move(column));
+	}
+
+	// the columns must end before the data.
+	if (pos > data_offset) THROW_GAENARI_ERROR("invalid spill file.");
+
+	// strings.
+	pos = static_cast<size_t>(strings_offset);
+	uint64_t count = 0;
+	read(count);
+	for (uint64_t i=0; strings and (i<count); i++) {
+		int64_t id = 0;
+		uint32_t length = 0;
+		read(id);
+		read(length);
+		strings->add(read_string(length), static_cast<int>(id));
+	}
+
+	ret.rows = static_cast<size_t>(rows);
+	ret.data = reinterpret_cast<const type::value_raw*>(base + data_offset);
+	return ret;
+}
+
+} // namespace dataset
+} // namespace gaenari
+
+#endif // HEADER_GAENARI_GAENARI_DATASET_SPILL_HPP
@@ -19,6 +19,7 @@
 // linux version.
 #include <unistd.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #endif // _WIN32
 
 // std c++17 library.
@@ -48,6 +49,14 @@
 #include <regex>
 #include <stack>
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <exception>
+#include <chrono>
+#include <cmath>
 
 // most basic header.
 #include "gaenari/gaenari/type/define.h"
@@ -61,6 +70,7 @@
 
 // high priority.
 #include "gaenari/gaenari/dataset/dataframe.type.hpp"
+#include "gaenari/gaenari/common/small_vector.hpp"
 #include "gaenari/gaenari/method/decision_tree/decision_tree.type.hpp"
 #include "gaenari/gaenari/method/stringfy/stringfy.type.hpp"
 #include "gaenari/gaenari/common/misc.hpp"
@@ -74,6 +84,10 @@
 #include "gaenari/gaenari/common/variant.hpp"
 #include "gaenari/gaenari/common/property.hpp"
 #include "gaenari/gaenari/common/cache.hpp"
+#include "gaenari/gaenari/common/thread_pool.hpp"
+#include "gaenari/gaenari/common/mapped_file.hpp"
+#include "gaenari/gaenari/common/mapped_strings.hpp"
+#include "gaenari/gaenari/common/binary_file.hpp"
 
 // common library.
 #include "gaenari/gaenari/common/time.hpp"
@@ -81,10 +95,20 @@
 // utility.
 #include "gaenari/gaenari/dataset/csv.hpp"
 #include "gaenari/gaenari/dataset/repository.hpp"
+#include "gaenari/gaenari/dataset/spill.hpp"
 #include "gaenari/gaenari/dataset/dataframe.hpp"
 #include "gaenari/gaenari/dataset/dataset.hpp"
+#include "gaenari/gaenari/method/decision_tree/decision_tree.control.hpp"
+#include "gaenari/gaenari/method/decision_tree/decision_tree.kernel.hpp"
 #include "gaenari/gaenari/method/decision_tree/decision_tree.util.hpp"
+#include "gaenari/gaenari/method/decision_tree/decision_tree.label.hpp"
+#include "gaenari/gaenari/method/decision_tree/decision_tree.histogram.hpp"
 #include "gaenari/gaenari/method/decision_tree/decision_tree.engine.hpp"
+#include "gaenari/gaenari/method/decision_tree/decision_tree.level.hpp"
+#include "gaenari/gaenari/method/decision_tree/decision_tree.compiled.hpp"
+#include "gaenari/gaenari/method/decision_tree/decision_tree.codegen.hpp"
+#include "gaenari/gaenari/method/decision_tree/decision_tree.binary.hpp"
+#include "gaenari/gaenari/method/decision_tree/decision_tree.confusion.hpp"
 #include "gaenari/gaenari/method/stringfy/stringfy.style.hpp"
 #include "gaenari/gaenari/method/stringfy/stringfy.util.hpp"
 #include "gaenari/gaenari/method/stringfy/stringfy.dataframe.hpp"
@@ -0,0 +1,236 @@
+#ifndef HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_BINARY_HPP
+#define HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_BINARY_HPP
+
+namespace gaenari {
+namespace method {
+namespace decision_tree {
+
+// binary tree file, and the memory mapped tree to predict.
+//
+// the nodes of compiled_tree(32 bytes plain old data) are written to a file as they are,
+// with the features, the label name and the string table the nodes refer to.
+// mapped_tree maps the file, and predicts on the mapped nodes directly without building tree_node objects.
+// loading does not read the nodes, the os pages them in on access,
+// and the processes that map the same file share the page cache.
+//
+//   offset          | content
+//   ----------------+----------------------------------------------------------------------
+//   0               | header. (file_header, 72 bytes)
+//   72              | columns. {data type(4), name length(4), name(...)} * column count, y name length(4), y name(...)
+//   nodes offset    | nodes. node count * compiled_tree::node. (64-byte aligned)
+//   strings offset  | string table. (see common::mapped_strings)
+//   ----------------+----------------------------------------------------------------------
+//
+// the values are in the native byte order and the node layout of the compiler,
+// so the file is for the machines of the same platform.
+//
+// decision_tree dt;
+// dt.train(...);
+// dt.write_binary("/temp/tree.bin");
+// mapped_tree t;
+// t.open("/temp/tree.bin");
+// auto label = t.predict(test);       // (feature name, value) map.
+// auto name  = t.get_string(label);
+class mapped_tree {
+public:
+	mapped_tree()  = default;
+	~mapped_tree() {close();}
+	mapped_tree(const mapped_tree&) = delete;
+	mapped_tree& operator=(const mapped_tree&) = delete;
+
+	static constexpr char     magic[8] = {'G','N','R','T','R','E','E','\0'};
+	static constexpr uint32_t version = 1;
+	static constexpr uint32_t byte_order = 0x01020304;
+	static constexpr size_t   node_alignment = 64;
+
+	struct file_header {
+		char     magic[8];
+		uint32_t version;
+		uint32_t byte_order;		// detects the file of a different byte order.
+		uint32_t node_size;			// sizeof(compiled_tree::node)
+		uint32_t column_count;
+		uint64_t node_count;
+		uint64_t string_count;
+		uint64_t columns_offset;
+		uint64_t nodes_offset;
+		uint64_t strings_offset;
+		uint64_t file_size;
+	};
+
+public:
+	// write the compiled tree and its meta data to a binary tree file.
+	// only the strings the tree refers to are required, but all strings are written to keep the string indexes.
+	static void write(_in const std::string& path, _in const compiled_tree& tree, _in const std::vector<dataset::column_info>& columns, _in const common::string_table& strings, _in const std::string& y_name);
+
+	// map the binary tree file.
+	// - verify : check the child ranges and the rule types of all nodes.
+	//            it reads all nodes once, set false for a trusted file to be loaded without reading the nodes.
+	void open(_in const std::string& path, _in bool verify = true);
+
+	// unmap.
+	void close(void);
+
+	inline bool is_open(void) const {return nodes != nullptr;}
+
+	// predict with pre-typed row. (see compiled_tree)
+	// returns predicted label index and the leaf tree node id.
+	// if the row does not match the tree, max size_t is returned, and id = -1.
+	size_t predict(_in const type::value_raw* row, _option_out int* id = nullptr) const;
+
+	// predict with one row (feature name, value) map data.
+	// the result is the same as decision_tree::predict(...).
+	size_t predict(_in const std::map<std::string,std::string>& test, _option_out int* id = nullptr) const;
+
+	// convert (feature name, value) map data to pre-typed row.
+	// exception(feature not found) is raised if a feature is missing.
+	void get_typed_row(_in const std::map<std::string,std::string>& test, _out std::vector<type::value_raw>& row) const;
+
+	// string of the string index. (ex: predicted label index)
+	// exception if not existed.
+	std::string get_string(_in size_t index) const;
+
+	// string index of the string. max size_t if not existed.
+	size_t get_string_index(_in const std::string& s) const;
+
+	inline const std::vector<dataset::column_info>& get_columns(void) const {return columns;}
+	inline const std::string& get_y_name(void) const {return y_name;}
+	inline size_t node_count(void) const {return nodes_size;}
+
+protected:
+	common::mapped_file file;
+	const compiled_tree::node* nodes = nullptr;		// points the mapped memory.
+	size_t nodes_size = 0;
+	common::mapped_strings strings;
+	std::vector<dataset::column_info> columns;
+	std::string y_name;
+};
+
+static_assert(sizeof(mapped_tree::file_header) == 72, "invalid mapped_tree::file_header size.");
+
+// implementation.
+
+inline void mapped_tree::write(_in const std::string& path, _in const compiled_tree& tree, _in const std::vector<dataset::column_info>& columns, _in const common::string_table& strings, _in const std::string& y_name) {
+	common::binary_file_writer file;
+	file_header header;
+	memset(&header, 0, sizeof(header));
+
+	if (tree.empty()) THROW_GAENARI_ERROR("tree is not compiled.");
+	if (not file.open(path, sizeof(header))) THROW_GAENARI_ERROR("fail to create tree file: " + path);
+
+	// columns.
+	header.columns_offset = static_cast<uint64_t>(file.tell());
+	for (const auto& column: columns) {
+		file.write_value(static_cast<uint32_t>(column.data_type));
+		file.write_string(column.name);
+	}
+	file.write_string(y_name);
+
+	// nodes.
+	header.nodes_offset = static_cast<uint64_t>(file.padding(node_alignment));
+	file.write_bytes(tree.nodes.data(), sizeof(compiled_tree::node) * tree.nodes.size());
+
+	// strings.
+	header.string_count = static_cast<uint64_t>(file.write_strings(strings, header.strings_offset));
+
+	// complete the header.
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version      = version;
+	header.byte_order   = byte_order;
+	header.node_size    = static_cast<uint32_t>(sizeof(compiled_tree::node));
+	header.column_count = static_cast<uint32_t>(columns.size());
+	header.node_count   = static_cast<uint64_t>(tree.nodes.size());
+	if (not file.close(header)) THROW_GAENARI_ERROR("fail to write tree file: " + path);
+}
+
+inline void mapped_tree::open(_in const std::string& path, _in bool verify) {
+	close();
+	file.open(path);
+
+	const auto* base = static_cast<const char*>(file.data());
+	const size_t size = file.size();
+	common::binary_file_reader reader(base, size);
+	auto invalid = [&](void) {close(); THROW_GAENARI_ERROR("invalid tree file: " + path);};
+
+	// header.
+	file_header header;
+	switch (reader.read_header(magic, version, byte_order, header)) {
+	case common::binary_file_status::ok:
+		break;
+	case common::binary_file_status::not_supported_version:
+		close(); THROW_GAENARI_ERROR("not supported tree file version: " + std::to_string(header.version));
+	case common::binary_file_status::different_byte_order:
+		close(); THROW_GAENARI_ERROR("tree file of a different platform: " + path);
+	default:
+		invalid();
+	}
+	if (header.node_size != sizeof(compiled_tree::node)) {close(); THROW_GAENARI_ERROR("tree file of a different platform: " + path);}
+	if ((header.node_count == 0) or (header.nodes_offset % node_alignment != 0)) invalid();
+	if ((header.columns_offset > header.nodes_offset) or (header.nodes_offset > header.strings_offset) or (header.strings_offset > size)) invalid();
+	if ((header.strings_offset - header.nodes_offset) / sizeof(compiled_tree::node) < header.node_count) invalid();
+
+	// columns.
+	reader.seek(header.columns_offset, header.nodes_offset);
+	for (uint32_t i=0; i<header.column_count; i++) {
+		dataset::column_info column;
+		uint32_t data_type = 0;
+		if ((not reader.read_value(data_type)) or (not reader.read_string(column.name))) invalid();
+		column.data_type = static_cast<dataset::data_type_t>(data_type);
+		columns.push_back(std::move(column));
+	}
+	if (not reader.read_string(y_name)) invalid();
+
+	// strings.
+	if (not reader.attach_strings(strings, header.strings_offset, header.string_count)) invalid();
+
+	// nodes.
+	nodes = reinterpret_cast<const compiled_tree::node*>(base + header.nodes_offset);
+	nodes_size = static_cast<size_t>(header.node_count);
+	if (verify) {
+		for (size_t i=0; i<nodes_size; i++) {
+			const auto& n = nodes[i];
+			if ((n.value_type >= std::size(kernel::match_table)) or (n.op >= std::size(kernel::match_table[0]))) invalid();
+			if ((i > 0) and (n.feature_index >= columns.size())) invalid();
+			if (n.child_count == 0) continue;
+			if ((n.child_begin <= i) or (n.child_begin + static_cast<size_t>(n.child_count) > nodes_size)) invalid();
+		}
+	}
+}
+
+inline void mapped_tree::close(void) {
+	file.close();
+	nodes = nullptr;
+	nodes_size = 0;
+	strings.detach();
+	columns.clear();
+	y_name.clear();
+}
+
+inline size_t mapped_tree::predict(_in const type::value_raw* row, _option_out int* id) const {
+	if (not nodes) THROW_GAENARI_ERROR("tree file is not opened.");
+	return compiled_tree::predict_nodes(nodes, row, id);
+}
+
+inline size_t mapped_tree::predict(_in const std::map<std::string,std::string>& test, _option_out int* id) const {
+	std::vector<type::value_raw> row;
+	get_typed_row(test, row);
+	return predict(row.data(), id);
+}
+
+inline void mapped_tree::get_typed_row(_in const std::map<std::string,std::string>& test, _out std::vector<type::value_raw>& row) const {
+	if (not nodes) THROW_GAENARI_ERROR("tree file is not opened.");
+	util::get_typed_row(test, columns, [this](_in const std::string& s) {return get_string_index(s);}, row);
+}
+
+inline std::string mapped_tree::get_string(_in size_t index) const {
+	return strings.get_string(index);
+}
+
+inline size_t mapped_tree::get_string_index(_in const std::string& s) const {
+	return strings.get_id(s);
+}
+
+} // decision_tree
+} // method
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_BINARY_HPP
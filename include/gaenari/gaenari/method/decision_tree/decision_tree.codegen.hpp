@@ -0,0 +1,371 @@
+#ifndef HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_CODEGEN_HPP
+#define HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_CODEGEN_HPP
+
+namespace gaenari {
+namespace method {
+namespace decision_tree {
+namespace codegen {
+
+// c++ code generation of a trained tree.
+//
+// the tree is generated to a standalone c++ header of nested if/switch code.
+// it has no dependency(only the standard c++ headers), and can be compiled into other programs.
+// there is no tree traversal at predict, the rules are the branches of the code.
+//
+//   namespace <name_space> {
+//   struct input {                      // all features of the tree in the feature order.
+//       double salary = 0.0;            // data_type_double
+//       size_t car    = unknown;        // data_type_string(_table), string id.
+//       ...
+//   };
+//   size_t string_id(const char* s);    // string -> id. (nominal value of input)
+//   const char* get_string(size_t id);  // id -> string. (predicted label)
+//   size_t predict(const input& x, int* id = nullptr) {
+//       if (x.salary <= 50000.5) {
+//           switch (x.car) {
+//           case 3: // "c16"
+//               if (id) *id = 7;
+//               return 12; // "A"
+//           ...
+//           default: // <other>
+//               ...
+//
+// the result is the same as compiled_tree::predict(...).
+// - the string ids are of the decision_tree string table. only the strings used in the tree are generated.
+//   other strings are `unknown`. like the unknown strings of compiled_tree, they do not match any `case`,
+//   and go to the cmp_other child(grouped rare values), which is the `default` of the switch.
+//   if there is no cmp_other child, the `default` returns `unknown`.
+// - if the input does not match the tree, `unknown` is returned, and id = -1.
+// - the nesting depth of the code is the depth of the tree.
+//   a very deep tree may exceed the bracket depth limit of the compiler. (ex: clang -fbracket-depth)
+
+// field names of the input struct.
+// column names are converted to c++ identifiers, and duplicated ones have a suffix.
+inline std::vector<std::string> get_field_names(_in const std::vector<dataset::column_info>& columns);
+
+// generate the c++ header of the tree.
+// - name_space : namespace of the generated code. it must be a c++ identifier.
+inline std::string cpp(_in const tree_node& root, _in const std::vector<dataset::column_info>& columns, _in const common::string_table& strings, _in const std::string& name_space);
+
+// implementation.
+
+namespace detail {
+
+inline bool is_identifier(_in const std::string& s) {
+	if (s.empty()) return false;
+	if (std::isdigit(static_cast<unsigned char>(s[0]))) return false;
+	for (const auto c: s) if (not (std::isalnum(static_cast<unsigned char>(c)) or (c == '_'))) return false;
+	return true;
+}
+
+inline bool is_keyword(_in const std::string& s) {
+	static const std::set<std::string> keywords = {
+		"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch", "char",
+		"char16_t", "char32_t", "class", "compl", "const", "constexpr", "const_cast", "continue", "decltype", "default",
+		"delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+		"friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+		"nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "return",
+		"short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this",
+		"thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual",
+		"void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+	};
+	return keywords.find(s) != keywords.end();
+}
+
+// c++ string literal.
+inline std::string to_literal(_in const std::string& s) {
+	std::string ret = "\"";
+	for (const auto c: s) {
+		const auto u = static_cast<unsigned char>(c);
+		if      (c == '"')  ret += "\\\"";
+		else if (c == '\\') ret += "\\\\";
+		else if (c == '\n') ret += "\\n";
+		else if (c == '\r') ret += "\\r";
+		else if (c == '\t') ret += "\\t";
+		else if ((u < 0x20) or (u >= 0x7f)) {
+			// octal escape is at most 3 digits, so the next character is not merged.
+			char buf[8];
+			snprintf(buf, sizeof(buf), "\\%03o", u);
+			ret += buf;
+		} else ret += c;
+	}
+	ret += '"';
+	return ret;
+}
+
+// c++ literal of the rule argument.
+inline std::string to_literal(_in const type::value& v) {
+	switch (v.valueype) {
+		case type::value_type::value_type_int:
+			return std::to_string(v.numeric_int32);
+		case type::value_type::value_type_int64:
+			if (v.numeric_int64 == std::numeric_limits<int64_t>::min()) return "std::numeric_limits<int64_t>::min()";
+			return "INT64_C(" + std::to_string(v.numeric_int64) + ')';
+		case type::value_type::value_type_size_t:
+			return std::to_string(v.index);
+		case type::value_type::value_type_double: {
+			const double d = v.numeric_double;
+			if (std::isnan(d)) return "std::numeric_limits<double>::quiet_NaN()";
+			if (std::isinf(d)) return d > 0 ? "std::numeric_limits<double>::infinity()" : "-std::numeric_limits<double>::infinity()";
+			// 17 significant digits for the same double.
+			char buf[64];
+			snprintf(buf, sizeof(buf), "%.17g", d);
+			std::string s = buf;
+			if (s.find_first_of(".en") == std::string::npos) s += ".0";
+			return s;
+		}
+		default:
+			break;
+	}
+	THROW_GAENARI_ERROR("invalid value type.");
+}
+
+inline std::string get_field_type(_in dataset::data_type_t data_type) {
+	switch (data_type) {
+		case dataset::data_type_t::data_type_int:			return "int32_t";
+		case dataset::data_type_t::data_type_int64:			return "int64_t";
+		case dataset::data_type_t::data_type_double:		return "double";
+		case dataset::data_type_t::data_type_string:
+		case dataset::data_type_t::data_type_string_table:	return "size_t";
+		default: break;
+	}
+	THROW_GAENARI_ERROR("invalid data type.");
+}
+
+inline std::string get_op(_in rule_t::rule_type type) {
+	switch (type) {
+		case rule_t::rule_type::cmp_equ: return "==";
+		case rule_t::rule_type::cmp_lte: return "<=";
+		case rule_t::rule_type::cmp_lt:  return "<";
+		case rule_t::rule_type::cmp_gt:  return ">";
+		case rule_t::rule_type::cmp_gte: return ">=";
+		default: break;
+	}
+	THROW_GAENARI_ERROR("not supported rule type.");
+}
+
+// the childs are switched by a nominal feature.
+inline bool is_switch(_in const tree_node& node, _in const std::vector<dataset::column_info>& columns) {
+	const size_t feature_index = node.childs[0]->rule.feature_indexes[0];
+	if (not common::is_nominal(columns[feature_index].data_type)) return false;
+	for (const auto child: node.childs) {
+		const auto& rule = child->rule;
+		if (rule.feature_indexes[0] != feature_index) return false;
+		if ((rule.type != rule_t::rule_type::cmp_equ) and (rule.type != rule_t::rule_type::cmp_other)) return false;
+		if (rule.args[0].valueype != type::value_type::value_type_size_t) return false;
+	}
+	return true;
+}
+
+} // detail
+
+inline std::vector<std::string> get_field_names(_in const std::vector<dataset::column_info>& columns) {
+	std::vector<std::string> ret;
+	std::set<std::string> used;
+	for (const auto& column: columns) {
+		std::string name;
+		for (const auto c: column.name) name += (std::isalnum(static_cast<unsigned char>(c)) or (c == '_')) ? c : '_';
+		if (name.empty() or std::isdigit(static_cast<unsigned char>(name[0]))) name = '_' + name;
+		if (detail::is_keyword(name)) name += '_';
+		std::string unique = name;
+		for (size_t i=2; used.find(unique) != used.end(); i++) unique = name + '_' + std::to_string(i);
+		used.insert(unique);
+		ret.push_back(unique);
+	}
+	return ret;
+}
+
+inline std::string cpp(_in const tree_node& root, _in const std::vector<dataset::column_info>& columns, _in const common::string_table& strings, _in const std::string& name_space) {
+	std::string ret;
+	std::string guard;
+	std::map<std::string, size_t> used_strings;	// sorted by string for binary search.
+
+	if (not detail::is_identifier(name_space) or detail::is_keyword(name_space)) THROW_GAENARI_INVALID_PARAMETER("invalid name_space: " + name_space);
+	const auto field_names = get_field_names(columns);
+	auto use_string = [&](_in size_t id) -> const std::string& {
+		const auto& s = strings.get_string(id);
+		used_strings.insert({s, id});
+		return s;
+	};
+
+	// predict body.
+	// the tree is generated with an explicit stack. (do not use recursive function call)
+	// an item is a line of code, or a tree node to be expanded.
+	struct item {
+		const tree_node* node = nullptr;
+		size_t indent = 0;
+		std::string line;
+	};
+	std::string body;
+	std::vector<item> stack;
+	stack.push_back(item{&root, 1, {}});
+	while (not stack.empty()) {
+		auto current = std::move(stack.back());
+		stack.pop_back();
+		if (not current.node) {
+			body += std::string(current.indent, '\t') + current.line + '\n';
+			continue;
+		}
+
+		const auto& node = *current.node;
+		const auto indent = current.indent;
+		if (node.leaf) {
+			const auto& label = use_string(node.leaf_info.label_string_index);
+			body += std::string(indent, '\t') + "if (id) *id = " + std::to_string(node.id) + ";\n";
+			body += std::string(indent, '\t') + "return " + std::to_string(node.leaf_info.label_string_index) + "; // " + detail::to_literal(label) + '\n';
+			continue;
+		}
+		if (node.childs.empty()) {
+			// not leaf, but no child. nothing is matched.
+			body += std::string(indent, '\t') + "return unknown;\n";
+			continue;
+		}
+
+		// the items of this node in order. pushed to the stack in reverse.
+		std::vector<item> items;
+		for (const auto child: node.childs) {
+			const auto& rule = child->rule;
+			if ((rule.feature_indexes.size() != 1) or (rule.args.size() != 1)) THROW_GAENARI_ERROR("not supported rule.");
+		}
+		const auto& field = field_names[node.childs[0]->rule.feature_indexes[0]];
+		if (detail::is_switch(node, columns)) {
+			// switch by the string id.
+			bool other = false;
+			items.push_back(item{nullptr, indent, "switch (x." + field + ") {"});
+			for (const auto child: node.childs) {
+				if (child->rule.type == rule_t::rule_type::cmp_other) continue;
+				const auto index = child->rule.args[0].index;
+				items.push_back(item{nullptr, indent, "case " + std::to_string(index) + ": // " + detail::to_literal(use_string(index))});
+				items.push_back(item{child, indent + 1, {}});
+			}
+			for (const auto child: node.childs) {
+				if (child->rule.type != rule_t::rule_type::cmp_other) continue;
+				if (other) THROW_GAENARI_ERROR("not supported rule.");
+				other = true;
+				items.push_back(item{nullptr, indent, "default: // <other>"});
+				items.push_back(item{child, indent + 1, {}});
+			}
+			if (not other) {
+				items.push_back(item{nullptr, indent, "default:"});
+				items.push_back(item{nullptr, indent + 1, "return unknown;"});
+			}
+			items.push_back(item{nullptr, indent, "}"});
+		} else {
+			// the first matched child in order.
+			bool other = false;
+			for (size_t i=0; (i<node.childs.size()) and (not other); i++) {
+				const auto child = node.childs[i];
+				const auto& rule = child->rule;
+				const std::string prefix = (i == 0) ? "" : "} else ";
+				if (rule.type == rule_t::rule_type::cmp_other) {
+					// always matched. the next childs are not reached.
+					other = true;
+					items.push_back(item{nullptr, indent, (i == 0) ? "{ // <other>" : prefix + "{ // <other>"});
+				} else {
+					std::string comment;
+					if (rule.args[0].valueype == type::value_type::value_type_size_t) comment = " // " + detail::to_literal(use_string(rule.args[0].index));
+					items.push_back(item{nullptr, indent, prefix + "if (x." + field_names[rule.feature_indexes[0]] + ' ' + detail::get_op(rule.type) + ' ' + detail::to_literal(rule.args[0]) + ") {" + comment});
+				}
+				items.push_back(item{child, indent + 1, {}});
+			}
+			items.push_back(item{nullptr, indent, "}"});
+			if (not other) items.push_back(item{nullptr, indent, "return unknown;"});
+		}
+		for (auto it=items.rbegin(); it!=items.rend(); it++) stack.push_back(std::move(*it));
+	}
+
+	// header.
+	guard = "GAENARI_CODEGEN_";
+	for (const auto c: name_space) guard += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+	guard += "_HPP";
+	ret += "// generated by gaenari. do not edit.\n";
+	ret += "//\n";
+	ret += "// standalone predictor of a trained decision tree.\n";
+	ret += "//\n";
+	ret += "// " + name_space + "::input x;\n";
+	ret += "// x.<numeric feature> = 1.0;\n";
+	ret += "// x.<nominal feature> = " + name_space + "::string_id(\"...\");\n";
+	ret += "// int id = -1;\n";
+	ret += "// auto label = " + name_space + "::predict(x, &id);\n";
+	ret += "// auto name  = " + name_space + "::get_string(label);\n";
+	ret += "//\n";
+	ret += "// - nominal features are string ids, and unknown string is " + name_space + "::unknown.\n";
+	ret += "// - if the input does not match the tree, " + name_space + "::unknown is returned, and id = -1.\n";
+	ret += "#ifndef " + guard + '\n';
+	ret += "#define " + guard + '\n';
+	ret += '\n';
+	ret += "#include <cstddef>\n";
+	ret += "#include <cstdint>\n";
+	ret += "#include <cstring>\n";
+	ret += "#include <limits>\n";
+	ret += '\n';
+	ret += "namespace " + name_space + " {\n";
+	ret += '\n';
+	ret += "constexpr size_t unknown = std::numeric_limits<size_t>::max();\n";
+	ret += '\n';
+
+	// input.
+	ret += "// input features.\n";
+	ret += "struct input {\n";
+	for (size_t i=0; i<columns.size(); i++) {
+		const auto field_type = detail::get_field_type(columns[i].data_type);
+		std::string init = (field_type == "size_t") ? "unknown" : ((field_type == "double") ? "0.0" : "0");
+		ret += '\t' + field_type + ' ' + field_names[i] + " = " + init + ';';
+		if (field_names[i] != columns[i].name) ret += " // " + detail::to_literal(columns[i].name);
+		ret += '\n';
+	}
+	ret += "};\n";
+	ret += '\n';
+
+	// strings.
+	ret += "// string -> id. unknown if the string is not used in the tree.\n";
+	ret += "inline size_t string_id(const char* s) {\n";
+	if (not used_strings.empty()) {
+		ret += "\tstruct item {const char* s; size_t id;};\n";
+		ret += "\tstatic const item items[] = {\n";
+		for (const auto& it: used_strings) ret += "\t\t{" + detail::to_literal(it.first) + ", " + std::to_string(it.second) + "},\n";
+		ret += "\t};\n";
+		ret += "\tsize_t lo = 0, hi = sizeof(items) / sizeof(items[0]);\n";
+		ret += "\twhile (lo < hi) {\n";
+		ret += "\t\tsize_t mid = (lo + hi) / 2;\n";
+		ret += "\t\tint c = std::strcmp(items[mid].s, s);\n";
+		ret += "\t\tif (c == 0) return items[mid].id;\n";
+		ret += "\t\tif (c < 0) lo = mid + 1; else hi = mid;\n";
+		ret += "\t}\n";
+	} else {
+		ret += "\t(void)s;\n";
+	}
+	ret += "\treturn unknown;\n";
+	ret += "}\n";
+	ret += '\n';
+	ret += "// id -> string. nullptr if the string is not used in the tree.\n";
+	ret += "inline const char* get_string(size_t id) {\n";
+	ret += "\tswitch (id) {\n";
+	std::map<size_t, const std::string*> by_id;
+	for (const auto& it: used_strings) by_id[it.second] = &it.first;
+	for (const auto& it: by_id) ret += "\tcase " + std::to_string(it.first) + ": return " + detail::to_literal(*it.second) + ";\n";
+	ret += "\tdefault: return nullptr;\n";
+	ret += "\t}\n";
+	ret += "}\n";
+	ret += '\n';
+
+	// predict.
+	ret += "// returns the label string id, and the leaf tree node id.\n";
+	ret += "inline size_t predict(const input& x, int* id = nullptr) {\n";
+	ret += "\t(void)x;\n";
+	ret += "\tif (id) *id = -1;\n";
+	ret += body;
+	ret += "}\n";
+	ret += '\n';
+	ret += "} // " + name_space + '\n';
+	ret += '\n';
+	ret += "#endif // " + guard + '\n';
+	return ret;
+}
+
+} // codegen
+} // decision_tree
+} // method
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_CODEGEN_HPP
@@ -0,0 +1,188 @@
+#ifndef HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_COMPILED_HPP
+#define HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_COMPILED_HPP
+
+namespace gaenari {
+namespace method {
+namespace decision_tree {
+
+// flat tree for fast predict.
+//
+// tree_node is good for training, but slow for predict.
+// (pointer chasing, type check of rule_t args, feature name lookup and string parsing per node.)
+// compiled_tree copies the tree nodes to one contiguous array in breadth-first order.
+// the childs of a node are contiguous, so a node has only the index of the first child and the child count.
+// the childs of a nominal split with tree_node::nominal_index are sorted by string index,
+// and the matched child is found by binary search. (high-cardinality nominal feature)
+// the cmp_other child(grouped rare values) has max size_t, so it's the last child, and matched when nothing is found.
+//
+//   index : 0     1     2     3       4       5       6
+//          [root][c0   c1  ][c0.0    c0.1  ][c1.0    c1.1  ]
+//           |     ^    |                     ^
+//           |     |    '---------------------' child_begin=5, child_count=2
+//           '-----' child_begin=1, child_count=2
+//
+// the input row is pre-typed. row[feature index] is type::value_raw of the feature.
+// - data_type_int                         : numeric_int32
+// - data_type_int64                       : numeric_int64
+// - data_type_double                      : numeric_double
+// - data_type_string, data_type_string_table : string index of the decision_tree string table.
+//                                              unknown string is max size_t, it does not match any `==` child,
+//                                              so it goes to the cmp_other child if there is, or the row does not match.
+class compiled_tree {
+public:
+	compiled_tree()  = default;
+	~compiled_tree() = default;
+
+public:
+	// one tree node. (plain old data, 32 bytes)
+	struct node {
+		type::value_raw arg;		// rule argument. (threshold or nominal string index)
+		uint64_t label;				// leaf only. label string index.
+		int32_t  id;				// tree node id.
+		uint32_t feature_index;		// feature index of the rule.
+		uint32_t child_begin;		// index of the first child.
+		uint32_t child_count : 23;	// child count. 0 means leaf.
+		uint32_t nominal     : 1;	// childs are nominal split sorted by arg.index.
+		uint32_t op          : 4;	// rule_t::rule_type of the rule.
+		uint32_t value_type  : 4;	// type::value_type of arg.
+	};
+
+	// max child count of a node.
+	static constexpr size_t max_child_count = (1 << 23) - 1;
+
+public:
+	// compile from the root of trained tree.
+	void build(_in const tree_node& root);
+
+	// clear.
+	void clear(void);
+
+	// check empty.
+	bool empty(void) const;
+
+	// predict with pre-typed row.
+	// returns predicted label index and the leaf tree node id.
+	// if the row does not match the tree, max size_t is returned, and id = -1.
+	size_t predict(_in const type::value_raw* row, _option_out int* id = nullptr) const;
+
+	// predict on the node array whose nodes[0] is root.
+	// it's shared by this->nodes and the memory mapped nodes of a binary tree file. (see mapped_tree)
+	static size_t predict_nodes(_in const node* nodes, _in const type::value_raw* row, _option_out int* id = nullptr);
+
+public:
+	// nodes in breadth-first order. nodes[0] is root.
+	std::vector<node> nodes;
+};
+
+static_assert(sizeof(compiled_tree::node) == 32, "invalid compiled_tree::node size.");
+
+// implementation.
+
+inline void compiled_tree::build(_in const tree_node& root) {
+	std::vector<const tree_node*> sources;
+
+	// clear.
+	clear();
+
+	// breadth-first order.
+	// sources[i] is the tree node of nodes[i].
+	sources.push_back(&root);
+	nodes.emplace_back();
+	for (size_t i=0; i<sources.size(); i++) {
+		const auto& source = *sources[i];
+		if (sources.size() + source.childs.size() > std::numeric_limits<uint32_t>::max()) THROW_GAENARI_ERROR("too many tree nodes to compile.");
+		if (source.childs.size() > max_child_count) THROW_GAENARI_ERROR("too many child nodes to compile.");
+		auto& n = nodes[i];
+		n.arg.index     = 0;
+		n.label         = static_cast<uint64_t>(source.leaf_info.label_string_index);
+		n.id            = static_cast<int32_t>(source.id);
+		n.feature_index = 0;
+		n.child_begin   = static_cast<uint32_t>(sources.size());
+		n.child_count   = source.leaf ? 0 : static_cast<uint32_t>(source.childs.size());
+		n.nominal       = 0;
+		n.op            = static_cast<uint32_t>(source.rule.type);
+		n.value_type    = static_cast<uint32_t>(type::value_type::value_type_unknown);
+		if (i != 0) {
+			// root has no rule.
+			// get_match_fn(...) checks the rule is supported by match_table.
+			const auto& rule = source.rule;
+			kernel::get_match_fn(rule);
+			n.arg.index     = rule.args[0].index;
+			n.feature_index = static_cast<uint32_t>(rule.feature_indexes[0]);
+			n.value_type    = static_cast<uint32_t>(rule.args[0].valueype);
+		}
+		if (source.leaf) continue;
+		if (source.childs.empty()) {
+			// not leaf, but no child. nothing is matched.
+			n.label = std::numeric_limits<uint64_t>::max();
+			n.id    = -1;
+			continue;
+		}
+		// childs are contiguous.
+		// nominal_index is sorted by string index, so are the childs.
+		if (not source.nominal_index.empty()) {
+			if (source.nominal_index.size() != source.childs.size()) THROW_GAENARI_INTERNAL_ERROR0;
+			n.nominal = 1;
+			for (const auto& it: source.nominal_index) {
+				sources.push_back(it.second);
+				nodes.emplace_back();
+			}
+			continue;
+		}
+		for (const auto child: source.childs) {
+			sources.push_back(child);
+			nodes.emplace_back();
+		}
+	}
+}
+
+inline void compiled_tree::clear(void) {
+	nodes.clear();
+}
+
+inline bool compiled_tree::empty(void) const {
+	return nodes.empty();
+}
+
+inline size_t compiled_tree::predict(_in const type::value_raw* row, _option_out int* id) const {
+	if (id) *id = -1;
+	if (nodes.empty()) THROW_GAENARI_ERROR("tree is not compiled.");
+	return predict_nodes(nodes.data(), row, id);
+}
+
+inline size_t compiled_tree::predict_nodes(_in const node* nodes, _in const type::value_raw* row, _option_out int* id) {
+	if (id) *id = -1;
+
+	const node* base    = nodes;
+	const node* current = base;
+	while (current->child_count != 0) {
+		// which child is matched?
+		const node* child = base + current->child_begin;
+		const node* end   = child + current->child_count;
+		if (current->nominal) {
+			// binary search by string index.
+			const size_t index = row[child->feature_index].index;
+			const node* other = (end[-1].op == static_cast<uint32_t>(rule_t::rule_type::cmp_other)) ? end - 1 : end;
+			child = std::lower_bound(child, end, index, [](const node& n, size_t v) {return n.arg.index < v;});
+			if ((child == end) or (child->arg.index != index)) child = other;
+		} else {
+			for (; child != end; child++) {
+				// the kernel is selected by (value_type, op) without type check.
+				// cmp_other is the last child, and always matched.
+				if (kernel::match_table[child->value_type][child->op](row[child->feature_index], child->arg)) break;
+			}
+		}
+		// does not match childs of current node.
+		if (child == end) return std::numeric_limits<size_t>::max();
+		current = child;
+	}
+
+	if (id) *id = current->id;
+	return static_cast<size_t>(current->label);
+}
+
+} // decision_tree
+} // method
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_COMPILED_HPP
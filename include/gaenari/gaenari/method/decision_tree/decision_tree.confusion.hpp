@@ -0,0 +1,149 @@
+#ifndef HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_CONFUSION_HPP
+#define HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_CONFUSION_HPP
+
+namespace gaenari {
+namespace method {
+namespace decision_tree {
+
+// dense confusion matrix.
+//
+// labels are mapped to the dense index [0, K), and the count is a flat K x K array.
+// so, counting is just an array increment, and two matrices are merged by adding arrays.
+// the map format of decision_tree::eval(...) is made only with to_map(...).
+//
+//                    predicted
+//                    0   1  ..  K-1
+//              0  [  .   .   .   .  ]
+//   actual     1  [  .   .   .   .  ]     counts[actual * K + predicted]
+//              .. [  .   .   .   .  ]
+//              K-1[  .   .   .   .  ]
+//
+// labels:
+//   [0, base_count)   : label values of the tree and unknown(max size_t). always shown in the map.
+//   [base_count, K)   : actual labels only in the test data. shown only when counted.
+class confusion_matrix {
+public:
+	confusion_matrix()  = default;
+	~confusion_matrix() = default;
+
+public:
+	// set labels and zero counts.
+	// unknown(max size_t) is added to the end of label_values.
+	void init(_in const std::vector<size_t>& label_values);
+
+	// dense index of the label. max size_t if not found.
+	size_t index(_in size_t label) const;
+
+	// add a label only in the test data, and return its dense index.
+	// the counts are resized.
+	size_t add_label(_in size_t label);
+
+	// label count. (K)
+	size_t size(void) const;
+
+	// counts[actual * K + predicted] += count.
+	void add(_in size_t actual_index, _in size_t predicted_index, _in size_t count = 1);
+
+	// add all counts of the other matrix with the same labels.
+	void merge(_in const confusion_matrix& other);
+
+	// get count with label values.
+	size_t get(_in size_t actual, _in size_t predicted) const;
+
+	// to the map format of decision_tree::eval(...).
+	// the result is the same as eval(...) with the map.
+	void to_map(_out std::map<size_t,std::map<size_t,size_t>>& confusion) const;
+
+public:
+	std::vector<size_t> labels;	// dense index -> label string index.
+	std::vector<size_t> counts;	// K x K counts.
+	size_t base_count = 0;		// label values of the tree + unknown.
+};
+
+// implementation.
+
+inline void confusion_matrix::init(_in const std::vector<size_t>& label_values) {
+	labels = label_values;
+	labels.push_back(std::numeric_limits<size_t>::max());
+	base_count = labels.size();
+	counts.assign(base_count * base_count, 0);
+}
+
+inline size_t confusion_matrix::index(_in size_t label) const {
+	// label count is small, linear search.
+	for (size_t i=0; i<labels.size(); i++) if (labels[i] == label) return i;
+	return std::numeric_limits<size_t>::max();
+}
+
+inline size_t confusion_matrix::add_label(_in size_t label) {
+	auto i = index(label);
+	if (i != std::numeric_limits<size_t>::max()) return i;
+
+	// resize K x K to (K+1) x (K+1).
+	const size_t k = labels.size();
+	std::vector<size_t> resized((k + 1) * (k + 1), 0);
+	for (size_t a=0; a<k; a++) {
+		for (size_t p=0; p<k; p++) resized[a * (k + 1) + p] = counts[a * k + p];
+	}
+	counts = std::move(resized);
+	labels.push_back(label);
+	return k;
+}
+
+inline size_t confusion_matrix::size(void) const {
+	return labels.size();
+}
+
+inline void confusion_matrix::add(_in size_t actual_index, _in size_t predicted_index, _in size_t count) {
+	counts[actual_index * labels.size() + predicted_index] += count;
+}
+
+inline void confusion_matrix::merge(_in const confusion_matrix& other) {
+	if (labels != other.labels) THROW_GAENARI_INTERNAL_ERROR0;
+	for (size_t i=0; i<counts.size(); i++) counts[i] += other.counts[i];
+}
+
+inline size_t confusion_matrix::get(_in size_t actual, _in size_t predicted) const {
+	auto a = index(actual);
+	auto p = index(predicted);
+	if ((a == std::numeric_limits<size_t>::max()) or (p == std::numeric_limits<size_t>::max())) return 0;
+	return counts[a * labels.size() + p];
+}
+
+inline void confusion_matrix::to_map(_out std::map<size_t,std::map<size_t,size_t>>& confusion) const {
+	constexpr size_t unknown = std::numeric_limits<size_t>::max();
+	const size_t k = labels.size();
+
+	// clear output.
+	confusion.clear();
+
+	// because it may not be displayed if the number of items,
+	// set label value items in the confusion matrix in advance.
+	for (size_t a=0; a<base_count; a++) {
+		for (size_t p=0; p<base_count; p++) confusion[labels[a]][labels[p]] = 0;
+	}
+
+	// counted items.
+	for (size_t a=0; a<k; a++) {
+		for (size_t p=0; p<k; p++) {
+			const auto count = counts[a * k + p];
+			if (count != 0) confusion[labels[a]][labels[p]] += count;
+		}
+	}
+
+	// remove unneccessay `unknown`
+	// 1) if all unknown rows are 0, remove.
+	// 2) if all unknown cols are 0, remove.
+	auto found = true;
+	for (const auto col: confusion[unknown]) if (col.second != 0) found = false;
+	if (found) confusion.erase(unknown);
+	found = true;
+	for (auto& row: confusion) if (row.second[unknown] != 0) found = false;
+	if (found) for (auto& row: confusion) row.second.erase(unknown);
+}
+
+} // decision_tree
+} // method
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_CONFUSION_HPP
@@ -0,0 +1,201 @@
+#ifndef HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_CONTROL_HPP
+#define HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_CONTROL_HPP
+
+namespace gaenari {
+namespace method {
+namespace decision_tree {
+
+// progress of training. see train_control.
+struct train_progress {
+	enum class stop_reason {
+		none		= 0,
+		time_budget	= 1,
+		node_budget	= 2,
+		canceled	= 3,
+	};
+	size_t nodes = 0;					// tree nodes built. (before pruning)
+	size_t rows  = 0;					// sum of rows of the expanded nodes. (a row is counted once per depth)
+	size_t depth = 0;					// depth of the deepest expanded node. root is 0.
+	double elapsed_msec = 0.0;			// elapsed time from the start of training.
+	stop_reason stopped = stop_reason::none;	// not none, the nodes not expanded yet are finalized as leaves.
+	bool finished = false;				// the last call of training.
+};
+
+// training control.
+// set to train_param::control. it must be alive while training.
+//
+// - budget       : when the time or the node count is over, the nodes not expanded yet(frontier) become leaf nodes.
+//                  the tree is valid, but smaller than the full training.
+//                  the node budget is not exceeded, a split with more childs than the remaining budget is not done.
+//                  depth-first training expands a deep path first, so level_wise training gives a more balanced tree on the budget.
+// - progress     : called every progress_interval_msec, and once at the end with finished = true.
+//                  it can be called from a training thread, but it's not called concurrently.
+// - cancellation : call cancel() from any thread. the training stops like the budget expiry.
+//
+// ex)
+// train_control control;
+// train_param param;
+// control.time_budget_msec = 60000;
+// control.progress = [](const train_progress& p) {...};
+// param.control = &control;
+// dt.train(ds, split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+// if (control.result().stopped != train_progress::stop_reason::none) ...
+class train_control {
+public:
+	train_control()  = default;
+	~train_control() = default;
+	train_control(const train_control&) = delete;
+	train_control& operator=(const train_control&) = delete;
+
+public:
+	// [0] wall-clock time budget in milliseconds. 0 means unlimited.
+	size_t time_budget_msec = 0;
+
+	// [0] tree node budget. 0 means unlimited.
+	size_t max_nodes = 0;
+
+	// [1000] interval of progress callback in milliseconds.
+	size_t progress_interval_msec = 1000;
+
+	// progress callback. (optional)
+	std::function<void(_in const train_progress& progress)> progress;
+
+public:
+	// cooperative cancellation. thread-safe.
+	void cancel(void) {canceled = true;}
+	bool is_canceled(void) const {return canceled;}
+
+	// the last progress of the training.
+	const train_progress& result(void) const {return last;}
+
+protected:
+	std::atomic<bool> canceled{false};
+	train_progress last;
+	friend class train_monitor;
+};
+
+// monitor one training with train_control. (internal)
+// the counters are atomic, the nodes of parallel subtrees can be expanded concurrently.
+// no control, it does nothing.
+class train_monitor {
+public:
+	train_monitor() = delete;
+	train_monitor(_option_in train_control* control): control{control} {
+		start = last_report = std::chrono::steady_clock::now();
+	}
+	~train_monitor() = default;
+
+public:
+	// called before a node is expanded. rows are the row count of the node.
+	// returns true if the training is stopped, and the node must be a leaf.
+	bool expand(_in const tree_node& node, _in size_t rows);
+
+	// childs of a node are about to be built.
+	// returns false if the childs are over the node budget, the training is stopped, and the node must be a leaf.
+	bool add_nodes(_in size_t count);
+
+	// the training is stopped?
+	bool stopped(void) const;
+
+	// the training is finished. the last progress is reported.
+	void finish(void);
+
+protected:
+	train_progress get_progress(_in bool finished) const;
+
+protected:
+	train_control* control = nullptr;
+	std::chrono::steady_clock::time_point start;
+	std::chrono::steady_clock::time_point last_report;	// guarded by mutex.
+	std::atomic<size_t> nodes{1};	// root.
+	std::atomic<size_t> rows{0};
+	std::atomic<size_t> depth{0};
+	std::atomic<int> stop{0};		// train_progress::stop_reason.
+	std::mutex mutex;
+};
+
+// implementation.
+
+inline bool train_monitor::expand(_in const tree_node& node, _in size_t rows) {
+	using stop_reason = train_progress::stop_reason;
+	if (not control) return false;
+
+	// counters.
+	size_t node_depth = 0;
+	for (auto* p=node.parent; p; p=p->parent) node_depth++;
+	this->rows += rows;
+	auto d = depth.load();
+	while ((d < node_depth) and (not depth.compare_exchange_weak(d, node_depth))) {}
+
+	// check budget.
+	auto now = std::chrono::steady_clock::now();
+	if (stop == 0) {
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+		int reason = static_cast<int>(stop_reason::none);
+		if (control->is_canceled()) reason = static_cast<int>(stop_reason::canceled);
+		else if ((control->max_nodes > 0) and (nodes >= control->max_nodes)) reason = static_cast<int>(stop_reason::node_budget);
+		else if ((control->time_budget_msec > 0) and (static_cast<size_t>(elapsed) >= control->time_budget_msec)) reason = static_cast<int>(stop_reason::time_budget);
+		if (reason != static_cast<int>(stop_reason::none)) {
+			int expected = 0;
+			stop.compare_exchange_strong(expected, reason);
+		}
+	}
+
+	// progress in the interval.
+	// do not wait for the other thread reporting.
+	if (control->progress) {
+		std::unique_lock<std::mutex> l(mutex, std::try_to_lock);
+		if (l.owns_lock() and (std::chrono::duration_cast<std::chrono::milliseconds>(now - last_report).count() >= static_cast<int64_t>(control->progress_interval_msec))) {
+			last_report = now;
+			control->progress(get_progress(false));
+		}
+	}
+
+	return stop != 0;
+}
+
+inline bool train_monitor::add_nodes(_in size_t count) {
+	if ((not control) or (control->max_nodes == 0)) {
+		nodes += count;
+		return true;
+	}
+
+	// the budget is checked with the childs, the concurrent splits can not exceed it.
+	auto n = nodes.load();
+	do {
+		if (n + count > control->max_nodes) {
+			int expected = 0;
+			stop.compare_exchange_strong(expected, static_cast<int>(train_progress::stop_reason::node_budget));
+			return false;
+		}
+	} while (not nodes.compare_exchange_weak(n, n + count));
+	return true;
+}
+
+inline bool train_monitor::stopped(void) const {
+	return stop != 0;
+}
+
+inline void train_monitor::finish(void) {
+	if (not control) return;
+	std::lock_guard<std::mutex> l(mutex);
+	control->last = get_progress(true);
+	if (control->progress) control->progress(control->last);
+}
+
+inline train_progress train_monitor::get_progress(_in bool finished) const {
+	train_progress ret;
+	ret.nodes        = nodes;
+	ret.rows         = rows;
+	ret.depth        = depth;
+	ret.elapsed_msec = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	ret.stopped      = static_cast<train_progress::stop_reason>(stop.load());
+	ret.finished     = finished;
+	return ret;
+}
+
+} // decision_tree
+} // method
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_CONTROL_HPP
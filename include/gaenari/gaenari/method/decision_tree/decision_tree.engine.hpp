@@ -11,22 +11,137 @@ public:
 	// split tree with current row selections.
 	// return multple split infos.
 	// empty return, stop criteria.
-	static inline std::vector<split_info> split_tree(_in const dataset::dataset& train, _in const std::vector<size_t>& row_selections, _in split_strategy split_strategy, _in size_t min_instances) {
-		auto found = false;
-		size_t best_feature_index = 0;
-		igr_result max_igr;
+	// label_count is the dense label count of row_selections.
+	// histogram is required for split_strategy_histogram.
+	// nominal_min_support is train_param::nominal_min_support.
+	// if pool is set, features are evaluated in parallel,
+	// and the result is the same as the serial evaluation.
+	// if features is set, only the features of true are evaluated. (feature subspace)
+	static inline std::vector<split_info> split_tree(_in const dataset::dataset& train, _in const dense_label& labels, _in const row_range& row_selections, _in const size_t* label_count, _in split_strategy split_strategy, _in size_t min_instances, _in size_t nominal_min_support, _option_in const histogram* histogram = nullptr, _option_in common::thread_pool* pool = nullptr, _option_in const std::vector<bool>* features = nullptr) {
+		std::vector<igr_result> igrs;
 
 		// some values
 		const auto feature_count = train.x.columns().size();
+
+		// calc information gain ratio of each features.
+		auto S = calc_entropy(label_count, labels.size(), static_cast<double>(row_selections.size()));
+		if (pool and (pool->size() > 1) and (feature_count > 1)) {
+			// each feature is independent, evaluate in parallel.
+			igrs.resize(feature_count);
+			pool->parallel_for(feature_count, [&](size_t feature_index) {
+				if (features and (not (*features)[feature_index])) return;
+				igrs[feature_index] = calc_igr_main(train, labels, row_selections, feature_index, S, split_strategy, nominal_min_support, histogram);
+			});
+		}
+
+		// choose best one.
+		return select_split(feature_count, features, row_selections.size(), min_instances, [&](size_t feature_index) {
+			return igrs.empty() ? calc_igr_main(train, labels, row_selections, feature_index, S, split_strategy, nominal_min_support, histogram) : std::move(igrs[feature_index]);
+		});
+	}
+
+	// same as split_tree(...), but the features are ranked on a stratified sample of the rows. (sampled split search)
+	// the top `top_features` features of the sample are evaluated again with all rows, and the best one is chosen.
+	// so, the split infos(threshold and count) are always of all rows, only the choice of the feature is approximated.
+	// the sample is deterministic. the rows of each label are taken at the same interval.
+	static inline std::vector<split_info> split_tree_sampled(_in const dataset::dataset& train, _in const dense_label& labels, _in const row_range& row_selections, _in const size_t* label_count, _in split_strategy split_strategy, _in size_t min_instances, _in size_t nominal_min_support, _in size_t sample_rows, _in size_t top_features, _option_in const histogram* histogram = nullptr, _option_in common::thread_pool* pool = nullptr, _option_in const std::vector<bool>* features = nullptr) {
+		const auto feature_count = train.x.columns().size();
+		const auto selected_count = features ? static_cast<size_t>(std::count(features->begin(), features->end(), true)) : feature_count;
+		const auto row_count = row_selections.size();
+		const auto label_size = labels.size();
+		const bool parallel = pool and (pool->size() > 1);
+
+		// nothing to reduce.
+		if ((sample_rows == 0) or (sample_rows >= row_count) or (top_features >= selected_count)) {
+			return split_tree(train, labels, row_selections, label_count, split_strategy, min_instances, nominal_min_support, histogram, pool, features);
+		}
+
+		// stratified sample.
+		// a row is taken when the quota of its label(seen * sample_rows / row_count) is increased.
+		std::vector<size_t> sample;
+		std::vector<size_t> seen(label_size, 0);
+		std::vector<size_t> sample_label_count(label_size, 0);
+		sample.reserve(sample_rows + label_size);
+		for (const auto row_index: row_selections) {
+			const auto label = labels.get(row_index);
+			const auto quota = ++seen[label] * sample_rows / row_count;
+			if (quota <= sample_label_count[label]) continue;
+			sample.push_back(row_index);
+			sample_label_count[label]++;
+		}
+		row_range sample_selections{sample.data(), sample.data() + sample.size()};
+
+		// rank features on the sample.
+		std::vector<igr_result> igrs(feature_count);
+		auto S = calc_entropy(sample_label_count.data(), label_size, static_cast<double>(sample.size()));
+		auto eval_sample = [&](size_t feature_index) {
+			if (features and (not (*features)[feature_index])) {igrs[feature_index].stop_criteria = true; return;}
+			igrs[feature_index] = calc_igr_main(train, labels, sample_selections, feature_index, S, split_strategy, nominal_min_support, histogram);
+		};
+		if (parallel) pool->parallel_for(feature_count, eval_sample);
+		else for (size_t feature_index=0; feature_index<feature_count; feature_index++) eval_sample(feature_index);
+		std::vector<size_t> candidates;
+		for (size_t feature_index=0; feature_index<feature_count; feature_index++) {
+			if (not igrs[feature_index].stop_criteria) candidates.push_back(feature_index);
+		}
+
+		// no split found in the sample. it may be too small, evaluate all rows.
+		if (candidates.empty()) return split_tree(train, labels, row_selections, label_count, split_strategy, min_instances, nominal_min_support, histogram, pool, features);
+
+		// top features. the lower feature index first on a tie.
+		std::stable_sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) {return igrs[a].igr_value > igrs[b].igr_value;});
+		if (candidates.size() > top_features) candidates.resize(top_features);
+
+		// confirm the candidates with all rows.
+		S = calc_entropy(label_count, label_size, static_cast<double>(row_count));
+		auto eval_all = [&](size_t i) {
+			igrs[candidates[i]] = calc_igr_main(train, labels, row_selections, candidates[i], S, split_strategy, nominal_min_support, histogram);
+		};
+		std::vector<bool> confirmed(feature_count, false);
+		for (const auto feature_index: candidates) confirmed[feature_index] = true;
+		if (parallel and (candidates.size() > 1)) pool->parallel_for(candidates.size(), eval_all);
+		else for (size_t i=0; i<candidates.size(); i++) eval_all(i);
+
+		// choose best one.
+		return select_split(feature_count, features, row_count, min_instances, [&](size_t feature_index) {
+			igr_result not_confirmed;
+			not_confirmed.stop_criteria = true;
+			return confirmed[feature_index] ? std::move(igrs[feature_index]) : not_confirmed;
+		});
+	}
+
+	// same as split_tree(...), but with dense (bin, label) count of the node instead of rows. (level-wise training)
+	// every feature is bucketed by histogram. (numeric and nominal)
+	// - count     : [offsets[feature_index] + bin * label_size + label] = count.
+	// - row_count : sum of label_count.
+	static inline std::vector<split_info> split_tree(_in const dense_label& labels, _in const histogram& histogram, _in const size_t* count, _in const std::vector<size_t>& offsets, _in const size_t* label_count, _in size_t row_count, _in size_t min_instances, _in size_t nominal_min_support, _option_in const std::vector<bool>* features = nullptr) {
+		const auto feature_count = histogram.columns.size();
+		auto S = calc_entropy(label_count, labels.size(), static_cast<double>(row_count));
+		return select_split(feature_count, features, row_count, min_instances, [&](size_t feature_index) {
+			const auto& column = histogram.columns[feature_index];
+			if (column.numeric) return calc_igr_numeric_bins(labels, feature_index, S, row_count, count + offsets[feature_index], column.uppers);
+			if (column.nominal) return calc_igr_nominal_bins(labels, feature_index, S, row_count, count + offsets[feature_index], column.values, nominal_min_support);
+			THROW_GAENARI_INTERNAL_ERROR0;
+		});
+	}
+
+	// choose the best split of the features.
+	// get_igr(feature_index) returns the igr_result of the feature, and it's called in feature index order.
+	// reduce in feature index order, so the first feature wins on a tie.
+	// if features is set, get_igr(...) is not called for the features of false.
+	template <typename fn_t>
+	static inline std::vector<split_info> select_split(_in size_t feature_count, _option_in const std::vector<bool>* features, _in size_t row_count, _in size_t min_instances, _in fn_t&& get_igr) {
+		auto found = false;
+		igr_result max_igr;
 		max_igr.stop_criteria = true;
 		max_igr.igr_value = std::numeric_limits<double>::lowest();
 
-		// calc information gain ratio of each features.
-		// and choose best one.
-		auto S = calc_S<size_t>(train, row_selections);
 		for (size_t feature_index=0; feature_index<feature_count; feature_index++) {
+			// not in the feature subspace.
+			if (features and (not (*features)[feature_index])) continue;
+
 			// get information gain ratio and split info of current feature index.
-			auto igr = calc_igr_main(train, row_selections, feature_index, S, split_strategy);
+			igr_result igr = get_igr(feature_index);
 
 			// stop criteria. do not split.
 			if (igr.stop_criteria) continue;
@@ -40,7 +155,6 @@ public:
 				// best igr found
 				found = true;
 				max_igr = igr;
-				best_feature_index = feature_index;
 			}
 		}
 
@@ -65,7 +179,7 @@ public:
 		for (const auto& split_info: max_igr.split_infos) {
 			size_t total_count = 0;
 			for (const auto& count: split_info.predicted_count.count) total_count += count.second;
-			if (total_count == row_selections.size()) return {};
+			if (total_count == row_count) return {};
 		}
 		
 		// return maximum information gain ratio's split infos.
@@ -77,85 +191,85 @@ public:
 	// correct_count   : count of (max_count_index == index)
 	// incorrect_count : count of (max_count_index != index)
 	// static inline std::map<size_t,size_t> _get_leaf_info(_in const dataset::dataset& train, _in const std::vector<size_t>& row_selections, _out size_t& max_count_index, _out size_t& correct_count, _out size_t& incorrect_count) {
-	static inline std::map<size_t,size_t> get_leaf_info(_in const dataset::dataset& train, _in const std::vector<size_t>& row_selections, _out leaf_info_t& leaf_info) {
-		std::map<size_t,size_t> label_count;
+	static inline predicted_count_t::count_t get_leaf_info(_in const dense_label& labels, _in const row_range& row_selections, _out leaf_info_t& leaf_info) {
+		std::vector<size_t> dense_count(labels.size(), 0);
 
 		// get occurence
-		for (const auto& row_index: row_selections) label_count[train.y.get_raw(row_index, 0).index]++;
+		labels.count(row_selections, dense_count.data());
+		return get_leaf_info(labels, dense_count.data(), leaf_info);
+	}
+
+	// same as above, with the dense label count of row selections.
+	static inline predicted_count_t::count_t get_leaf_info(_in const dense_label& labels, _in const size_t* label_count, _out leaf_info_t& leaf_info) {
+		predicted_count_t::count_t _label_count;
+
+		// zero count is not included.
+		labels.to_map(label_count, _label_count);
 
 		// get leaf_info from label_count.
-		get_leaf_info(label_count, leaf_info);
+		get_leaf_info(_label_count, leaf_info);
 
-		return label_count;
+		return _label_count;
 	}
 
-	// after an early stop, there can be a leaf node have same label.
-	// return
-	//  - something combined : true
-	//  - nothing   combined : false
-	// ex)
-	// salary <= 25373.075010
-    //     age <= 23.000000: G1 (1/0)
-    //     age > 23.000000: G1 (3/0)
-	// ...
-	// ==>
-	// salary <= 25373.075010: G1 (4/0)
-	// ...
+	// post-processing of the trained tree.
+	// it's done in one post-order pass. a node is processed after all its childs are final.
+	// a node becomes a leaf node when it has only leaf nodes(terminal node) and one of the following is true.
 	//
-	static inline bool combine_same_label(_in _out tree_node& root) {
-		bool found_something = false;
-		bool found = false;
+	// 1) post pruning
+	//  - pruning if : terminal node error rate < sum of leaf node error rate * weight
+	//  -------+--------------+-------------
+	//  weight | pruning size | tree size
+	//  -------+--------------+-------------
+	//  [,1.0] | not accepted | not accepted
+	//    1.5  | 
+	//
+	// 2) combine same label (except root)
+	//  after an early stop, there can be a leaf node have same label.
+	//  ex)
+	//  salary <= 25373.075010
+	//      age <= 23.000000: G1 (1/0)
+	//      age > 23.000000: G1 (3/0)
+	//  ...
+	//  ==>
+	//  salary <= 25373.075010: G1 (4/0)
+	//  ...
+	//
+	// the conditions of a terminal node depend only on itself and its leaf nodes, which do not change anymore.
+	// so, the result is the same as repeating pruning and combining over the whole tree until nothing changes.
+	static inline void post_processing(_in _out tree_node& root, _in double weight) {
+		std::vector<std::pair<tree_node*,int>> order;	// (node, depth) in pre-order.
+		std::vector<std::pair<tree_node*,int>> stack;
+
+		// pre-order.
+		stack.emplace_back(&root, 0);
+		for (;;) {
+			if (stack.empty()) break;
+			auto current = stack.back();
+			stack.pop_back();
+			order.push_back(current);
+			for (auto* child: current.first->childs) stack.emplace_back(child, current.second + 1);
+		}
 
-		// loop till there is no same label.
-		for (int i=0; i<65536; i++) {
-			found = false;
-			// traverse all tree nodes.
-			util::traverse_tree_node(root, [&found,&found_something](auto& treenode, int depth) -> bool {
-				bool treenode_has_same_label = false;
-
-				// finds if it has only leaf nodes that all refer to the same class.
-
-				// skip root node.
-				if (depth == 0) return true;
-
-				// skip leaf node.
-				if (treenode.leaf) return true;
-				if (treenode.childs.size() == 0) THROW_GAENARI_INTERNAL_ERROR0;
-
-				// check 'has only leaf nodes' and label index
-				size_t label_string_index = treenode.childs[0]->leaf_info.label_string_index;
-				treenode_has_same_label = true;
-				for (const auto& child: treenode.childs) {
-					if (not child->leaf) {
-						treenode_has_same_label = false;
-						break;
-					}
-					if (child->leaf_info.label_string_index != label_string_index) {
-						treenode_has_same_label = false;
-						break;
-					}
-				}
-
-				if (not treenode_has_same_label) return true;
-
-				// this treenode's children has same label.
-				found = true;
-				found_something = true;
+		// reverse pre-order visits childs before the parent.
+		for (auto it=order.rbegin(); it!=order.rend(); ++it) {
+			auto& node  = *it->first;
+			auto  depth = it->second;
 
-				// remove child nodes and set as leaf node.
-				treenode.leaf = true;
-				engine::get_leaf_info(treenode.predicted_count.count, treenode.leaf_info);
-				treenode.destroy_all_child_node(false);
+			// check only terminal node(=have only leaf nodes).
+			if (not util::is_terminal_node(node)) continue;
 
-				// traverse continue
-				return true;
-			});
+			// pruning or combining?
+			bool do_leaf = false;
+			if (weight >= 1.0) do_leaf = check_post_pruning(node, weight);
+			if ((not do_leaf) and (depth != 0)) do_leaf = check_same_label(node);
+			if (not do_leaf) continue;
 
-			if (not found) break;
+			// remove child nodes and set as leaf node.
+			node.leaf = true;
+			get_leaf_info(node.predicted_count.count, node.leaf_info);
+			node.destroy_all_child_node(false);
 		}
-
-		if (found) THROW_GAENARI_ERROR("too much cases for _combine_same_label.");
-		return found_something;
 	}
 
 	// early stop if (split error rate * weight > parent error rate).
@@ -204,87 +318,56 @@ public:
 		return false;
 	}
 
-	// post pruning weight
-	//
-	// post pruning conditions
-	//  - terminal node(having only leaf nodes) only.
-	//  - pruning if : terminal node error rate < sum of leaf node error rate * weight
-	//  - repeat until no pruning occurs.
-	// return
-	//  -    pruning occured : true
-	//  - no pruning occured : false
-	// 
-	// -------+--------------+-------------
-	// weight | pruning size | tree size
-	// -------+--------------+-------------
-	// [,1.0] | not accepted | not accepted
-	//   1.5  | 
-	static inline bool post_pruning(_in _out tree_node& root, _in double weight) {
-		// root traversing till no pruning found.
-		bool found = false;
-		if (weight < 1.0) return false;
-		for (;;) {
-			found = false;
-			util::traverse_tree_node(root, [&found,&weight](tree_node& node, int depth) -> bool {
-				bool do_pruning = false;
-
-				// check only terminal node(=have only leaf nodes).
-				if (not util::is_terminal_node(node)) return true;
-
-				// get the current incorrect count.
-				leaf_info_t _leaf_info;
-				get_leaf_info(node.predicted_count.count, _leaf_info);
-				size_t current_total_count = _leaf_info.incorrect_count + _leaf_info.correct_count;
-				size_t current_incorrect_count = _leaf_info.incorrect_count;
-
-				// get the incorrect count when splitting.
-				size_t child_total_count = 0;
-				size_t child_incorrect_count = 0;
-				for (const auto& child: node.childs) {
-					child_total_count += child->leaf_info.correct_count + child->leaf_info.incorrect_count;
-					child_incorrect_count += child->leaf_info.incorrect_count;
-				}
-
-				if (current_total_count != child_total_count) THROW_GAENARI_ERROR("internal error(child_total_count != current_total_count.");
-
-				// calc error rate of each cases.
-				// - current node error rate
-				// - child error rate
-				double current_error_rate = static_cast<double>(current_incorrect_count) / static_cast<double>(current_total_count);
-				double child_error_rate   = static_cast<double>(child_incorrect_count)   / static_cast<double>(child_total_count);
-
-				// multiply by weight
-				child_error_rate *= weight;
-
-				// when the error rate becomes larger when splitting, do pruning.
-				if (current_error_rate < child_error_rate) {
-					do_pruning = true;
-				}
-
-				// pruning?
-				if (do_pruning) {
-					node.leaf = true;
-					found = true;
-					get_leaf_info(node.predicted_count.count, node.leaf_info);
-					node.destroy_all_child_node(false);
-				}
-
-				return true;
-			});
-			if (not found) break;
+protected:
+	// post pruning condition of the terminal node.
+	static inline bool check_post_pruning(_in const tree_node& node, _in double weight) {
+		// get the current incorrect count.
+		leaf_info_t _leaf_info;
+		get_leaf_info(node.predicted_count.count, _leaf_info);
+		size_t current_total_count = _leaf_info.incorrect_count + _leaf_info.correct_count;
+		size_t current_incorrect_count = _leaf_info.incorrect_count;
+
+		// get the incorrect count when splitting.
+		size_t child_total_count = 0;
+		size_t child_incorrect_count = 0;
+		for (const auto& child: node.childs) {
+			child_total_count += child->leaf_info.correct_count + child->leaf_info.incorrect_count;
+			child_incorrect_count += child->leaf_info.incorrect_count;
 		}
-		return found;
+
+		if (current_total_count != child_total_count) THROW_GAENARI_ERROR("internal error(child_total_count != current_total_count.");
+
+		// calc error rate of each cases.
+		// - current node error rate
+		// - child error rate
+		double current_error_rate = static_cast<double>(current_incorrect_count) / static_cast<double>(current_total_count);
+		double child_error_rate   = static_cast<double>(child_incorrect_count)   / static_cast<double>(child_total_count);
+
+		// multiply by weight
+		child_error_rate *= weight;
+
+		// when the error rate becomes larger when splitting, do pruning.
+		return current_error_rate < child_error_rate;
+	}
+
+	// the terminal node has leaf nodes that all refer to the same class.
+	static inline bool check_same_label(_in const tree_node& node) {
+		if (node.childs.size() == 0) THROW_GAENARI_INTERNAL_ERROR0;
+		size_t label_string_index = node.childs[0]->leaf_info.label_string_index;
+		for (const auto& child: node.childs) {
+			if (child->leaf_info.label_string_index != label_string_index) return false;
+		}
+		return true;
 	}
 
-protected:
 	// find the label index with the maximum occurence.
 	// could a non-maximum be selected in the future?
 	// since it's still greedy, it finds the max.
 	// the processing of two or more same max follows the order of the map's key.
-	static inline size_t get_label_index(_in const std::map<size_t,size_t>& label_count) {
+	static inline size_t get_label_index(_in const predicted_count_t::count_t& label_count) {
 		size_t r   = 0;
 		size_t max = std::numeric_limits<size_t>::lowest();
-		for (const auto i: label_count) {
+		for (const auto& i: label_count) {
 			if (max < i.second) {
 				max = i.second;
 				r = i.first;
@@ -293,7 +376,7 @@ protected:
 		return r;
 	}
 
-	static inline void get_leaf_info(_in const std::map<size_t,size_t>& label_count, _out leaf_info_t& leaf_info) {
+	static inline void get_leaf_info(_in const predicted_count_t::count_t& label_count, _out leaf_info_t& leaf_info) {
 		// clear
 		leaf_info = method::decision_tree::leaf_info_t{};
 
@@ -307,104 +390,43 @@ protected:
 		}
 	}
 
-	// return parent information gain S
-	template <typename count_t>
-	static inline double calc_S(_in const dataset::dataset& train, _in const std::vector<size_t>& row_selections) {
-		double S = 0.0;
-		std::map<type::value_obj,count_t> label_count;
-		
-		// short alias name and intialize
-		const auto& y = train.y;
-		double size = static_cast<double>(row_selections.size());
-
-		// count each label value, and calc 'S'
-		for (const auto& row_index: row_selections) {
-			const auto& label = y.get_raw(row_index, 0);
-			label_count[label]++;
-		}
-
-		for (const auto& label: label_count) {
-			auto p = static_cast<double>(label.second) / size;
-			S -= p * std::log2(p);
-		}
-
-		return S;
-	}
-
-	// calc entropy.
-	// _count_t is assumed to be either 'int' or 'size_t'. (size_t is more suitable for big data.)
-	template<typename object_t, typename count_t>
-	static inline double calc_entropy(_in const std::map<object_t, count_t>& label_count, _option_out double* value_count) {
-		double _value_count = 0.0;
+	// calc entropy of dense label counts.
+	// it's the innermost loop of training.
+	// - label_count : contiguous label count array [0, label_size).
+	// - value_count : sum of label_count.
+	static inline double calc_entropy(_in const size_t* label_count, _in size_t label_size, _in double value_count) {
 		double e = 0.0;
-
-		// total count
-		for (const auto& labels: label_count) _value_count += static_cast<double>(labels.second);
-
-		// entropy calculation.
-		for (const auto& labels: label_count) {
-			if (labels.second == 0) continue;
-			double p = static_cast<double>(labels.second) / _value_count;
+		for (size_t i=0; i<label_size; i++) {
+			if (label_count[i] == 0) continue;
+			double p = static_cast<double>(label_count[i]) / value_count;
 			e -= p * std::log2(p);
 		}
-
-		// pass total count if required.
-		if (value_count) *value_count = _value_count;
-
 		return e;
 	}
 
-	// calc weighted entropy sum.
-	// value_t is assumed to be either 'value_obj' or 'value'.
-	// label_t is assumed to be size_t. (nominal label(strings index))
-	// count_t is assumed to be either 'int' or 'size_t'. (size_t is more suitable for big data.)
-	// if the total count has already been calculated, the counting process is passed.
-	template <typename value_t, typename label_t, typename count_t>
-	static inline double calc_weighted_entropy_sum(_in const std::map<value_t, std::map<label_t, count_t>>& value_label_count, _option_in size_t* total_count = nullptr) {
-		double r = 0;
-		double _total_count = 0;
-
-		// get total count.
-		if (total_count) {
-			_total_count = static_cast<double>(*total_count);
-		} else {
-			size_t __total_count = 0;
-			for (const auto& values: value_label_count)
-				for (const auto& labels: values.second)
-					__total_count += labels.second;
-			_total_count = static_cast<double>(__total_count);
-		}
-
-		// for each values, and for each labels
-		for (const auto& values: value_label_count) {
-			double value_count = 0;
-			auto e = calc_entropy(values.second, &value_count);
-			double weight = value_count / _total_count;
-			
-			// E(S, feature) += count_value1_in_feature / size * E(each label count wehn feature == value) + ...
-			// ------+------    ---------------+--------------   ---------------------+-------------------
-			//       |                         |                                      |
-			//       V                         V                                      V
-			r                +=              weight            *                      e;
-		}
-
+	// calc weighted entropy sum of two splits. (<= split point, > split point)
+	// E(S, feature) = count_lte / size * E(lte) + count_gt / size * E(gt)
+	static inline double calc_weighted_entropy_sum(_in const std::vector<size_t>& lte, _in size_t lte_count, _in const std::vector<size_t>& gt, _in size_t gt_count) {
+		double r = 0.0;
+		double total_count = static_cast<double>(lte_count + gt_count);
+		if (lte_count != 0) r += static_cast<double>(lte_count) / total_count * calc_entropy(lte.data(), lte.size(), static_cast<double>(lte_count));
+		if (gt_count  != 0) r += static_cast<double>(gt_count)  / total_count * calc_entropy(gt.data(),  gt.size(),  static_cast<double>(gt_count));
 		return r;
 	}
 
 	// typical ID3 method.
-	static inline igr_result calc_igr_nominal_default_strategy(_in const dataset::dataset& train, _in const std::vector<size_t>& row_selections, _in size_t feature_index, _in double S) {
-		igr_result r;
-		double intrinsic_information_of_split = 0.0;
-		std::map<type::value_obj, std::map<size_t, size_t>> value_label_count;
+	static inline igr_result calc_igr_nominal_default_strategy(_in const dataset::dataset& train, _in const dense_label& labels, _in const row_range& row_selections, _in size_t feature_index, _in double S, _in size_t min_support) {
+		std::unordered_map<size_t,size_t> value_slots;	// value(string index) -> slot
+		std::vector<size_t> slot_values;				// slot -> value(string index)
+		std::vector<size_t> value_label_count;			// [slot * label_size + label] = count
 
 		// short alias name
 		const auto& x = train.x;
-		const auto& y = train.y;
 		const auto& features = train.x.columns();
+		const size_t label_size = labels.size();
 
 		// initialize
 		auto total_count = row_selections.size();
-		double size = static_cast<double>(total_count);
 
 		// get data type
 		auto data_type = features[feature_index].data_type;
@@ -413,18 +435,78 @@ protected:
 
 		// counting
 		for (const auto& row_index: row_selections) {
-			const auto& value = x.get_raw(row_index, feature_index);
-			const auto& label = y.get_raw(row_index, 0).index;
+			const auto value = x.get_raw(row_index, feature_index).index;
+			auto find = value_slots.try_emplace(value, slot_values.size());
+			if (find.second) {
+				// new value.
+				slot_values.push_back(value);
+				value_label_count.resize(value_label_count.size() + label_size, 0);
+			}
 
 			// (value,label) count for information gain calculation.
-			value_label_count
-				[value]	// each value
-				[label]	// each label
-				++;		// count increment
+			value_label_count[find.first->second * label_size + labels.get(row_index)]++;
+		}
+
+		// reorder in the order of value(string index), the same order as std::map.
+		std::vector<size_t> order(slot_values.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&slot_values](size_t a, size_t b) {return slot_values[a] < slot_values[b];});
+		std::vector<size_t> values(order.size());
+		std::vector<size_t> count(order.size() * label_size);
+		for (size_t i=0; i<order.size(); i++) {
+			values[i] = slot_values[order[i]];
+			std::copy_n(&value_label_count[order[i] * label_size], label_size, &count[i * label_size]);
+		}
+
+		return calc_igr_nominal_bins(labels, feature_index, S, total_count, count.data(), values, min_support);
+	}
+
+	// same as calc_igr_nominal_default_strategy(...) with dense (value, label) count.
+	// - count  : [bin * label_size + label] = count. bins are in ascending order of string index.
+	// - values : bin -> string index.
+	// the bin that does not appear in the current rows(all zero) is skipped.
+	// - min_support : the bins with less rows than this are grouped into one `other` bin. 0 means disabled.
+	//                 the `other` bin is the last split info with rule_t::rule_type::cmp_other.
+	static inline igr_result calc_igr_nominal_bins(_in const dense_label& labels, _in size_t feature_index, _in double S, _in size_t total_count, _in const size_t* count, _in const std::vector<size_t>& values, _in size_t min_support) {
+		igr_result r;
+		double intrinsic_information_of_split = 0.0;
+		const size_t label_size = labels.size();
+		const size_t bin_size = values.size();
+		double size = static_cast<double>(total_count);
+
+		// row count of each bin.
+		std::vector<size_t> value_counts(bin_size, 0);
+		for (size_t bin=0; bin<bin_size; bin++) {
+			for (size_t label=0; label<label_size; label++) value_counts[bin] += count[bin * label_size + label];
+		}
+
+		// group the rare bins into the `other` bin.
+		// the grouped bins are skipped as zero count, and the `other` bin is calculated at last.
+		std::vector<size_t> other_count;
+		size_t other_value_count = 0;
+		if (min_support > 0) {
+			for (size_t bin=0; bin<bin_size; bin++) {
+				if ((value_counts[bin] == 0) or (value_counts[bin] >= min_support)) continue;
+				if (other_count.empty()) other_count.assign(label_size, 0);
+				for (size_t label=0; label<label_size; label++) other_count[label] += count[bin * label_size + label];
+				other_value_count += value_counts[bin];
+				value_counts[bin] = 0;
+			}
 		}
 
 		// get weighted entropy sum.
-		r.igr_value = calc_weighted_entropy_sum(value_label_count, &total_count);
+		// E(S, feature) += count_value1_in_feature / size * E(each label count wehn feature == value) + ...
+		r.igr_value = 0.0;
+		for (size_t bin=0; bin<bin_size; bin++) {
+			if (value_counts[bin] == 0) continue;
+			double value_count = static_cast<double>(value_counts[bin]);
+			auto e = calc_entropy(&count[bin * label_size], label_size, value_count);
+			r.igr_value += value_count / size * e;
+		}
+		if (other_value_count > 0) {
+			double value_count = static_cast<double>(other_value_count);
+			r.igr_value += value_count / size * calc_entropy(other_count.data(), label_size, value_count);
+		}
 
 		// calc information gain.
 		// the higher the information gain, the better division.
@@ -435,11 +517,13 @@ protected:
 
 		// current igr is the information gain.
 		// calc intrinsic information gain to get information grain ratio.
-		for (const auto& values: value_label_count) {
-			// get value count
-			double value_count = 0.0;
-			for (const auto& labels: values.second) value_count += static_cast<double>(labels.second);
-			double p = value_count / size;
+		for (size_t bin=0; bin<bin_size; bin++) {
+			if (value_counts[bin] == 0) continue;
+			double p = static_cast<double>(value_counts[bin]) / size;
+			intrinsic_information_of_split -= p * std::log2(p);
+		}
+		if (other_value_count > 0) {
+			double p = static_cast<double>(other_value_count) / size;
 			intrinsic_information_of_split -= p * std::log2(p);
 		}
 
@@ -453,16 +537,27 @@ protected:
 		// information_gain_ratio calculation completed,
 		// then, get rule.
 
-		// can get value distincts from value_label_count.
 		// it's sorted by string index, and iterates in the order of appearance.
-		for (const auto& distinct: value_label_count) {
-			size_t string_index = distinct.first;
+		for (size_t bin=0; bin<bin_size; bin++) {
+			if (value_counts[bin] == 0) continue;
+			size_t string_index = values[bin];
 			rule_t rule;
 			predicted_count_t predicted_count;
 			rule.feature_indexes  = {feature_index};			// rule feature index : feature_index
 			rule.type             = rule_t::rule_type::cmp_equ;	// rule type          : ==
 			rule.args             = {string_index};				// rule args          : string_index
-			predicted_count.count = distinct.second;
+			labels.to_map(&count[bin * label_size], predicted_count.count);
+			r.split_infos.emplace_back(split_info(rule, predicted_count));
+		}
+
+		// the `other` split info is the last.
+		if (other_value_count > 0) {
+			rule_t rule;
+			predicted_count_t predicted_count;
+			rule.feature_indexes  = {feature_index};				// rule feature index : feature_index
+			rule.type             = rule_t::rule_type::cmp_other;	// rule type          : none of the siblings
+			rule.args             = {std::numeric_limits<size_t>::max()};
+			labels.to_map(other_count.data(), predicted_count.count);
 			r.split_infos.emplace_back(split_info(rule, predicted_count));
 		}
 
@@ -470,49 +565,48 @@ protected:
 	}
 
 	// split the numeric feature into two.
-	static inline igr_result calc_igr_numeric_default_strategy(_in const dataset::dataset& train, _in const std::vector<size_t>& row_selections, _in size_t feature_index, _in double S) {
+	// the kernel of the data type is selected once per column.
+	static inline igr_result calc_igr_numeric_default_strategy(_in const dataset::dataset& train, _in const dense_label& labels, _in const row_range& row_selections, _in size_t feature_index, _in double S) {
+		const auto data_type = train.x.columns()[feature_index].data_type;
+		if (not common::is_numeric(data_type)) THROW_GAENARI_INTERNAL_ERROR0;
+		return kernel::dispatch_data_type(data_type, [&](auto t) {
+			return calc_igr_numeric_default_strategy<decltype(t)>(train, labels, row_selections, feature_index, S);
+		});
+	}
+
+	// T is the primitive type of the column(int, int64_t or double).
+	// values are compared as T, not type::value.
+	template <typename T>
+	static inline igr_result calc_igr_numeric_default_strategy(_in const dataset::dataset& train, _in const dense_label& labels, _in const row_range& row_selections, _in size_t feature_index, _in double S) {
 		igr_result r;
-		size_t index = 0;
-		size_t total_count = 0;
 		double current_entropy = 0.0;
 		double best_entropy = 0.0;
-		double split_value = 0.0;
-		size_t best_entropy_index = 0;
-		double p = 0.0;
-		type::value best_split_value;
-		std::map<type::value,std::map<size_t,size_t>> value_label_count;	// using value instead of value_obj, map sorting is supported.
-		std::map<rule_t::rule_type,std::map<size_t,size_t>> split;
-		std::map<rule_t::rule_type,std::map<size_t,size_t>> best_split;
-		std::map<size_t,size_t> acc, rest, total;
+		bool found = false;
+		T best_split_value{};
+		std::vector<std::pair<T,size_t>> value_labels;	// (value, dense label), sorted by value.
+		std::vector<size_t> acc, rest, total;
+		std::vector<size_t> best_acc, best_rest;
+		size_t acc_count = 0;
 
 		// short alias name
 		const auto& x = train.x;
-		const auto& y = train.y;
 		const auto& features = train.x.columns();
+		const size_t label_size = labels.size();
 
 		// initialize
-		double size = static_cast<double>(row_selections.size());
+		const size_t size = row_selections.size();
 
 		// get data type
 		auto data_type = features[feature_index].data_type;
 		if (not common::is_numeric(data_type)) THROW_GAENARI_INTERNAL_ERROR0;
+		if (size == 0) THROW_GAENARI_INTERNAL_ERROR0;
 
-		// sorting value and count label count.
-		for (const auto& row_index: row_selections) {
-			// memory can be mimized(50%) by calling get_raw(),
-			// but value was used because the key sort of std::map is guaranteed.
-			const auto& value = x.get_value(row_index, feature_index);
-			const auto& label = y.get_raw(row_index, 0).index;
+		// sorting value with label.
+		value_labels.reserve(size);
+		for (const auto& row_index: row_selections) value_labels.emplace_back(kernel::get<T>(x.get_raw(row_index, feature_index)), labels.get(row_index));
+		std::sort(value_labels.begin(), value_labels.end(), [](const auto& a, const auto& b) {return a.first < b.first;});
 
-			// (value,label) count for information gain calculation.
-			// [value] is sorted by std::map.
-			value_label_count
-				[value]	// each value
-				[label]	// each label
-				++;		// count increment
-		}
-
-		// value_label_count is like this.
+		// value_labels is like this.
 		// values(V1 ~ V4) are sorted.
 		// L1, L2 is label and the number is count.
 		// ---+------------------
@@ -527,21 +621,14 @@ protected:
 		// ---+------------------ => -----
 		// L1 |  1    0    1    1        3
 		// L2 |  0    1    0    0        1
-		for (const auto& count: value_label_count) {
-			for (const auto& label: count.second) {
-				total[label.first] += label.second;
-			}
-		}
+		total.resize(label_size, 0);
+		for (const auto& value_label: value_labels) total[value_label.second]++;
 
 		// find the index of the min entropy.
 		// ready.
-		best_entropy_index = 0;
 		rest = total;
+		acc.resize(label_size, 0);
 		best_entropy = std::numeric_limits<double>::max();
-		acc.clear();
-		best_split_value = value_label_count.begin()->first;
-		best_split = {};
-		index = 0;
 
 		// the entropy of each value is calculated by the accumulated label count.
 		//
@@ -555,27 +642,33 @@ protected:
 		// ---+-----------------------                            :
 		//    | V1      V2   V3   V4                              :
 		// ---+-----------------------                            :
-		for (const auto& split_point: value_label_count) { // <---'
-			// update acc, rest label count
-			for (const auto& label: split_point.second) {
-				acc[label.first]  += label.second;
-				rest[label.first] -= label.second;
+		size_t begin = 0;
+		while (begin < size) { // <-------------------------------'
+			// update acc, rest label count of the same values [begin, end).
+			const T split_point = value_labels[begin].first;
+			size_t end = begin;
+			for (; (end < size) and (value_labels[end].first == split_point); end++) {
+				acc [value_labels[end].second]++;
+				rest[value_labels[end].second]--;
 			}
+			acc_count += end - begin;
 
-			// set split information and get it's entropy.
-			split = {{rule_t::rule_type::cmp_lte, acc}, {rule_t::rule_type::cmp_gt, rest}};
-			current_entropy = calc_weighted_entropy_sum(split);
+			// get the entropy of split.
+			current_entropy = calc_weighted_entropy_sum(acc, acc_count, rest, size - acc_count);
 
-			if (current_entropy < best_entropy) {
+			if ((not found) or (current_entropy < best_entropy)) {
 				// found better split point.
+				found = true;
 				best_entropy = current_entropy;
-				best_entropy_index = index;
-				best_split = split;
-				best_split_value = split_point.first;
+				best_acc = acc;
+				best_rest = rest;
+				best_split_value = split_point;
 			}
-			index++;
+			begin = end;
 		}
 
+		if (not found) THROW_GAENARI_INTERNAL_ERROR0;
+
 		// calc information gain.
 		// the higher the information gain, the better division.
 		// if IG is 0, it means that there is no decrease in entropy by division.
@@ -589,23 +682,113 @@ protected:
 
 		// get rule.
 
-		// split is two.
-		if (2 != best_split.size()) THROW_GAENARI_INTERNAL_ERROR0;
-
 		// first split.
 		rule_t rule;
 		predicted_count_t predicted_count;
 		rule.feature_indexes  = {feature_index};				// rule feature index : feature_index
-		rule.type             = best_split.begin()->first;		// rule type          : < or <= (lt or lte)
-		rule.args	          = {best_split_value};				// rule args          : best split value
-		predicted_count.count = best_split.begin()->second;		// statistics
+		rule.type             = rule_t::rule_type::cmp_lte;		// rule type          : <=
+		rule.args	          = {kernel::to_value(best_split_value)};	// rule args          : best split value
+		labels.to_map(best_acc.data(), predicted_count.count);	// statistics
 		r.split_infos.emplace_back(split_info(rule, predicted_count));
 
 		// second split.
+		// the labels of the current node are kept even if its count is zero.
 		rule.feature_indexes  = {feature_index};				// rule feature index : feature_index
-		rule.type             = (++best_split.begin())->first;	// rule type          : > or >= (gt or gte)
-		rule.args	          = {best_split_value};				// rule args          : best split value
-		predicted_count.count = (++best_split.begin())->second;	// statistics
+		rule.type             = rule_t::rule_type::cmp_gt;		// rule type          : >
+		rule.args	          = {kernel::to_value(best_split_value)};	// rule args          : best split value
+		labels.to_map(best_rest.data(), predicted_count.count, total.data());	// statistics
+		r.split_infos.emplace_back(split_info(rule, predicted_count));
+
+		return r;
+	}
+
+	// split the numeric feature into two with bucketed values.
+	// same as calc_igr_numeric_default_strategy(...), but the split points are the bins of histogram.
+	// bins are scanned in ascending order, and the first minimum entropy is chosen.
+	static inline igr_result calc_igr_numeric_histogram_strategy(_in const dense_label& labels, _in const row_range& row_selections, _in size_t feature_index, _in double S, _in const histogram& histogram) {
+		// short alias name
+		const auto& column = histogram.columns[feature_index];
+		const size_t label_size = labels.size();
+		const size_t bin_size = column.uppers.size();
+
+		if ((not column.numeric) or (bin_size == 0) or (label_size == 0)) THROW_GAENARI_INTERNAL_ERROR0;
+
+		// dense (bin, label) count.
+		// ---+------------------    -----
+		//    | B1   B2   B3   B4    TOTAL
+		// ---+------------------ => -----
+		// L1 |  5    0    3    1        9
+		// L2 |  0    4    0    2        6
+		std::vector<size_t> count(bin_size * label_size, 0);
+		for (const auto& row_index: row_selections) count[column.bins[row_index] * label_size + labels.get(row_index)]++;
+
+		return calc_igr_numeric_bins(labels, feature_index, S, row_selections.size(), count.data(), column.uppers);
+	}
+
+	// same as calc_igr_numeric_histogram_strategy(...) with dense (bin, label) count.
+	// - count  : [bin * label_size + label] = count.
+	// - uppers : bin -> upper bound.
+	static inline igr_result calc_igr_numeric_bins(_in const dense_label& labels, _in size_t feature_index, _in double S, _in size_t size, _in const size_t* count, _in const std::vector<type::value>& uppers) {
+		igr_result r;
+		double best_entropy = std::numeric_limits<double>::max();
+		size_t best_bin = 0;
+		const size_t label_size = labels.size();
+		const size_t bin_size = uppers.size();
+		std::vector<size_t> acc(label_size, 0), rest(label_size, 0), total;
+		std::vector<size_t> best_acc, best_rest;
+
+		// total label count.
+		for (size_t bin=0; bin<bin_size; bin++) {
+			for (size_t label=0; label<label_size; label++) rest[label] += count[bin * label_size + label];
+		}
+		total = rest;
+
+		// scan bins with accumulated label count.
+		size_t acc_count  = 0;
+		for (size_t bin=0; bin<bin_size; bin++) {
+			const size_t* bin_count = &count[bin * label_size];
+
+			// skip the bin that does not appear in the current rows.
+			size_t bin_total = 0;
+			for (size_t label=0; label<label_size; label++) bin_total += bin_count[label];
+			if (bin_total == 0) continue;
+
+			// update acc, rest label count
+			for (size_t label=0; label<label_size; label++) {
+				acc[label]  += bin_count[label];
+				rest[label] -= bin_count[label];
+			}
+			acc_count += bin_total;
+
+			// weighted entropy sum of (<= split point) and (> split point).
+			double current_entropy = calc_weighted_entropy_sum(acc, acc_count, rest, size - acc_count);
+
+			if ((best_acc.empty()) or (current_entropy < best_entropy)) {
+				// found better split point.
+				best_entropy = current_entropy;
+				best_bin = bin;
+				best_acc = acc;
+				best_rest = rest;
+			}
+		}
+
+		if (best_acc.empty()) THROW_GAENARI_INTERNAL_ERROR0;
+
+		// information gain. (not divided by intrinsic information of split like default strategy.)
+		r.igr_value = S - best_entropy;
+
+		// first split.
+		rule_t rule;
+		predicted_count_t predicted_count;
+		rule.feature_indexes = {feature_index};					// rule feature index : feature_index
+		rule.type            = rule_t::rule_type::cmp_lte;		// rule type          : <=
+		rule.args            = {uppers[best_bin]};				// rule args          : upper bound of the best bin
+		labels.to_map(best_acc.data(), predicted_count.count);
+		r.split_infos.emplace_back(split_info(rule, predicted_count));
+
+		// second split.
+		rule.type            = rule_t::rule_type::cmp_gt;		// rule type          : >
+		labels.to_map(best_rest.data(), predicted_count.count, total.data());
 		r.split_infos.emplace_back(split_info(rule, predicted_count));
 
 		return r;
@@ -614,13 +797,19 @@ protected:
 	// information gain reference : https://planetcalc.com/8421/
 	//                              https://medium.datadriveninvestor.com/decision-tree-algorithm-with-hands-on-example-e6c2afb40d38
 	// information gain ratio     : https://www.ke.tu-darmstadt.de/lehre/archiv/ws0809/mldm/dt.pdf
-	static inline igr_result calc_igr_main(_in const dataset::dataset& train, _in const std::vector<size_t>& row_selections, _in size_t feature_index, _in double S, _in split_strategy split_strategy) {
+	static inline igr_result calc_igr_main(_in const dataset::dataset& train, _in const dense_label& labels, _in const row_range& row_selections, _in size_t feature_index, _in double S, _in split_strategy split_strategy, _in size_t nominal_min_support, _option_in const histogram* histogram = nullptr) {
 		double igr = 0.0;
 		auto data_type = train.x.columns()[feature_index].data_type;
 		
 		if (split_strategy == split_strategy::split_strategy_default) {
-			if (common::is_nominal(data_type))		return calc_igr_nominal_default_strategy(train, row_selections, feature_index, S);
-			else if (common::is_numeric(data_type))	return calc_igr_numeric_default_strategy(train, row_selections, feature_index, S);
+			if (common::is_nominal(data_type))		return calc_igr_nominal_default_strategy(train, labels, row_selections, feature_index, S, nominal_min_support);
+			else if (common::is_numeric(data_type))	return calc_igr_numeric_default_strategy(train, labels, row_selections, feature_index, S);
+		}
+
+		if (split_strategy == split_strategy::split_strategy_histogram) {
+			if (not histogram) THROW_GAENARI_INTERNAL_ERROR0;
+			if (common::is_nominal(data_type))		return calc_igr_nominal_default_strategy(train, labels, row_selections, feature_index, S, nominal_min_support);
+			else if (common::is_numeric(data_type))	return calc_igr_numeric_histogram_strategy(labels, row_selections, feature_index, S, *histogram);
 		}
 
 		THROW_GAENARI_INTERNAL_ERROR0;
@@ -0,0 +1,131 @@
+#ifndef HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_HISTOGRAM_HPP
+#define HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_HISTOGRAM_HPP
+
+namespace gaenari {
+namespace method {
+namespace decision_tree {
+
+// numeric feature histogram for split_strategy_histogram.
+//
+// every numeric column is bucketed only once before training.
+// after that, each tree node accumulates dense (bin, label) counts,
+// and scans the bins to find the best threshold.
+// so, the cost of a node is O(rows + bins * labels) without any map nodes.
+//
+// bin boundaries are always the actual values of the column.
+// the upper bound of a bin is the maximum value in the bin,
+// so the rule (value <= upper bound) selects exactly the rows of the bins [0, bin].
+// if the number of distinct values is not greater than max_bins, each distinct value has its own bin,
+// and the result is the same as split_strategy_default.
+//
+//        bin 0          bin 1          bin 2
+//   +--------------+--------------+--------------+
+//   | v0 v0 v1 v2  | v3 v4 v4 v5  | v6 v7 v8 v9  |   (sorted values, similar row count per bin)
+//   +--------------+--------------+--------------+
+//              upper=v2       upper=v5       upper=v9
+//
+// optionally, nominal columns are coded too.(level-wise training)
+// each distinct string index has its own bin in ascending order of string index.
+class histogram {
+public:
+	histogram()  = default;
+	~histogram() = default;
+
+public:
+	// bucketed numeric column.
+	struct column {
+		bool numeric = false;				// numeric column has bins.
+		bool nominal = false;				// nominal column has bins only when it's requested.
+		std::vector<uint32_t> bins;			// row index -> bin index.
+		std::vector<type::value> uppers;	// numeric only. bin index -> maximum value in the bin. (rule argument)
+		std::vector<size_t> values;			// nominal only. bin index -> string index.
+		inline size_t bin_count(void) const {return numeric ? uppers.size() : values.size();}
+	};
+
+public:
+	// build bins of all numeric features.
+	// - train    : dataset for training
+	// - max_bins : maximum bin count per numeric feature.
+	// - nominal  : [false] also code nominal features.
+	void build(_in const dataset::dataset& train, _in size_t max_bins, _in bool nominal = false);
+
+	// clear.
+	void clear(void);
+
+public:
+	// feature index -> column.
+	std::vector<column> columns;
+};
+
+// implementation.
+
+inline void histogram::build(_in const dataset::dataset& train, _in size_t max_bins, _in bool nominal) {
+	const auto& x = train.x;
+	const auto& features = x.columns();
+	const size_t rows = train.metadata.instance_count;
+	std::vector<size_t> order;
+
+	if ((max_bins < 2) or (max_bins > std::numeric_limits<uint32_t>::max())) THROW_GAENARI_INVALID_PARAMETER("invalid histogram max_bins.");
+
+	// clear.
+	clear();
+
+	// bucketing each numeric feature.
+	columns.resize(features.size());
+	order.resize(rows);
+	for (size_t feature_index=0; feature_index<features.size(); feature_index++) {
+		auto& column = columns[feature_index];
+		if (nominal and common::is_nominal(features[feature_index].data_type)) {
+			// string index -> bin in ascending order.
+			column.nominal = true;
+			column.bins.resize(rows);
+			for (size_t row_index=0; row_index<rows; row_index++) column.values.push_back(x.get_raw(row_index, feature_index).index);
+			std::sort(column.values.begin(), column.values.end());
+			column.values.erase(std::unique(column.values.begin(), column.values.end()), column.values.end());
+			if (column.values.size() > std::numeric_limits<uint32_t>::max()) THROW_GAENARI_ERROR("too many nominal values.");
+			for (size_t row_index=0; row_index<rows; row_index++) {
+				auto find = std::lower_bound(column.values.begin(), column.values.end(), x.get_raw(row_index, feature_index).index);
+				column.bins[row_index] = static_cast<uint32_t>(find - column.values.begin());
+			}
+			continue;
+		}
+		if (not common::is_numeric(features[feature_index].data_type)) continue;
+		column.numeric = true;
+		column.bins.resize(rows);
+		if (rows == 0) continue;
+
+		// get values once, and sort row indexes by value.
+		std::vector<type::value> values(rows);
+		for (size_t row_index=0; row_index<rows; row_index++) values[row_index] = x.get_value(row_index, feature_index);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&values](size_t a, size_t b) {return values[a] < values[b];});
+
+		// equal frequency bins.
+		// a bin is closed at the boundary of distinct values when the accumulated count reaches the next quantile.
+		// the quantile condition is `acc * max_bins >= (bin + 1) * rows`, so bin count never exceeds max_bins.
+		size_t acc = 0;
+		size_t begin = 0;
+		while (begin < rows) {
+			// [begin, end) has same value.
+			size_t end = begin + 1;
+			while ((end < rows) and (values[order[end]] == values[order[begin]])) end++;
+			for (size_t i=begin; i<end; i++) column.bins[order[i]] = static_cast<uint32_t>(column.uppers.size());
+			acc += end - begin;
+			if ((end == rows) or (acc * max_bins >= (column.uppers.size() + 1) * rows)) {
+				// close the bin with the current value as the upper bound.
+				column.uppers.push_back(values[order[begin]]);
+			}
+			begin = end;
+		}
+	}
+}
+
+inline void histogram::clear(void) {
+	columns.clear();
+}
+
+} // decision_tree
+} // method
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_HISTOGRAM_HPP
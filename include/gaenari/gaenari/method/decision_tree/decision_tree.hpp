@@ -15,11 +15,12 @@ public:
 public:
 	// train a decision tree.
 	// - train             : dataset for training
-	// - split_strategy    : [split_strategy_default] only default split strategy is supported.
+	// - split_strategy    : [split_strategy_default] split_strategy_default or split_strategy_histogram(bucketed numeric split).
 	// - min_instances     : [2.0] the minimum number of instances per split.
 	// - pruning_weight    : [1.2] pruning weight. more weight, more pruning. weight must be over than 1.0(=do not pruning).
 	// - early_stop_weight : [0.0] pre-pruning weight for early stop. more weight, more pruning. weight must be over than 0.0(=do not pruning).
-	void train(_in const dataset::dataset& train, _in split_strategy split_strategy=split_strategy::split_strategy_default, _in size_t min_instances=2.0, _in double pruning_weight=1.2, _in double early_stop_weight=0.0);
+	// - param             : [{}] additional train parameters. see train_param.
+	void train(_in const dataset::dataset& train, _in split_strategy split_strategy=split_strategy::split_strategy_default, _in size_t min_instances=2.0, _in double pruning_weight=1.2, _in double early_stop_weight=0.0, _in const train_param& param={});
 
 	// clear tree.
 	void clear(void);
@@ -40,6 +41,8 @@ public:
 	// 
 	// it's used for external data other than dataframe, such as json.
 	// if the given test data does not match the tree, max size_t is returend, and id = -1.
+	// a nominal string not in the string table goes to the `other` child(see train_param::nominal_min_support) like the other predict functions,
+	// or does not match the tree.
 	size_t predict(_in const std::map<std::string,std::string>& test, _option_out int* id = nullptr) const;
 
 	// predict with one row (feature name, value) map data.
@@ -48,6 +51,22 @@ public:
 	// value type is variant from dataframe row.
 	size_t predict(_in const std::map<std::string,std::variant<std::monostate,int,size_t,std::string,double,int64_t>>& test, _option_out int* id = nullptr) const;
 
+	// compile the trained tree to a flat node array for fast predict.
+	// call again after the tree is changed.
+	void compile(void);
+
+	// convert (feature name, value) map data to pre-typed row.
+	// row[feature index] is the value of the feature. (see compiled_tree.)
+	// the value of nominal feature is converted to the string index, and unknown string is max size_t.
+	// exception(feature not found) is raised if a feature is missing.
+	void get_typed_row(_in const std::map<std::string,std::string>& test, _out std::vector<type::value_raw>& row) const;
+
+	// predict with pre-typed row on the compiled tree.
+	// returns predicted label index and the leaf tree node id.
+	// the result is the same as the above predict functions.
+	// compile() is required.
+	size_t predict(_in const type::value_raw* row, _option_out int* id = nullptr) const;
+
 	// predict with multiple rows (feature name, value) map data.
 	// other than that, it is the same as the above function(size_t predict(_in const std::map<std::string,std::string>& test)).
 	std::vector<size_t> predict(_in const std::vector<std::map<std::string,std::string>>& tests) const;
@@ -58,6 +77,16 @@ public:
 	// but for a flexible structure, a dataframe containing a different vector strings from the training time is also available.
 	std::vector<size_t> predict(_in const dataset::dataframe& tests) const;
 
+	// predict with dataframe to the caller-provided buffer.
+	// cell values are read directly by column index without string conversion,
+	// and the nominal string index of the dataframe is converted to that of the tree once per string.
+	// - tests      : dataframe. the columns are matched by feature name.
+	// - predicteds : [out] predicted label index of each row. (tests.rows() items)
+	// - ids        : [out, optional] leaf tree node id of each row. (tests.rows() items)
+	// if a row does not match the tree(ex. unknown string), max size_t is predicted, and id = -1.
+	// the compiled tree is used, and if it's not compiled, it's compiled temporarily.
+	void predict(_in const dataset::dataframe& tests, _out size_t* predicteds, _option_out int* ids = nullptr) const;
+
 	// get the evaluation result of testset.
 	//
 	// T : `std::vector<std::map<std::string,std::string>>` or `dataset::dataframe`
@@ -73,6 +102,13 @@ public:
 	template <typename T=std::vector<std::map<std::string,std::string>>>
 	void eval(_in const T& tests, _out double& accuracy, _option_out std::map<size_t,std::map<size_t,size_t>>* confusion=nullptr, _option_out std::vector<size_t>* predicteds=nullptr, _option_out size_t* correct_count=nullptr) const;
 
+	// get the evaluation result of dataframe in parallel.
+	// rows are split to chunks, and each chunk is predicted and counted with its own dense confusion matrix.
+	// the matrices are merged at the end.
+	// the result is the same as eval(...), and confusion_matrix::to_map(...) makes the same map.
+	// - threads : [0] total thread count. 0 means std::thread::hardware_concurrency().
+	void eval_parallel(_in const dataset::dataframe& tests, _out double& accuracy, _option_out confusion_matrix* confusion=nullptr, _option_out std::vector<size_t>* predicteds=nullptr, _option_out size_t* correct_count=nullptr, _in size_t threads=0) const;
+
 	// converts the confusion matrix to a string.
 	// output format (similar to weka)
 	//
@@ -90,10 +126,45 @@ public:
 	// stringfy tree.
 	std::string stringfy(_in const std::string& mime_type="text/plain", _in bool show_treenode_id=false) const;
 
+	// generate a standalone c++ header of the tree. (see codegen::cpp(...))
+	// the generated predict(...) returns the same label and leaf tree node id as predict(...).
+	// - name_space : namespace of the generated code.
+	std::string to_cpp(_in const std::string& name_space="gaenari_predictor") const;
+
+	// write the tree to a binary tree file.
+	// the file is loaded by mapped_tree, and predicted without building the tree nodes. (see mapped_tree)
+	// the compiled tree is written, and if it's not compiled, it's compiled temporarily.
+	void write_binary(_in const std::string& path) const;
+
+protected:
+	// feature of the tree -> column of dataframe to predict.
+	struct column_binding {
+		size_t feature_index = 0;
+		size_t col = 0;
+		dataset::data_type_t from = dataset::data_type_t::data_type_unknown;	// dataframe column type.
+		dataset::data_type_t to   = dataset::data_type_t::data_type_unknown;	// tree feature type.
+	};
+
+	// returns this->compiled, or temp compiled from this->root if not compiled.
+	const compiled_tree& get_compiled(_in _out compiled_tree& temp) const;
+
+	// bind only the features used in the tree to the dataframe columns by name.
+	void bind_columns(_in const compiled_tree& tree, _in const dataset::dataframe& tests, _out std::vector<column_binding>& bindings) const;
+
+	// predict rows [begin, end) of dataframe.
+	// predicteds[0] is the result of row `begin`.
+	void predict_rows(_in const compiled_tree& tree, _in const std::vector<column_binding>& bindings, _in const dataset::dataframe& tests, _in size_t begin, _in size_t end, _out size_t* predicteds, _option_out int* ids) const;
+
 protected:
 	// decision tree root node
 	tree_node* root = nullptr;
 
+	// all tree nodes under this->root are allocated from here.
+	tree_node_pool node_pool;
+
+	// flat copy of this->root for fast predict. (built by compile())
+	compiled_tree compiled;
+
 	// meta data from dataset.
 	// these are related to trained this->root and training dataset.
 	// without these, some informations in this->root are dangling.
@@ -112,39 +183,64 @@ protected:
 
 // implementation.
 
-inline void decision_tree::train(_in const dataset::dataset& train, _in split_strategy split_strategy, _in size_t min_instances, _in double pruning_weight, _in double early_stop_weight) {
-	size_t index = 0;
+inline void decision_tree::train(_in const dataset::dataset& train, _in split_strategy split_strategy, _in size_t min_instances, _in double pruning_weight, _in double early_stop_weight, _in const train_param& param) {
 	int treenode_id = 0;
 	bool error = false;
-	std::vector<size_t> row_selections;	// row sampling
+	std::vector<size_t> row_buffer;		// row index buffer partitioned in place by splits. nodes have [begin, end) of it.
 	std::stack<stack_train_node> stack;	// internal stack (do not use recursive function call)
 	leaf_info_t _root_leaf_info;
+	dense_label labels;					// dense label remapping while training.
+	histogram histogram;				// bucketed numeric features (split_strategy_histogram only)
 
 	if (root) THROW_GAENARI_ERROR("already trained.");
 	if ((min_instances == 0) or (pruning_weight < 1.0) or (early_stop_weight < 0)) THROW_GAENARI_INVALID_PARAMETER("invalid train parameter.");
+	if ((split_strategy != split_strategy::split_strategy_default) and (split_strategy != split_strategy::split_strategy_histogram)) THROW_GAENARI_INVALID_PARAMETER("invalid split strategy.");
 	if (train.y.columns().size() != 1) THROW_GAENARI_ERROR("invalid dataset.");
+	if ((param.sample_min_rows > 0) and ((param.sample_rows == 0) or (param.sample_top_features == 0))) THROW_GAENARI_INVALID_PARAMETER("invalid sample parameter.");
+	if ((param.sample_min_rows > 0) and param.level_wise) THROW_GAENARI_INVALID_PARAMETER("sampled split search is not supported in level-wise training.");
+
+	// dense labels.
+	labels.build(train);
+
+	// bucketing numeric features once.
+	// level-wise training buckets nominal features too,
+	// and split_strategy_default has a bin for each distinct value.
+	if (param.level_wise) {
+		auto max_bins = (split_strategy == split_strategy::split_strategy_histogram) ? param.histogram_max_bins : std::numeric_limits<uint32_t>::max();
+		histogram.build(train, max_bins, true);
+	} else if (split_strategy == split_strategy::split_strategy_histogram) {
+		histogram.build(train, param.histogram_max_bins);
+	}
 
-	// first, full row selection (0, 1, 2, ..., instance count - 1)
-	row_selections.resize(train.metadata.instance_count);
-	std::iota(row_selections.begin(), row_selections.end(), 0);
-
-	// build root node and get classify information and label count
-	root = tree_node::build_root_node(treenode_id);
-	root->predicted_count.count = 
-		engine::get_leaf_info(train, row_selections, _root_leaf_info);
+	// thread pool for parallel feature evaluation.
+	common::thread_pool pool{param.threads};
 
-	// push the root node to stack with row selections matched.
-	stack.emplace(stack_train_node(*root, row_selections));
+	// budget, progress and cancellation.
+	train_monitor monitor{param.control};
 
-	for (;;) {
-		if (stack.empty()) break;
-		auto current = std::move(stack.top());	// get stack top and pop. (std::move is not affected yet. just hard-copy.)
-		stack.pop();
+	// first, full row selection (0, 1, 2, ..., instance count - 1)
+	row_buffer.resize(train.metadata.instance_count);
+	std::iota(row_buffer.begin(), row_buffer.end(), 0);
+	row_range row_selections{row_buffer.data(), row_buffer.data() + row_buffer.size()};
+
+	// build root node and get classify information and label count.
+	// rows are counted only here, the child nodes get their label counts from the split of the parent.
+	std::vector<size_t> root_label_count(labels.size(), 0);
+	labels.count(row_selections, root_label_count.data());
+	root = tree_node::build_root_node(treenode_id, &node_pool);
+	root->predicted_count.count = 
+		engine::get_leaf_info(labels, root_label_count.data(), _root_leaf_info);
 
-		// get split
-		auto split_infos = engine::split_tree(train, current.row_selections, split_strategy, min_instances);
+	// grow one node with its split infos.
+	// it becomes a leaf node(returns empty), or it is split and returns the child nodes.
+	auto grow = [&](_in _out tree_node& node, _in const size_t* label_count, _in _out std::vector<split_info>& split_infos, _in _out int& treenode_id) -> std::vector<tree_node*> {
 		std::reverse(split_infos.begin(), split_infos.end());
 
+		// the cmp_other child(grouped rare values) is always the last.
+		if ((not split_infos.empty()) and (split_infos.front().rule.type == rule_t::rule_type::cmp_other)) {
+			std::rotate(split_infos.begin(), split_infos.begin() + 1, split_infos.end());
+		}
+
 		// check early stop for pruning?
 		if (not split_infos.empty()) {
 			// check only non-leaf.
@@ -155,45 +251,139 @@ inline void decision_tree::train(_in const dataset::dataset& train, _in split_st
 			// split error rate * weight > parent error rate
 			// if err_childs * weight > err_current, do not split and turn to leaf node.
 			// if weight == 0.0, do not early stop.
-			if (engine::check_early_stop_for_pruning(current.node, split_infos, early_stop_weight)) {
+			if (engine::check_early_stop_for_pruning(node, split_infos, early_stop_weight)) {
 				// do early stop
 				split_infos.clear();
 			}
 		}
 
+		// the childs are over the node budget, do not split.
+		if ((not split_infos.empty()) and (not monitor.add_nodes(split_infos.size()))) split_infos.clear();
+
 		if (split_infos.empty()) {
 			// stop criteria, it's leaf node.
-			current.node.leaf = true;
+			node.leaf = true;
 
 			// get classify information and label count
-			current.node.predicted_count.count = 
-				engine::get_leaf_info(train, current.row_selections, current.node.leaf_info);
+			node.predicted_count.count = 
+				engine::get_leaf_info(labels, label_count, node.leaf_info);
 
 			// skip child processing
-			continue;
+			return {};
 		}
 
 		// do split
-		auto childs = tree_node::build_child_nodes(current.node, split_infos.size(), treenode_id);
+		auto childs = tree_node::build_child_nodes(node, split_infos.size(), treenode_id);
 		if (childs.empty()) THROW_GAENARI_ERROR("empty build_child_nodes.");
 
 		// child loop
-		index = 0;
+		size_t index = 0;
 		for (auto* child: childs) {
 			// copy split info to tree node.
 			child->rule            = std::move(split_infos[index].rule); // (std::move is not affected yet. just hard-copy.)
 			child->predicted_count = std::move(split_infos[index].predicted_count);
+			index++;
+		}
+		return childs;
+	};
 
-			// get matched new row indexes from current old row indexes
-			auto new_matched_indexes = util::get_matched_row_selections(train, child->rule, current.row_selections);
+	// expand one node.
+	// it becomes a leaf node, or it is split and returns the child nodes with matched row selections.
+	auto expand = [&](_in _out stack_train_node& current, _in _out int& treenode_id) -> std::vector<stack_train_node> {
+		std::vector<stack_train_node> ret;
 
-			// stack push the child to stack with row selections matched.
-			stack.emplace(stack_train_node(*child, new_matched_indexes));
+		// get split
+		// large nodes evaluate features in parallel.
+		// very large nodes search the split on a sample.
+		// the training is stopped, do not split. (it becomes a leaf node)
+		// with feature subspace, only the random subset of the features is evaluated.
+		std::vector<split_info> split_infos;
+		auto* feature_pool = (current.row_selections.size() >= param.parallel_feature_min_rows) ? &pool : nullptr;
+		if (not monitor.expand(current.node, current.row_selections.size())) {
+			const auto subspace = util::get_feature_subspace(current.node, train.x.columns().size(), param.feature_subspace, param.feature_subspace_seed);
+			const auto* features = subspace.empty() ? nullptr : &subspace;
+			split_infos = ((param.sample_min_rows > 0) and (current.row_selections.size() >= param.sample_min_rows)) ?
+				engine::split_tree_sampled(train, labels, current.row_selections, current.label_count.data(), split_strategy, min_instances, param.nominal_min_support, param.sample_rows, param.sample_top_features, &histogram, feature_pool, features) :
+				engine::split_tree(train, labels, current.row_selections, current.label_count.data(), split_strategy, min_instances, param.nominal_min_support, &histogram, feature_pool, features);
+		}
+		auto childs = grow(current.node, current.label_count.data(), split_infos, treenode_id);
+		if (childs.empty()) return ret;
+
+		// partition the current rows in place, and get the matched rows of each child.
+		std::vector<row_range> ranges;
+		util::partition_row_range(train, childs, current.row_selections, ranges);
+
+		// the childs with row selections matched.
+		// the label count of a child is the predicted count of its split. (no row scan)
+		ret.reserve(childs.size());
+		for (size_t index=0; index<childs.size(); index++) {
+			std::vector<size_t> label_count(labels.size(), 0);
+			labels.from_map(childs[index]->predicted_count.count, label_count.data());
+			ret.emplace_back(stack_train_node(*childs[index], ranges[index], std::move(label_count)));
+		}
+		return ret;
+	};
+
+	// build the subtree in the thread pool. (parallel subtree only)
+	// the task builds its subtree with its own stack,
+	// and large child subtrees are handed over to the pool, so idle threads can steal them.
+	// tree node ids of subtrees are temporary, and renumbered after all tasks are finished.
+	// train_subtree is declared before the group, the group waits for the tasks referring to it
+	// before it's destroyed, even if an exception is raised before group.wait().
+	std::function<void(stack_train_node&)> train_subtree;
+	common::task_group group{pool};
+	const bool parallel_subtree = (pool.size() > 1) and (param.parallel_subtree_rows > 0);
+	train_subtree = [&](stack_train_node& top) {
+		// smaller subtrees than this are not handed over. (task overhead)
+		constexpr size_t steal_min_rows = 256;
+		int temporary_id = 0;
+		std::stack<stack_train_node> local_stack;
+		local_stack.emplace(std::move(top));
+		for (;;) {
+			if (local_stack.empty()) break;
+			auto current = std::move(local_stack.top());
+			local_stack.pop();
+			for (auto& child: expand(current, temporary_id)) {
+				if (child.row_selections.size() >= steal_min_rows) group.run([&train_subtree, child]() mutable {train_subtree(child);});
+				else local_stack.emplace(std::move(child));
+			}
+		}
+	};
+
+	if (param.level_wise) {
+		// build depth by depth. the stack is not used.
+		level_wise::train(train, labels, histogram, pool, param, min_instances, *root, std::move(root_label_count), [&](tree_node& node, const size_t* label_count, std::vector<split_info>& split_infos) {
+			size_t rows = 0;
+			for (size_t i=0; i<labels.size(); i++) rows += label_count[i];
+			if (monitor.expand(node, rows)) split_infos.clear();
+			return grow(node, label_count, split_infos, treenode_id);
+		}, [&]() {return monitor.stopped();});
+	} else {
+		// push the root node to stack with row selections matched.
+		stack.emplace(stack_train_node(*root, row_selections, std::move(root_label_count)));
+	}
 
-			index++;
+	for (;;) {
+		if (stack.empty()) break;
+		auto current = std::move(stack.top());	// get stack top and pop. (std::move is not affected yet. just hard-copy.)
+		stack.pop();
+
+		// small enough, build the subtree concurrently.
+		if (parallel_subtree and (current.row_selections.size() < param.parallel_subtree_rows)) {
+			group.run([&train_subtree, current]() mutable {train_subtree(current);});
+			continue;
 		}
+
+		// expand and stack push the childs.
+		for (auto& child: expand(current, treenode_id)) stack.emplace(std::move(child));
 	}
 
+	// wait for all subtrees.
+	group.wait();
+
+	// the tree node ids are the same as the single thread training.
+	if (parallel_subtree or param.level_wise) tree_node::renumber_ids(*root);
+
 	// get meta data
 	// remark)
 	//   - string table size is big, so decision tree's string table is reference of dataframe.
@@ -211,20 +401,23 @@ inline void decision_tree::train(_in const dataset::dataset& train, _in split_st
 	y_name = train.y.columns()[0].name;
 	util::get_label_values(root, label_values);
 
-	// post-processing
-	for (;;) {
-		// post-processing continues until there is no change.
-		auto pruned   = engine::post_pruning(*root, pruning_weight);
-		auto combined = engine::combine_same_label(*root);
-		if (not pruned and not combined) break;
-	}
+	// post-processing(pruning and combining same label).
+	engine::post_processing(*root, pruning_weight);
+
+	// child index of the nominal splits with many childs for predict.
+	tree_node::build_nominal_index(*root);
+
+	// report the last progress.
+	monitor.finish();
 
 	return;
 }
 
 inline void decision_tree::clear(void) {
 	if (not root) return;
-	root->destroy_all_child_node(true);
+	// release all nodes at once. (no traversal)
+	node_pool.clear();
+	compiled.clear();
 	root = nullptr;
 }
 
@@ -252,6 +445,14 @@ inline size_t decision_tree::predict(_in const std::map<std::string,std::variant
 			break;
 		}
 		matched = false;
+		// nominal split with many childs, find the child by the string index.
+		size_t string_index = 0;
+		if ((not current->nominal_index.empty()) and util::get_nominal_index(test, current->childs[0]->rule, strings, columns, string_index)) {
+			const auto child = current->find_nominal_child(string_index);
+			if (not child) return std::numeric_limits<size_t>::max();
+			current = child;
+			continue;
+		}
 		// which child is matched?
 		for (const auto child: current->childs) {
 			if (util::is_match_type_1(test, child->rule, strings, columns)) {
@@ -284,6 +485,14 @@ inline size_t decision_tree::predict(_in const std::map<std::string,std::string>
 			break;
 		}
 		matched = false;
+		// nominal split with many childs, find the child by the string index.
+		size_t string_index = 0;
+		if ((not current->nominal_index.empty()) and util::get_nominal_index(test, current->childs[0]->rule, strings, columns, string_index)) {
+			const auto child = current->find_nominal_child(string_index);
+			if (not child) return std::numeric_limits<size_t>::max();
+			current = child;
+			continue;
+		}
 		// which child is matched?
 		for (const auto child: current->childs) {
 			if (util::is_match_type_1(test, child->rule, strings, columns)) {
@@ -302,6 +511,21 @@ inline size_t decision_tree::predict(_in const std::map<std::string,std::string>
 	return current->leaf_info.label_string_index;
 }
 
+inline void decision_tree::compile(void) {
+	if (not root) THROW_GAENARI_ERROR("tree is not built.");
+	compiled.build(*root);
+}
+
+inline void decision_tree::get_typed_row(_in const std::map<std::string,std::string>& test, _out std::vector<type::value_raw>& row) const {
+	if (not root) THROW_GAENARI_ERROR("tree is not built.");
+	util::get_typed_row(test, columns, [this](_in const std::string& s) {return strings.get_id_size_t(s);}, row);
+}
+
+inline size_t decision_tree::predict(_in const type::value_raw* row, _option_out int* id/*=nullptr*/) const {
+	if (not root) THROW_GAENARI_ERROR("tree is not built.");
+	return compiled.predict(row, id);
+}
+
 inline std::vector<size_t> decision_tree::predict(_in const std::vector<std::map<std::string,std::string>>& tests) const {
 	std::vector<size_t> ret;
 
@@ -324,25 +548,93 @@ inline std::vector<size_t> decision_tree::predict(_in const std::vector<std::map
 }
 
 inline std::vector<size_t> decision_tree::predict(_in const dataset::dataframe& tests) const {
-	std::map<std::string,std::string> map_data;
-	std::string empty_string = "";
-	const auto& columns = tests.columns();
-	std::vector<size_t> ret;
+	std::vector<size_t> ret(tests.rows());
+	predict(tests, ret.data());
+	return ret;
+}
 
-	// every row in dataframe.
-	for (const auto& row: tests.iter_string()) {
-		// every column in row.
-		size_t index = 0;
-		for (const auto& value: row.values) {
-			map_data[columns[index].name] = value;
-			index++;
+inline void decision_tree::predict(_in const dataset::dataframe& tests, _out size_t* predicteds, _option_out int* ids/*=nullptr*/) const {
+	std::vector<column_binding> bindings;
+
+	if (not root) THROW_GAENARI_ERROR("tree is not built.");
+
+	// use the compiled tree.
+	compiled_tree temp;
+	const compiled_tree& tree = get_compiled(temp);
+
+	// predict all rows.
+	bind_columns(tree, tests, bindings);
+	predict_rows(tree, bindings, tests, 0, tests.rows(), predicteds, ids);
+}
+
+inline const compiled_tree& decision_tree::get_compiled(_in _out compiled_tree& temp) const {
+	if (not compiled.empty()) return compiled;
+	temp.build(*root);
+	return temp;
+}
+
+inline void decision_tree::bind_columns(_in const compiled_tree& tree, _in const dataset::dataframe& tests, _out std::vector<column_binding>& bindings) const {
+	// clear output.
+	bindings.clear();
+
+	// only the features used in the tree are read.
+	std::vector<bool> used(columns.size(), false);
+	for (size_t i=1; i<tree.nodes.size(); i++) used[tree.nodes[i].feature_index] = true;
+
+	// feature -> dataframe column.
+	const auto& test_columns = tests.columns();
+	for (size_t feature_index=0; feature_index<columns.size(); feature_index++) {
+		if (not used[feature_index]) continue;
+		const auto& column = columns[feature_index];
+		column_binding binding;
+		binding.feature_index = feature_index;
+		binding.to = column.data_type;
+		bool found = false;
+		for (size_t col=0; col<test_columns.size(); col++) {
+			if (test_columns[col].name != column.name) continue;
+			binding.col  = col;
+			binding.from = test_columns[col].data_type;
+			found = true;
+			break;
 		}
-		// predict
-		auto label = predict(map_data);
-		ret.push_back(label);
+		if (not found) THROW_GAENARI_FEATURE_NOT_FOUND("feature not found:" + column.name);
+		if (common::is_nominal(binding.from) != common::is_nominal(binding.to)) THROW_GAENARI_ERROR("invalid data type.");
+		bindings.push_back(binding);
 	}
+}
 
-	return ret;
+inline void decision_tree::predict_rows(_in const compiled_tree& tree, _in const std::vector<column_binding>& bindings, _in const dataset::dataframe& tests, _in size_t begin, _in size_t end, _out size_t* predicteds, _option_out int* ids) const {
+	using data_type_t = dataset::data_type_t;
+
+	// nominal string index of dataframe -> string index of tree.
+	util::string_index_map index_map{tests.get_shared_data_const().strings, strings};
+
+	// every row in [begin, end).
+	std::vector<type::value_raw> row(columns.size());
+	for (auto& value: row) value.index = 0;
+	for (size_t row_index=begin; row_index<end; row_index++) {
+		// pre-typed row.
+		for (const auto& binding: bindings) {
+			const auto& v = tests.get_raw(row_index, binding.col);
+			auto& value = row[binding.feature_index];
+			if (common::is_nominal(binding.to)) {
+				value.index = index_map.get(v.index);
+			} else if (binding.from == binding.to) {
+				value = v;
+			} else {
+				// different numeric type.
+				double d = 0.0;
+				if      (binding.from == data_type_t::data_type_int)   d = static_cast<double>(v.numeric_int32);
+				else if (binding.from == data_type_t::data_type_int64) d = static_cast<double>(v.numeric_int64);
+				else                                                   d = v.numeric_double;
+				if      (binding.to == data_type_t::data_type_int)     value.numeric_int32  = static_cast<int>(d);
+				else if (binding.to == data_type_t::data_type_int64)   value.numeric_int64  = static_cast<int64_t>(d);
+				else                                                   value.numeric_double = d;
+			}
+		}
+		// predict.
+		predicteds[row_index - begin] = tree.predict(row.data(), ids ? ids + (row_index - begin) : nullptr);
+	}
 }
 
 template <typename T>
@@ -350,12 +642,9 @@ inline void decision_tree::eval(_in const T& tests, _out double& accuracy, _opti
 	constexpr size_t unknown = std::numeric_limits<size_t>::max();
 	std::vector<size_t> _predicteds;
 	std::vector<size_t> _actuals;
+	confusion_matrix matrix;
 	if (not predicteds) predicteds = &_predicteds;
 
-	// add size_t max to label value. this is a space for an unknown label.
-	auto _label_values = label_values;
-	_label_values.push_back(unknown);
-
 	// clear output
 	if (confusion) confusion->clear();
 	predicteds->clear();
@@ -363,15 +652,8 @@ inline void decision_tree::eval(_in const T& tests, _out double& accuracy, _opti
 
 	if (not root) THROW_GAENARI_ERROR("tree is not built.");
 
-	// because it may not be displayed if the number of items,
-	// set label value items in the confusion matrix in advance.
-	if (confusion) {
-		for (const auto& actual: _label_values) {
-			for (const auto& predicted: _label_values) {
-				(*confusion)[actual][predicted] = 0;
-			}
-		}
-	}
+	// label values and unknown.
+	matrix.init(label_values);
 
 	// get predicted.
 	*predicteds = predict(tests);
@@ -394,7 +676,7 @@ inline void decision_tree::eval(_in const T& tests, _out double& accuracy, _opti
 			count_without_unknown++;
 			if (_actuals[i] != (*predicteds)[i]) incorrect_without_unknown++;
 		}
-		if (confusion) (*confusion)[_actuals[i]][(*predicteds)[i]]++;
+		if (confusion) matrix.add(matrix.add_label(_actuals[i]), matrix.add_label((*predicteds)[i]));
 	}
 
 	// accuracy excludes unknown.
@@ -408,17 +690,105 @@ inline void decision_tree::eval(_in const T& tests, _out double& accuracy, _opti
 		*correct_count = count_without_unknown - incorrect_without_unknown;
 	}
 
-	// remove unneccessay `unknown`
-	// 1) if all unknown rows are 0, remove.
-	// 2) if all unknown cols are 0, remove.
-	if (confusion) {
-		auto found = true;
-		for (const auto col: (*confusion)[unknown]) if (col.second != 0) found = false;
-		if (found) (*confusion).erase(unknown);
-		found = true;
-		for (auto& row: (*confusion)) if (row.second[unknown] != 0) found = false;
-		if (found) for (auto& row: (*confusion)) row.second.erase(unknown);
+	// to map.
+	if (confusion) matrix.to_map(*confusion);
+}
+
+inline void decision_tree::eval_parallel(_in const dataset::dataframe& tests, _out double& accuracy, _option_out confusion_matrix* confusion, _option_out std::vector<size_t>* predicteds, _option_out size_t* correct_count, _in size_t threads) const {
+	constexpr size_t unknown = std::numeric_limits<size_t>::max();
+	constexpr size_t min_chunk_rows = 4096;
+	std::vector<size_t> _predicteds;
+	std::vector<size_t> actuals;
+	std::vector<column_binding> bindings;
+	confusion_matrix matrix;
+	if (not predicteds) predicteds = &_predicteds;
+
+	// clear output
+	predicteds->clear();
+	accuracy = 0.0;
+
+	if (not root) THROW_GAENARI_ERROR("tree is not built.");
+
+	// use the compiled tree.
+	compiled_tree temp;
+	const compiled_tree& tree = get_compiled(temp);
+	bind_columns(tree, tests, bindings);
+
+	// get actual label values.
+	util::get_actual_label_index(tests, y_name, strings, actuals);
+	const size_t rows = actuals.size();
+	predicteds->resize(rows);
+
+	// label string index -> dense index of the matrix.
+	// labels only in the test data are added first, so all chunks share the same labels.
+	// (predicted labels are always in label values or unknown.)
+	matrix.init(label_values);
+	std::vector<size_t> dense(static_cast<size_t>(strings.get_last_id() + 1), unknown);
+	for (size_t i=0; i<matrix.labels.size(); i++) if (matrix.labels[i] < dense.size()) dense[matrix.labels[i]] = i;
+	const size_t unknown_index = matrix.index(unknown);
+	for (auto& actual: actuals) {
+		if (actual >= dense.size()) continue;
+		if (dense[actual] == unknown) dense[actual] = matrix.add_label(actual);
+	}
+	auto to_dense = [&dense, unknown_index](size_t label) -> size_t {
+		if (label >= dense.size()) return unknown_index;
+		return dense[label];
+	};
+
+	// split rows to chunks.
+	common::thread_pool pool{threads};
+	const size_t chunk_rows  = std::max(min_chunk_rows, (rows + pool.size() * 4 - 1) / (pool.size() * 4));
+	const size_t chunk_count = (rows + chunk_rows - 1) / chunk_rows;
+
+	// each chunk has its own dense matrix and counts.
+	struct chunk_t {
+		confusion_matrix matrix;
+		size_t count_without_unknown = 0;
+		size_t incorrect_without_unknown = 0;
+	};
+	std::vector<chunk_t> chunks(chunk_count);
+	pool.parallel_for(chunk_count, [&](size_t chunk_index) {
+		auto& chunk = chunks[chunk_index];
+		const size_t begin = chunk_index * chunk_rows;
+		const size_t end   = std::min(rows, begin + chunk_rows);
+		chunk.matrix.labels     = matrix.labels;
+		chunk.matrix.base_count = matrix.base_count;
+		chunk.matrix.counts.assign(matrix.counts.size(), 0);
+		predict_rows(tree, bindings, tests, begin, end, predicteds->data() + begin, nullptr);
+		for (size_t i=begin; i<end; i++) {
+			const auto actual    = actuals[i];
+			const auto predicted = (*predicteds)[i];
+			// except unknown
+			if (not ((actual == unknown) or (predicted == unknown))) {
+				chunk.count_without_unknown++;
+				if (actual != predicted) chunk.incorrect_without_unknown++;
+			}
+			chunk.matrix.add(to_dense(actual), to_dense(predicted));
+		}
+	});
+
+	// merge.
+	size_t count_without_unknown     = 0;
+	size_t incorrect_without_unknown = 0;
+	for (const auto& chunk: chunks) {
+		count_without_unknown     += chunk.count_without_unknown;
+		incorrect_without_unknown += chunk.incorrect_without_unknown;
+		matrix.merge(chunk.matrix);
+	}
+
+	// accuracy excludes unknown.
+	if (count_without_unknown != 0) {
+		accuracy = 1.0 - (static_cast<double>(incorrect_without_unknown) / static_cast<double>(count_without_unknown));
+	}
+
+	// set correct_count.
+	if (correct_count) {
+		if (incorrect_without_unknown > count_without_unknown) THROW_GAENARI_INTERNAL_ERROR0;
+		*correct_count = count_without_unknown - incorrect_without_unknown;
 	}
+
+	// set confusion.
+	if (confusion) *confusion = std::move(matrix);
 }
 
 inline std::string decision_tree::to_string_confusion_matrix(_in const std::map<size_t,std::map<size_t,size_t>>& confusion, _in const std::string& type) const {
@@ -436,6 +806,17 @@ inline std::string decision_tree::stringfy(_in const std::string& mime_type, _in
 	return method::stringfy::tree(*root, columns, strings, mime_type, show_treenode_id);
 }
 
+inline std::string decision_tree::to_cpp(_in const std::string& name_space) const {
+	if (not root) THROW_GAENARI_ERROR("tree is not built.");
+	return codegen::cpp(*root, columns, strings, name_space);
+}
+
+inline void decision_tree::write_binary(_in const std::string& path) const {
+	if (not root) THROW_GAENARI_ERROR("tree is not built.");
+	compiled_tree temp;
+	mapped_tree::write(path, get_compiled(temp), columns, strings, y_name);
+}
+
 } // decision_tree
 } // method
 } // gaenari
@@ -0,0 +1,158 @@
+#ifndef HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_KERNEL_HPP
+#define HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_KERNEL_HPP
+
+namespace gaenari {
+namespace method {
+namespace decision_tree {
+namespace kernel {
+
+// compile-time specialized comparison kernels.
+//
+// type::value compares its type on every call, and the rule type is switched on every row.
+// the kernels are instantiated for each (primitive type, rule type),
+// so the type and the operator are selected only once per column or per rule,
+// and the hot loop just compares the field of type::value_raw.
+//
+//   primitive type | value_raw field | data type                                | value type
+//   ---------------+-----------------+------------------------------------------+-------------------
+//   int            | numeric_int32   | data_type_int                            | value_type_int
+//   int64_t        | numeric_int64   | data_type_int64                          | value_type_int64
+//   double         | numeric_double  | data_type_double                         | value_type_double
+//   size_t         | index           | data_type_string, data_type_string_table | value_type_size_t
+//
+// ex)
+// kernel::dispatch(rule, [&](auto match) {
+//		for (auto row_index: rows) if (match(x.get_raw(row_index, feature_index))) ...;
+// });
+
+// get the field of value_raw.
+template <typename T> inline T get(_in const type::value_raw& v);
+template <> inline int     get<int>    (_in const type::value_raw& v) {return v.numeric_int32;}
+template <> inline int64_t get<int64_t>(_in const type::value_raw& v) {return v.numeric_int64;}
+template <> inline double  get<double> (_in const type::value_raw& v) {return v.numeric_double;}
+template <> inline size_t  get<size_t> (_in const type::value_raw& v) {return v.index;}
+
+// set the field of value_raw.
+template <typename T> inline void set(_out type::value_raw& r, _in T v);
+template <> inline void set<int>    (_out type::value_raw& r, _in int     v) {r.numeric_int32  = v;}
+template <> inline void set<int64_t>(_out type::value_raw& r, _in int64_t v) {r.numeric_int64  = v;}
+template <> inline void set<double> (_out type::value_raw& r, _in double  v) {r.numeric_double = v;}
+template <> inline void set<size_t> (_out type::value_raw& r, _in size_t  v) {r.index          = v;}
+
+// to type::value.
+// unused upper bytes are zero like dataframe, so type::value::operator== works.
+template <typename T>
+inline type::value to_value(_in T v) {
+	type::value_raw raw;
+	raw.index = 0;
+	set<T>(raw, v);
+	return type::value(raw, type::value(v).valueype);
+}
+
+// `feature_value OPERATOR arg` of the rule type.
+template <rule_t::rule_type op, typename T>
+inline bool compare(_in T feature_value, _in T arg) {
+	if constexpr (op == rule_t::rule_type::cmp_equ) return feature_value == arg;
+	if constexpr (op == rule_t::rule_type::cmp_lte) return feature_value <= arg;
+	if constexpr (op == rule_t::rule_type::cmp_lt)  return feature_value <  arg;
+	if constexpr (op == rule_t::rule_type::cmp_gt)  return feature_value >  arg;
+	if constexpr (op == rule_t::rule_type::cmp_gte) return feature_value >= arg;
+	if constexpr (op == rule_t::rule_type::cmp_other) return true;	// the last child, no sibling is matched.
+	return false;
+}
+
+// compare with raw values.
+template <rule_t::rule_type op, typename T>
+inline bool match_raw(_in const type::value_raw& feature_value, _in const type::value_raw& arg) {
+	return compare<op>(get<T>(feature_value), get<T>(arg));
+}
+
+// call fn(T{}) with the primitive type of the column data type.
+template <typename fn_t>
+inline decltype(auto) dispatch_data_type(_in dataset::data_type_t data_type, _in fn_t&& fn) {
+	switch (data_type) {
+		case dataset::data_type_t::data_type_int:			return fn(int{});
+		case dataset::data_type_t::data_type_int64:			return fn(int64_t{});
+		case dataset::data_type_t::data_type_double:		return fn(double{});
+		case dataset::data_type_t::data_type_string:
+		case dataset::data_type_t::data_type_string_table:	return fn(size_t{});
+		default: break;
+	}
+	THROW_GAENARI_ERROR("invalid data type.");
+}
+
+// call fn(T{}) with the primitive type of the value type.
+template <typename fn_t>
+inline decltype(auto) dispatch_value_type(_in type::value_type value_type, _in fn_t&& fn) {
+	switch (value_type) {
+		case type::value_type::value_type_int:		return fn(int{});
+		case type::value_type::value_type_int64:	return fn(int64_t{});
+		case type::value_type::value_type_double:	return fn(double{});
+		case type::value_type::value_type_size_t:	return fn(size_t{});
+		default: break;
+	}
+	THROW_GAENARI_ERROR("invalid value type.");
+}
+
+// call fn(std::integral_constant<rule_t::rule_type, op>{}) with the rule type.
+template <typename fn_t>
+inline decltype(auto) dispatch_rule_type(_in rule_t::rule_type rule_type, _in fn_t&& fn) {
+	using rt = rule_t::rule_type;
+	switch (rule_type) {
+		case rt::cmp_equ: return fn(std::integral_constant<rt, rt::cmp_equ>{});
+		case rt::cmp_lte: return fn(std::integral_constant<rt, rt::cmp_lte>{});
+		case rt::cmp_lt:  return fn(std::integral_constant<rt, rt::cmp_lt>{});
+		case rt::cmp_gt:  return fn(std::integral_constant<rt, rt::cmp_gt>{});
+		case rt::cmp_gte: return fn(std::integral_constant<rt, rt::cmp_gte>{});
+		case rt::cmp_other: return fn(std::integral_constant<rt, rt::cmp_other>{});
+		default: break;
+	}
+	THROW_GAENARI_ERROR("not supported rule type.");
+}
+
+// select the kernel of the type 1 rule(`feature value OPERATOR args[0]`) once,
+// and call fn(match). match(const type::value_raw& feature_value) returns bool.
+template <typename fn_t>
+inline decltype(auto) dispatch(_in const rule_t& rule, _in fn_t&& fn) {
+	if (rule.args.empty()) THROW_GAENARI_ERROR("not supported rule.");
+	const auto& arg = rule.args[0];
+	return dispatch_value_type(arg.valueype, [&](auto t) -> decltype(auto) {
+		using T = decltype(t);
+		const T value = get<T>(arg);
+		return dispatch_rule_type(rule.type, [&](auto op) -> decltype(auto) {
+			return fn([value](_in const type::value_raw& feature_value) {return compare<decltype(op)::value>(get<T>(feature_value), value);});
+		});
+	});
+}
+
+// match function of the pre-typed rule. (ex: compiled_tree::node)
+// match_table[value_type][rule_type](feature_value, arg).
+// it's selected when the rule is compiled, and the hot loop just calls it without any type check.
+using match_fn = bool(*)(_in const type::value_raw& feature_value, _in const type::value_raw& arg);
+
+inline bool match_none(_in const type::value_raw&, _in const type::value_raw&) {return false;}
+
+#define GAENARI_KERNEL_MATCH_ROW(T) {match_none, match_raw<rule_t::rule_type::cmp_equ,T>, match_raw<rule_t::rule_type::cmp_lte,T>, match_raw<rule_t::rule_type::cmp_lt,T>, match_raw<rule_t::rule_type::cmp_gt,T>, match_raw<rule_t::rule_type::cmp_gte,T>, match_raw<rule_t::rule_type::cmp_other,T>}
+inline constexpr match_fn match_table[5][7] = {
+	{match_none, match_none, match_none, match_none, match_none, match_none, match_none},	// value_type_unknown
+	GAENARI_KERNEL_MATCH_ROW(int),												// value_type_int
+	GAENARI_KERNEL_MATCH_ROW(int64_t),											// value_type_int64
+	GAENARI_KERNEL_MATCH_ROW(double),											// value_type_double
+	GAENARI_KERNEL_MATCH_ROW(size_t),											// value_type_size_t
+};
+#undef GAENARI_KERNEL_MATCH_ROW
+
+// get the match function of the type 1 rule.
+inline match_fn get_match_fn(_in const rule_t& rule) {
+	if ((rule.feature_indexes.size() != 1) or (rule.args.size() != 1)) THROW_GAENARI_ERROR("not supported rule.");
+	if ((rule.type == rule_t::rule_type::unknown) or (rule.type > rule_t::rule_type::cmp_other)) THROW_GAENARI_ERROR("not supported rule type.");
+	if ((rule.args[0].valueype == type::value_type::value_type_unknown) or (rule.args[0].valueype > type::value_type::value_type_size_t)) THROW_GAENARI_ERROR("invalid value type.");
+	return match_table[static_cast<size_t>(rule.args[0].valueype)][static_cast<size_t>(rule.type)];
+}
+
+} // kernel
+} // decision_tree
+} // method
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_KERNEL_HPP
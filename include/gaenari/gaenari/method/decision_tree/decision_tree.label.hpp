@@ -0,0 +1,101 @@
+#ifndef HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_LABEL_HPP
+#define HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_LABEL_HPP
+
+namespace gaenari {
+namespace method {
+namespace decision_tree {
+
+// dense label remapping for training.
+//
+// labels are string indexes of the string table, so they are sparse(ex: 3, 17, 2045).
+// while training, they are remapped to dense indexes(0, 1, ..., K-1),
+// and label counts are contiguous arrays instead of (label string index -> count) map.
+// the map form(predicted_count_t::count_t) is used only at the api boundary. (predicted_count_t, get_leaf_info, ...)
+//
+// the dense indexes are sorted by label string index,
+// so the iteration order(and the floating point summation order) is the same as the map sorted by key.
+class dense_label {
+public:
+	dense_label()  = default;
+	~dense_label() = default;
+
+public:
+	// build from the label column of the dataset.
+	void build(_in const dataset::dataset& train);
+
+	// clear.
+	void clear(void);
+
+	// label count(K).
+	inline size_t size(void) const {return labels.size();}
+
+	// dense label index of a row.
+	inline size_t get(_in size_t row_index) const {return row_labels[row_index];}
+
+	// count labels of rows into count[0, K).
+	template <typename rows_t>
+	inline void count(_in const rows_t& rows, _out size_t* count) const {
+		for (const auto& row_index: rows) count[row_labels[row_index]]++;
+	}
+
+	// dense count -> (label string index -> count) map.
+	// zero count is skipped.
+	// if keys is set, the label of non-zero keys[i] is included even if its count is zero.
+	inline void to_map(_in const size_t* count, _out predicted_count_t::count_t& label_count, _option_in const size_t* keys = nullptr) const {
+		label_count.clear();
+		for (size_t i=0; i<labels.size(); i++) {
+			if ((count[i] == 0) and ((not keys) or (keys[i] == 0))) continue;
+			label_count.emplace_hint(label_count.end(), labels[i], count[i]);
+		}
+	}
+
+	// (label string index -> count) map -> dense count[0, K).
+	// count must be zero-filled.
+	inline void from_map(_in const predicted_count_t::count_t& label_count, _out size_t* count) const {
+		for (const auto& it: label_count) {
+			auto find = std::lower_bound(labels.begin(), labels.end(), it.first);
+			if ((find == labels.end()) or (*find != it.first)) THROW_GAENARI_INTERNAL_ERROR0;
+			count[find - labels.begin()] = it.second;
+		}
+	}
+
+public:
+	// dense label index(0, 1, ..., K-1) -> label string index.
+	std::vector<size_t> labels;
+
+	// row index -> dense label index.
+	std::vector<uint32_t> row_labels;
+};
+
+// implementation.
+
+inline void dense_label::build(_in const dataset::dataset& train) {
+	const auto& y = train.y;
+	const size_t rows = train.metadata.instance_count;
+	std::map<size_t,uint32_t> label_map;
+
+	// clear.
+	clear();
+
+	// sorted distinct labels.
+	for (size_t row_index=0; row_index<rows; row_index++) label_map[y.get_raw(row_index, 0).index] = 0;
+	for (auto& it: label_map) {
+		it.second = static_cast<uint32_t>(labels.size());
+		labels.push_back(it.first);
+	}
+
+	// dense label of each row.
+	row_labels.resize(rows);
+	for (size_t row_index=0; row_index<rows; row_index++) row_labels[row_index] = label_map[y.get_raw(row_index, 0).index];
+}
+
+inline void dense_label::clear(void) {
+	labels.clear();
+	row_labels.clear();
+}
+
+} // decision_tree
+} // method
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_LABEL_HPP
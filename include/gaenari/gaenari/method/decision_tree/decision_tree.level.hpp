@@ -0,0 +1,214 @@
+#ifndef HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_LEVEL_HPP
+#define HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_LEVEL_HPP
+
+namespace gaenari {
+namespace method {
+namespace decision_tree {
+
+// level-wise(breadth-first) training.
+//
+// depth-first training scans the rows of a node once per node, so each row is touched once per ancestor,
+// and the access is scattered over the row index buffer.
+// level-wise training builds the tree depth by depth.
+// for each depth, it makes one sequential scan over all rows.
+// each row is routed to its frontier node, and the dense (node, feature, bin, label) count of
+// all frontier nodes is accumulated at once. the split of each node is chosen from its count.
+//
+//   depth 0 :            [root]                 rows : r0 r1 r2 r3 r4 r5 r6 r7 ...
+//                       /      \                slot :  0  0  0  0  0  0  0  0
+//   depth 1 :      [slot 0]  [slot 1]           rows : r0 r1 r2 r3 r4 r5 r6 r7 ...
+//                   /   \        \              slot :  1  0  0  1  0  1  1  0
+//   depth 2 :  [slot 0][slot 1][slot 2]         ...
+//
+// every feature is bucketed by histogram, and the bins of nominal features are the distinct string indexes.
+// with split_strategy_default, each distinct numeric value has its own bin.
+// so, the splits are the same as the depth-first training of the same split strategy,
+// and the tree is the same after tree_node::renumber_ids(...).
+//
+// the count of a frontier node is (sum of bins of all features) * label count.
+// if the frontier is too big, it's divided into batches, and the rows are scanned once per batch.
+// with split_strategy_default, numeric features with many distinct values make the count big,
+// so split_strategy_histogram is recommended.
+class level_wise {
+public:
+	level_wise() = delete;
+
+public:
+	// turn the node to a leaf node(returns empty), or split it with split_infos(returns the childs).
+	using grow_t = std::function<std::vector<tree_node*>(_in _out tree_node& node, _in const size_t* label_count, _in _out std::vector<split_info>& split_infos)>;
+
+	// maximum count items of a batch. (about 32 mb)
+	static constexpr size_t max_batch_count_size = static_cast<size_t>(1) << 22;
+
+	// train from the root.
+	// - histogram  : built with nominal = true.
+	// - pool       : rows are scanned in parallel chunks, and the nodes of a batch choose their split in parallel.
+	// - label_count: dense label count of the root.
+	// - stopped    : the training is stopped by train_control. the frontier is not scanned, and becomes leaf nodes.
+	// with feature subspace, the count of all features is accumulated, but only the subset of each node is evaluated.
+	static inline void train(_in const dataset::dataset& train, _in const dense_label& labels, _in const histogram& histogram, _in common::thread_pool& pool, _in const train_param& param, _in size_t min_instances, _in _out tree_node& root, _in std::vector<size_t>&& label_count, _in const grow_t& grow, _in const std::function<bool(void)>& stopped) {
+		constexpr size_t none = std::numeric_limits<size_t>::max();
+		const size_t rows = train.metadata.instance_count;
+		const size_t label_size = labels.size();
+		const size_t feature_count = histogram.columns.size();
+		const auto& columns = histogram.columns;
+
+		// offsets of each feature in the count of a node.
+		std::vector<size_t> offsets(feature_count, 0);
+		size_t node_count_size = 0;
+		for (size_t feature_index=0; feature_index<feature_count; feature_index++) {
+			const auto& column = columns[feature_index];
+			if ((not column.numeric) and (not column.nominal)) THROW_GAENARI_INTERNAL_ERROR0;
+			offsets[feature_index] = node_count_size;
+			node_count_size += column.bin_count() * label_size;
+		}
+
+		// rows are scanned in parallel chunks only for large data.
+		const size_t chunk_count = ((pool.size() > 1) and (rows >= param.parallel_feature_min_rows)) ? pool.size() : 1;
+
+		// frontier nodes and the routes of the previous depth.
+		std::vector<frontier_node> frontier;
+		std::vector<route_t> routes;
+		std::vector<size_t> slots(rows, 0);		// row index -> frontier slot. none if the row is in a leaf.
+		frontier.push_back(frontier_node{&root, std::move(label_count), rows});
+
+		for (;;) {
+			if (frontier.empty()) break;
+			std::vector<std::vector<split_info>> split_infos(frontier.size());
+
+			// frontier is divided into batches by the count size.
+			// stopped, all split infos are empty.
+			size_t batch_nodes = std::max<size_t>(1, max_batch_count_size / chunk_count / std::max<size_t>(1, node_count_size));
+			for (size_t batch_begin=0; (batch_begin<frontier.size()) and (not stopped()); batch_begin+=batch_nodes) {
+				const size_t batch_end = std::min(frontier.size(), batch_begin + batch_nodes);
+				const bool route_rows = (batch_begin == 0) and (not routes.empty());
+
+				// one sequential scan over rows.
+				// rows are routed to the current frontier(first batch only), and counted.
+				std::vector<std::vector<size_t>> counts(chunk_count);
+				pool.parallel_for(chunk_count, [&](size_t chunk) {
+					auto& count = counts[chunk];
+					count.assign((batch_end - batch_begin) * node_count_size, 0);
+					const size_t begin = rows * chunk / chunk_count;
+					const size_t end   = rows * (chunk + 1) / chunk_count;
+					for (size_t row_index=begin; row_index<end; row_index++) {
+						size_t slot = slots[row_index];
+						if (route_rows) {
+							if (slot != none) slot = route(routes[slot], columns, row_index);
+							slots[row_index] = slot;
+						}
+						if ((slot < batch_begin) or (slot >= batch_end)) continue;
+						size_t* node_count = &count[(slot - batch_begin) * node_count_size];
+						const size_t label = labels.get(row_index);
+						for (size_t feature_index=0; feature_index<feature_count; feature_index++) {
+							node_count[offsets[feature_index] + columns[feature_index].bins[row_index] * label_size + label]++;
+						}
+					}
+				});
+
+				// merge chunks.
+				auto& count = counts[0];
+				for (size_t chunk=1; chunk<chunk_count; chunk++) {
+					for (size_t i=0; i<count.size(); i++) count[i] += counts[chunk][i];
+				}
+
+				// choose the split of each node in the batch.
+				pool.parallel_for(batch_end - batch_begin, [&](size_t i) {
+					const auto& current = frontier[batch_begin + i];
+					const auto subspace = util::get_feature_subspace(*current.node, feature_count, param.feature_subspace, param.feature_subspace_seed);
+					split_infos[batch_begin + i] = engine::split_tree(labels, histogram, &count[i * node_count_size], offsets, current.label_count.data(), current.row_count, min_instances, param.nominal_min_support, subspace.empty() ? nullptr : &subspace);
+				});
+			}
+
+			// grow the frontier nodes, and get the next frontier.
+			std::vector<frontier_node> next;
+			routes.assign(frontier.size(), route_t{});
+			for (size_t slot=0; slot<frontier.size(); slot++) {
+				auto& current = frontier[slot];
+				auto childs = grow(*current.node, current.label_count.data(), split_infos[slot]);
+				if (childs.empty()) continue;
+
+				// route of the rows of the current node.
+				routes[slot] = get_route(childs, columns, next.size());
+				for (auto* child: childs) {
+					frontier_node node{child, std::vector<size_t>(label_size, 0), 0};
+					labels.from_map(child->predicted_count.count, node.label_count.data());
+					for (const auto c: node.label_count) node.row_count += c;
+					next.push_back(std::move(node));
+				}
+			}
+			frontier = std::move(next);
+		}
+	}
+
+protected:
+	struct frontier_node {
+		tree_node* node = nullptr;
+		std::vector<size_t> label_count;	// dense label count.
+		size_t row_count = 0;
+	};
+
+	// which child of the split node does a row go to?
+	struct route_t {
+		size_t first_slot = std::numeric_limits<size_t>::max();	// frontier slot of the first child. max if leaf.
+		size_t feature_index = 0;
+		bool numeric = false;
+		uint32_t split_bin = 0;				// numeric. (bin <= split_bin) goes to lte_child, otherwise gt_child.
+		uint32_t lte_child = 0;
+		uint32_t gt_child  = 0;
+		std::vector<uint32_t> bin_to_child;	// nominal. bin -> child index. max if no child.
+	};
+
+	static inline route_t get_route(_in const std::vector<tree_node*>& childs, _in const std::vector<histogram::column>& columns, _in size_t first_slot) {
+		constexpr uint32_t no_child = std::numeric_limits<uint32_t>::max();
+		route_t r;
+		r.first_slot    = first_slot;
+		r.feature_index = childs[0]->rule.feature_indexes[0];
+		const auto& column = columns[r.feature_index];
+		r.numeric = column.numeric;
+		if (not r.numeric) r.bin_to_child.assign(column.values.size(), no_child);
+		uint32_t other = no_child;
+		for (uint32_t i=0; i<static_cast<uint32_t>(childs.size()); i++) {
+			const auto& rule = childs[i]->rule;
+			if ((rule.feature_indexes.size() != 1) or (rule.feature_indexes[0] != r.feature_index) or (rule.args.size() != 1)) THROW_GAENARI_INTERNAL_ERROR0;
+			if (rule.type == rule_t::rule_type::cmp_other) {
+				// grouped rare values. the bins of no other child.
+				if (r.numeric) THROW_GAENARI_INTERNAL_ERROR0;
+				other = i;
+			} else if (r.numeric) {
+				// the argument is the upper bound of a bin.
+				auto find = std::lower_bound(column.uppers.begin(), column.uppers.end(), rule.args[0]);
+				if ((find == column.uppers.end()) or (not (*find == rule.args[0]))) THROW_GAENARI_INTERNAL_ERROR0;
+				r.split_bin = static_cast<uint32_t>(find - column.uppers.begin());
+				if      (rule.type == rule_t::rule_type::cmp_lte) r.lte_child = i;
+				else if (rule.type == rule_t::rule_type::cmp_gt)  r.gt_child  = i;
+				else THROW_GAENARI_INTERNAL_ERROR0;
+			} else {
+				// the argument is a string index.
+				if (rule.type != rule_t::rule_type::cmp_equ) THROW_GAENARI_INTERNAL_ERROR0;
+				auto find = std::lower_bound(column.values.begin(), column.values.end(), rule.args[0].index);
+				if ((find == column.values.end()) or (*find != rule.args[0].index)) THROW_GAENARI_INTERNAL_ERROR0;
+				r.bin_to_child[find - column.values.begin()] = i;
+			}
+		}
+		if (other != no_child) {
+			for (auto& child: r.bin_to_child) if (child == no_child) child = other;
+		}
+		return r;
+	}
+
+	static inline size_t route(_in const route_t& r, _in const std::vector<histogram::column>& columns, _in size_t row_index) {
+		if (r.first_slot == std::numeric_limits<size_t>::max()) return std::numeric_limits<size_t>::max();
+		const auto bin = columns[r.feature_index].bins[row_index];
+		if (r.numeric) return r.first_slot + ((bin <= r.split_bin) ? r.lte_child : r.gt_child);
+		const auto child = r.bin_to_child[bin];
+		if (child == std::numeric_limits<uint32_t>::max()) return std::numeric_limits<size_t>::max();
+		return r.first_slot + child;
+	}
+};
+
+} // decision_tree
+} // method
+} // gaenari
+
+#endif // HEADER_GAENARI_GAENARI_METHOD_DECISION_TREE_DECISION_TREE_LEVEL_HPP
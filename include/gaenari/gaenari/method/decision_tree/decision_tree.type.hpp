@@ -8,7 +8,67 @@ namespace decision_tree {
 // split strategy.
 enum class split_strategy {
 	split_strategy_unknown = 0,
-	split_strategy_default = 1, // nominal(all distinct value splits, = rule), numeric(two splits, <= or > rule)
+	split_strategy_default   = 1, // nominal(all distinct value splits, = rule), numeric(two splits, <= or > rule)
+	split_strategy_histogram = 2, // nominal(same as default), numeric(two splits on bucketed values, <= or > rule)
+};
+
+// training control. see decision_tree.control.hpp.
+class train_control;
+
+// additional train parameters.
+// the frequently used parameters are passed as arguments of train(...),
+// and the rest are gathered here.
+struct train_param {
+	// [255] maximum bin count per numeric feature. (split_strategy_histogram only)
+	size_t histogram_max_bins = 255;
+
+	// [1] thread count for training. 0 means hardware concurrency, 1 means single thread.
+	size_t threads = 1;
+
+	// [4096] features are evaluated in parallel when the row count of a node is greater than or equal to this.
+	// small nodes are faster in single thread because of the task dispatch overhead.
+	size_t parallel_feature_min_rows = 4096;
+
+	// [65536] subtrees of the nodes with less rows than this are built concurrently by work-stealing. 0 means disabled.
+	// the upper nodes are built one by one with parallel feature evaluation.
+	// tree node ids are the same as the single thread training.
+	size_t parallel_subtree_rows = 65536;
+
+	// [false] level-wise(breadth-first) training. see level_wise.
+	// each depth is built with one sequential scan over the rows. the tree is the same as the depth-first training.
+	// split_strategy_histogram is recommended. (split_strategy_default has a bin for each distinct numeric value.)
+	bool level_wise = false;
+
+	// [0] splits of the nodes with rows more than or equal to this are searched on a stratified sample. 0 means disabled.
+	// the top sample_top_features features of the sample are evaluated again with all rows, and the best one is chosen.
+	// the split(threshold and count) is always of all rows, only the choice of the feature is approximated.
+	// depth-first training only. train(...) raises an invalid parameter error with level_wise = true.
+	size_t sample_min_rows = 0;
+
+	// [65536] row count of the sample.
+	size_t sample_rows = 65536;
+
+	// [2] feature count of the sample to be evaluated again with all rows.
+	size_t sample_top_features = 2;
+
+	// [0] rare value grouping of nominal splits. 0 means disabled.
+	// the values of a nominal split with less rows than this are grouped into one `other` child(rule_t::rule_type::cmp_other).
+	// long-tail nominal features(ex: ids) make a lot of tiny childs, and it bounds the fan-out.
+	// the `other` child also matches the values not seen in the rows of the node, and the strings not in the string table.
+	// it's the same in all predict paths. (tree nodes, compiled tree, dataframe, mapped_tree and codegen)
+	size_t nominal_min_support = 0;
+
+	// [0] random feature subspace. feature count to be evaluated per node. 0 means all features.
+	// each node evaluates only its random subset of the features, so the split search cost drops proportionally.
+	// the subset is chosen by feature_subspace_seed and the path from the root,
+	// so the tree is deterministic regardless of the threads and level_wise.
+	size_t feature_subspace = 0;
+
+	// [0] seed of the random feature subspace.
+	int feature_subspace_seed = 0;
+
+	// [nullptr] time and node budget, progress callback and cancellation. see train_control.
+	train_control* control = nullptr;
 };
 
 // tree node rule.
@@ -24,8 +84,12 @@ public:
 	// ----------------+----------+---------------+----------------------------------------------
 	//             {3} | cmp_equ  | {(double)5.0} | if (3th feature value == 5.0)        then ...
 	//             {3} | cmp_equ  | {(size_t)5  } | if (3th feature value == strings[5]) then ...
+	//             {3} | cmp_other| {(size_t)max} | if (3th feature value is none of the siblings) then ...
 	// ----------------+----------+---------------+----------------------------------------------
-	std::vector<size_t> feature_indexes;	// target related feature indexes. usally, size is one.
+	//
+	// feature_indexes and args are usually size one, so one item is stored inline without heap allocation.
+	// more items overflow to the heap.
+	common::small_vector<size_t,1> feature_indexes;	// target related feature indexes. usally, size is one.
 	enum class rule_type {
 		unknown  = 0,
 		cmp_equ  = 1, // ${feature_indexes[0]} == args[0]
@@ -33,14 +97,21 @@ public:
 		cmp_lt   = 3, // ${feature_indexes[0]} <  args[0]
 		cmp_gt   = 4, // ${feature_indexes[0]} >  args[0]
 		cmp_gte  = 5, // ${feature_indexes[0]} >= args[0]
+		cmp_other= 6, // ${feature_indexes[0]} is none of the cmp_equ siblings. (grouped rare values of nominal split)
+		              // it's always the last child, so it matches when no sibling is matched.
+		              // args[0] is max size_t.
 	} type = rule_type::unknown;
-	std::vector<type::value> args;		// arguments for rule. usally, size is one.
+	common::small_vector<type::value,1> args;		// arguments for rule. usally, size is one.
 };
 
 // the predicted instance number per classes in the tree node for the training data.
+// labels of a tree node are a few, so it's a sorted flat array instead of std::map.
+// up to 4 labels are stored inline. more labels overflow to the heap.
 struct predicted_count_t {
+	using count_t = common::small_flat_map<size_t,size_t,4>;
+
 	// (label_index -> count) map
-	std::map<size_t,size_t> count;
+	count_t count;
 };
 
 struct leaf_info_t {
@@ -49,6 +120,8 @@ struct leaf_info_t {
 	size_t incorrect_count = 0;
 };
 
+class tree_node_pool;
+
 class tree_node {
 public:
 	tree_node()  = default;
@@ -69,70 +142,278 @@ public:
 	// link
 	tree_node* parent = nullptr;
 
+	// index of this node in parent->childs. set by build_child_nodes(...).
+	size_t position = 0;
+
 	// use `childs` instead of `children` to express the meaning of vector.
 	std::vector<tree_node*> childs;
 
+	// (string index -> child) of the nominal split, sorted by string index.
+	// the child of a nominal value is found by binary search instead of evaluating the rules of all childs.
+	// built by build_nominal_index(...) only for the nominal split with many childs. empty, linear scan.
+	std::vector<std::pair<size_t,tree_node*>> nominal_index;
+
 	// leaf node?
 	// if true,  the actual classify information.
 	// if false, classify information to the current tree node from root.
 	bool leaf = false;
 	leaf_info_t leaf_info;
 
+	// the arena that owns this node.
+	// nullptr means it's allocated by new.
+	tree_node_pool* pool = nullptr;
+
+public:
+	// minimum child count of nominal_index. a few childs are faster with linear scan.
+	static constexpr size_t nominal_index_min_childs = 8;
+
+public:
+	// destroy all descendants in O(n).
+	// the nodes are returned to the pool(recycled), or deleted.
+	void destroy_all_child_node(_option_in bool delete_me);
+
 public:
-	void destroy_all_child_node(_option_in bool delete_me) {
-		std::set<tree_node*> p;
+	// build nodes.
+	// the root node is allocated from the pool if set, and the child nodes from the pool of parent.
+	static tree_node* build_root_node(_in _out int& treenode_id, _option_in tree_node_pool* pool = nullptr);
+	static std::vector<tree_node*> build_child_nodes(_in tree_node& parent, _in size_t count, _in _out int& treenode_id);
 
-		if (delete_me and this->parent) THROW_GAENARI_ERROR("destroy link from parent.");
+	// renumber the tree node ids in the order of build_child_nodes(...) calls of the single thread training.
+	// the single thread training pops the stack, and allocates the ids of all childs at once.
+	// following the same stack order gives the same ids regardless of the actual build order.
+	// call before pruning, the pruned nodes also have ids.
+	static inline void renumber_ids(_in _out tree_node& root) {
+		int treenode_id = root.id + 1;
+		std::stack<tree_node*> stack;
+		stack.push(&root);
+		for (;;) {
+			if (stack.empty()) break;
+			auto* current = stack.top();
+			stack.pop();
+			int count = static_cast<int>(current->childs.size());
+			for (int i=0; i<count; i++) current->childs[i]->id = treenode_id + count - i - 1;
+			treenode_id += count;
+			for (auto* child: current->childs) stack.push(child);
+		}
+	}
+
+	// the childs are the nominal split?
+	// all rules are `feature == string index` of the same feature, and the string indexes are unique.
+	// the last child can be cmp_other.
+	// so, at most one cmp_equ child is matched, and the order of cmp_equ childs does not matter.
+	static bool is_nominal_split(_in const std::vector<tree_node*>& childs);
+
+	// build nominal_index of all nodes under the root.
+	// call again after the tree is changed.
+	static void build_nominal_index(_in _out tree_node& root);
+
+	// find the child of the nominal value with nominal_index.
+	// returns the cmp_other child if not found, or nullptr if there is no cmp_other child.
+	const tree_node* find_nominal_child(_in size_t string_index) const;
+
+protected:
+	static tree_node* allocate(_option_in tree_node_pool* pool);
+	static void release(_in tree_node* node);
+};
 
-		struct _inner {
-			static void _traverse(_in tree_node* node, _out std::set<tree_node*>& p) {
-				if (not node) return;
-				for (auto& n: node->childs) {
-					p.insert(n);
-					_traverse(n, p);
-				}
+// arena of tree nodes.
+// all tree nodes of a decision_tree are allocated from here, and released at once with clear().
+// the nodes removed by pruning are recycled for the next allocation.
+// nodes are allocated in blocks, so the nodes are close in memory.
+// allocate() and recycle() are thread-safe. (parallel subtree training)
+class tree_node_pool {
+public:
+	tree_node_pool()  = default;
+	~tree_node_pool() = default;
+	tree_node_pool(const tree_node_pool&) = delete;
+	tree_node_pool& operator=(const tree_node_pool&) = delete;
+
+public:
+	inline tree_node* allocate(void) {
+		std::lock_guard<std::mutex> l(mutex);
+		tree_node* node = nullptr;
+		if (not free_nodes.empty()) {
+			// recycled.
+			node = free_nodes.back();
+			free_nodes.pop_back();
+		} else {
+			// new block. (64, 128, ..., 4096 nodes)
+			if (blocks.empty() or (used == block_size)) {
+				block_size = blocks.empty() ? 64 : std::min(block_size * 2, static_cast<size_t>(4096));
+				blocks.emplace_back(std::make_unique<tree_node[]>(block_size));
+				used = 0;
 			}
-		};
-
-		// get all child node pointers.
-		_inner::_traverse(this, p);
-		
-		// delete all child pointers.
-		for (auto& ptr: p) {
-			if (ptr) delete ptr;
+			node = &blocks.back()[used++];
 		}
+		node->pool = this;
+		count++;
+		return node;
+	}
 
-		// clear childs
-		this->childs.clear();
+	inline void recycle(_in tree_node* node) {
+		// reset, and keep it for the next allocation.
+		*node = tree_node{};
+		std::lock_guard<std::mutex> l(mutex);
+		free_nodes.push_back(node);
+		count--;
+	}
 
-		// delete me?
-		if (delete_me) delete this;
+	// release all nodes at once.
+	inline void clear(void) {
+		std::lock_guard<std::mutex> l(mutex);
+		blocks.clear();
+		free_nodes.clear();
+		block_size = 0;
+		used = 0;
+		count = 0;
 	}
 
-public:
-	static inline tree_node* build_root_node(_in _out int& treenode_id) {
-		tree_node* r = new tree_node;
-		r->id = treenode_id;
+	// the number of nodes in use.
+	inline size_t size(void) const {
+		return count;
+	}
+
+protected:
+	std::vector<std::unique_ptr<tree_node[]>> blocks;
+	std::vector<tree_node*> free_nodes;
+	size_t block_size = 0;	// size of the last block.
+	size_t used = 0;		// used count of the last block.
+	size_t count = 0;
+	std::mutex mutex;
+};
+
+// tree_node implementation.
+
+inline tree_node* tree_node::allocate(_option_in tree_node_pool* pool) {
+	if (pool) return pool->allocate();
+	return new tree_node;
+}
+
+inline void tree_node::release(_in tree_node* node) {
+	if (not node) return;
+	if (node->pool) node->pool->recycle(node);
+	else delete node;
+}
+
+inline void tree_node::destroy_all_child_node(_option_in bool delete_me) {
+	std::vector<tree_node*> p;
+	std::vector<tree_node*> stack;
+
+	if (delete_me and this->parent) THROW_GAENARI_ERROR("destroy link from parent.");
+
+	// get all child node pointers.
+	// each node has only one parent, so a node is collected only once without std::set.
+	for (auto* child: this->childs) stack.push_back(child);
+	for (;;) {
+		if (stack.empty()) break;
+		auto* node = stack.back();
+		stack.pop_back();
+		if (not node) continue;
+		p.push_back(node);
+		for (auto* child: node->childs) stack.push_back(child);
+	}
+
+	// release all child pointers.
+	for (auto& ptr: p) release(ptr);
+
+	// clear childs
+	this->childs.clear();
+	this->nominal_index.clear();
+
+	// delete me?
+	if (delete_me) release(this);
+}
+
+inline tree_node* tree_node::build_root_node(_in _out int& treenode_id, _option_in tree_node_pool* pool) {
+	tree_node* r = allocate(pool);
+	r->id = treenode_id;
+	treenode_id++;
+	return r;
+}
+
+inline std::vector<tree_node*> tree_node::build_child_nodes(_in tree_node& parent, _in size_t count, _in _out int& treenode_id) {
+	std::vector<tree_node*> r(count);
+	int count_int = static_cast<int>(count);
+	int base_treenode_id = treenode_id;
+	// the treenode id is not n, n+1, n+2, ..., but in reverse order as treenode_id+count-0-1, treebnode_id+count-1-1, treenode_id+count-2, ..., treenode_id.
+	// after that, they are output in order.
+	for (int i=0; i<count; i++) {
+		auto c = allocate(parent.pool);
+		c->id = base_treenode_id + count_int - i - 1;
 		treenode_id++;
-		return r;
+		c->parent = &parent;
+		c->position = c->parent->childs.size();
+		c->parent->childs.push_back(c);
+		r[i] = c;
 	}
+	return r;
+}
 
-	static inline std::vector<tree_node*> build_child_nodes(_in tree_node& parent, _in size_t count, _in _out int& treenode_id) {
-		std::vector<tree_node*> r(count);
-		int count_int = static_cast<int>(count);
-		int base_treenode_id = treenode_id;
-		// the treenode id is not n, n+1, n+2, ..., but in reverse order as treenode_id+count-0-1, treebnode_id+count-1-1, treenode_id+count-2, ..., treenode_id.
-		// after that, they are output in order.
-		for (int i=0; i<count; i++) {
-			auto c = new tree_node;
-			c->id = base_treenode_id + count_int - i - 1;
-			treenode_id++;
-			c->parent = &parent;
-			c->parent->childs.push_back(c);
-			r[i] = c;
-		}
-		return r;
+inline bool tree_node::is_nominal_split(_in const std::vector<tree_node*>& childs) {
+	if (childs.empty()) return false;
+	const auto& first = childs[0]->rule;
+	if (first.feature_indexes.empty()) return false;
+	std::vector<size_t> values;
+	values.reserve(childs.size());
+	for (const auto* child: childs) {
+		const auto& rule = child->rule;
+		const bool other = (rule.type == rule_t::rule_type::cmp_other) and (child == childs.back());
+		if (((rule.type != rule_t::rule_type::cmp_equ) and (not other)) or (rule.feature_indexes.size() != 1) or (rule.args.size() != 1)) return false;
+		if ((rule.feature_indexes[0] != first.feature_indexes[0]) or (rule.args[0].valueype != type::value_type::value_type_size_t)) return false;
+		values.push_back(rule.args[0].index);
 	}
+	std::sort(values.begin(), values.end());
+	return std::adjacent_find(values.begin(), values.end()) == values.end();
+}
+
+inline void tree_node::build_nominal_index(_in _out tree_node& root) {
+	std::vector<tree_node*> stack;
+	stack.push_back(&root);
+	for (;;) {
+		if (stack.empty()) break;
+		auto* node = stack.back();
+		stack.pop_back();
+		node->nominal_index.clear();
+		for (auto* child: node->childs) stack.push_back(child);
+		if (node->leaf or (node->childs.size() < nominal_index_min_childs) or (not is_nominal_split(node->childs))) continue;
+		node->nominal_index.reserve(node->childs.size());
+		for (auto* child: node->childs) node->nominal_index.emplace_back(child->rule.args[0].index, child);
+		std::sort(node->nominal_index.begin(), node->nominal_index.end(), [](const auto& a, const auto& b) {return a.first < b.first;});
+	}
+}
+
+inline const tree_node* tree_node::find_nominal_child(_in size_t string_index) const {
+	auto find = std::lower_bound(nominal_index.begin(), nominal_index.end(), string_index, [](const auto& a, size_t b) {return a.first < b;});
+	if ((find == nominal_index.end()) or (find->first != string_index)) {
+		// the cmp_other child has max size_t, so it's the last.
+		if ((not nominal_index.empty()) and (nominal_index.back().second->rule.type == rule_t::rule_type::cmp_other)) return nominal_index.back().second;
+		return nullptr;
+	}
+	return find->second;
+}
+
+// row indexes of a tree node while training.
+// training has only one row index buffer, and it's partitioned in place for each split.
+// so, the rows of a node are contiguous, and a node has its [begin, end) of the buffer.
+//
+//  buffer : | r0 r5 r2 r9 | r1 r3 | r4 r6 r7 r8 |
+//           '-----+-------'---+---'-----+-------'
+//               child 0    child 1   child 2
+//           '-------------------+---------------'
+//                             parent
+class row_range {
+public:
+	row_range() = default;
+	row_range(_in size_t* first, _in size_t* last): first{first}, last{last} {}
+	~row_range() = default;
+public:
+	inline size_t* begin(void) const {return first;}
+	inline size_t* end(void) const {return last;}
+	inline size_t size(void) const {return static_cast<size_t>(last - first);}
+	inline bool empty(void) const {return first == last;}
+public:
+	size_t* first = nullptr;
+	size_t* last  = nullptr;
 };
 
 // decision_tree do not use recursive function call.
@@ -140,11 +421,12 @@ public:
 // nodes pushed onto the stack for training.
 class stack_train_node {
 public:
-	stack_train_node(_in tree_node& node, _in std::vector<size_t>& row_selections): node{node}, row_selections{row_selections} {}
+	stack_train_node(_in tree_node& node, _in const row_range& row_selections, _in std::vector<size_t>&& label_count): node{node}, row_selections{row_selections}, label_count{std::move(label_count)} {}
 	~stack_train_node() = default;
 public:
 	tree_node& node;					// just reference.
-	std::vector<size_t> row_selections;	// not reference, vector copied.
+	row_range row_selections;			// [begin, end) of the shared row index buffer.
+	std::vector<size_t> label_count;	// dense label count of row_selections. (from the split of the parent)
 };
 
 // nodes pushed onto the stack for traversing.
@@ -25,6 +25,9 @@ inline bool is_match_type_1(_in const type::value& feature_value, _in const rule
 		case rule_t::rule_type::cmp_gte:
 			if (feature_value >= rule.args[0]) return true;
 			break;
+		case rule_t::rule_type::cmp_other:
+			// the last child. no sibling is matched.
+			return true;
 		default:
 			THROW_GAENARI_ERROR("not supported rule type.");
 	}
@@ -34,13 +37,10 @@ inline bool is_match_type_1(_in const type::value& feature_value, _in const rule
 // match rule with one value string.
 // use other kind of data like json rather than dataframe.
 // strings_map can be dataframe::_strings_map.
+// a string not in the string table is max size_t. it does not match `==`, and matches cmp_other. (see compiled_tree)
 inline bool is_match_type_1(_in const std::string& feature_value, _in const rule_t& rule, _in const common::string_table& strings) {
 	// to index
-	if (type::value_type::value_type_size_t == rule.args[0].valueype) {
-		auto find = strings.get_id_size_t(feature_value);
-		if (find == std::numeric_limits<size_t>::max()) THROW_GAENARI_FEATURE_NOT_FOUND("feature not found:" + feature_value);
-		return is_match_type_1(find, rule);
-	}
+	if (type::value_type::value_type_size_t == rule.args[0].valueype) return is_match_type_1(strings.get_id_size_t(feature_value), rule);
 	// to double
 	if (type::value_type::value_type_double == rule.args[0].valueype) return is_match_type_1(std::stod(feature_value), rule);
 	if (type::value_type::value_type_int    == rule.args[0].valueype) return is_match_type_1(std::stoi(feature_value), rule);
@@ -79,6 +79,28 @@ inline bool is_match_type_1(_in const std::map<std::string,std::variant<std::mon
 	return is_match_type_1(find->second, rule, strings);
 }
 
+// string index of the nominal feature value of the rule in (feature name, value) map.
+// it's the same conversion of is_match_type_1(...) with the `feature == string index` rule.
+// returns false if the value is not converted, then use is_match_type_1(...).
+// a string not in the string table is max size_t, and tree_node::find_nominal_child(...) returns the cmp_other child.
+inline bool get_nominal_index(_in const std::map<std::string,std::string>& key_value, _in const rule_t& rule, _in const common::string_table& strings, _in const std::vector<dataset::column_info>& columns, _out size_t& string_index) {
+	const std::string& feature_name = columns[rule.feature_indexes[0]].name;
+	const auto find = key_value.find(feature_name);
+	if (find == key_value.end()) THROW_GAENARI_FEATURE_NOT_FOUND("feature not found:" + feature_name);
+	string_index = strings.get_id_size_t(find->second);
+	return true;
+}
+
+inline bool get_nominal_index(_in const std::map<std::string,std::variant<std::monostate,int,size_t,std::string,double,int64_t>>& key_value, _in const rule_t& rule, _in const common::string_table& /*strings*/, _in const std::vector<dataset::column_info>& columns, _out size_t& string_index) {
+	const std::string& feature_name = columns[rule.feature_indexes[0]].name;
+	const auto find = key_value.find(feature_name);
+	if (find == key_value.end()) THROW_GAENARI_FEATURE_NOT_FOUND("feature not found:" + feature_name);
+	// only size_t is the string index.
+	if (find->second.index() != 2) return false;
+	string_index = std::get<2>(find->second);
+	return true;
+}
+
 // match rule with data.
 inline bool is_match(_in const dataset::dataframe& df, _in const rule_t& rule, _in size_t row_index) {
 	// alias
@@ -90,12 +112,181 @@ inline bool is_match(_in const dataset::dataframe& df, _in const rule_t& rule, _
 
 inline std::vector<size_t> get_matched_row_selections(_in const dataset::dataset& train, _in rule_t& rule, _in const std::vector<size_t>& old_row_selections) {
 	std::vector<size_t> r;
-	for (auto row_index: old_row_selections) {
-		if (is_match(train.x, rule, row_index)) r.push_back(row_index);
-	}
+	const auto& x = train.x;
+	const auto feature_index = rule.feature_indexes[0];
+	// the kernel is selected once, not per row.
+	kernel::dispatch(rule, [&](auto match) {
+		for (auto row_index: old_row_selections) {
+			if (match(x.get_raw(row_index, feature_index))) r.push_back(row_index);
+		}
+	});
 	return r;
 }
 
+// convert (feature name, value) map data to pre-typed row of the columns. (see compiled_tree)
+// get_string_index(s) returns the string index of the nominal value, max size_t if not existed.
+// exception(feature not found) is raised if a feature is missing.
+// decision_tree and mapped_tree use it with their own string table.
+template <typename get_string_index_t>
+inline void get_typed_row(_in const std::map<std::string,std::string>& test, _in const std::vector<dataset::column_info>& columns, _in const get_string_index_t& get_string_index, _out std::vector<type::value_raw>& row) {
+	row.resize(columns.size());
+	for (size_t feature_index=0; feature_index<columns.size(); feature_index++) {
+		const auto& column = columns[feature_index];
+		const auto find = test.find(column.name);
+		if (find == test.end()) THROW_GAENARI_FEATURE_NOT_FOUND("feature not found:" + column.name);
+		auto& value = row[feature_index];
+		switch (column.data_type) {
+			case dataset::data_type_t::data_type_int:
+				value.numeric_int64 = 0;
+				value.numeric_int32 = std::stoi(find->second);
+				break;
+			case dataset::data_type_t::data_type_int64:
+				value.numeric_int64 = static_cast<int64_t>(std::stoll(find->second));
+				break;
+			case dataset::data_type_t::data_type_double:
+				value.numeric_double = std::stod(find->second);
+				break;
+			case dataset::data_type_t::data_type_string:
+			case dataset::data_type_t::data_type_string_table:
+				value.index = get_string_index(find->second);
+				break;
+			default:
+				THROW_GAENARI_ERROR("invalid data type.");
+		}
+	}
+}
+
+// partition the row indexes of the parent in place by the rules of childs.
+// after partitioning, the rows of childs[i] are contiguous, and ranges[i] is their [begin, end).
+// the order of rows in a child is not preserved.
+// rows that do not match any child are moved to the end, and are not included in any range.
+inline void partition_row_range(_in const dataset::dataset& train, _in const std::vector<tree_node*>& childs, _in const row_range& parent, _out std::vector<row_range>& ranges) {
+	const size_t count = childs.size();
+	ranges.clear();
+	if (count == 0) return;
+
+	// two childs(usually numeric <=, >), quicksort-style partition.
+	if (count == 2) {
+		// the kernel of each rule is selected once, and the partition loop has no type or operator branch.
+		const auto& x = train.x;
+		auto partition = [&x](auto first, auto last, const rule_t& rule) {
+			const auto feature_index = rule.feature_indexes[0];
+			return kernel::dispatch(rule, [&](auto match) {
+				return std::partition(first, last, [&](size_t row_index) {return match(x.get_raw(row_index, feature_index));});
+			});
+		};
+		auto mid  = partition(parent.begin(), parent.end(), childs[0]->rule);
+		auto last = partition(mid, parent.end(), childs[1]->rule);
+		ranges.emplace_back(parent.begin(), mid);
+		ranges.emplace_back(mid, last);
+		return;
+	}
+
+	// multiple childs(usually nominal ==).
+	// get the child index of each row once, and move rows to their bucket in place(american flag sort).
+	// if all rules are `feature == string index` of the same feature, the child index is found by hash.
+	// the last cmp_other child gets the rows not found.
+	const size_t no_match = count;
+	size_t not_found = no_match;
+	std::unordered_map<size_t,size_t> index_to_child;
+	bool equ_only = true;
+	for (size_t i=0; i<count; i++) {
+		const auto& rule = childs[i]->rule;
+		if ((i + 1 == count) and (rule.type == rule_t::rule_type::cmp_other)) {
+			not_found = i;
+			break;
+		}
+		if ((rule.type != rule_t::rule_type::cmp_equ) or (rule.args[0].valueype != type::value_type::value_type_size_t) or
+			(rule.feature_indexes[0] != childs[0]->rule.feature_indexes[0])) {
+			equ_only = false;
+			break;
+		}
+		index_to_child.emplace(rule.args[0].index, i);
+	}
+
+	// otherwise, the kernel of each rule is selected once.
+	std::vector<kernel::match_fn> matches;
+	if (not equ_only) {
+		for (const auto child: childs) matches.push_back(kernel::get_match_fn(child->rule));
+	}
+	auto get_child = [&](size_t row_index) -> size_t {
+		if (equ_only) {
+			auto find = index_to_child.find(train.x.get_raw(row_index, childs[0]->rule.feature_indexes[0]).index);
+			return (find == index_to_child.end()) ? not_found : find->second;
+		}
+		for (size_t i=0; i<count; i++) {
+			const auto& rule = childs[i]->rule;
+			if (matches[i](train.x.get_raw(row_index, rule.feature_indexes[0]), rule.args[0])) return i;
+		}
+		return no_match;
+	};
+
+	// bucket of each row. (buckets[i] is for parent.begin()[i])
+	const size_t size = parent.size();
+	std::vector<size_t> buckets(size);
+	std::vector<size_t> bucket_count(count + 1, 0);
+	for (size_t i=0; i<size; i++) {
+		buckets[i] = get_child(parent.begin()[i]);
+		bucket_count[buckets[i]]++;
+	}
+
+	// [next[b], last[b]) is the unsorted part of bucket b.
+	std::vector<size_t> next(count + 1), last(count + 1);
+	size_t offset = 0;
+	for (size_t b=0; b<=count; b++) {
+		next[b] = offset;
+		offset += bucket_count[b];
+		last[b] = offset;
+	}
+	for (size_t b=0; b<=count; b++) {
+		while (next[b] < last[b]) {
+			// swap the row into its bucket until the row of bucket b comes.
+			size_t target = buckets[next[b]];
+			if (target == b) {
+				next[b]++;
+				continue;
+			}
+			std::swap(parent.begin()[next[b]], parent.begin()[next[target]]);
+			std::swap(buckets[next[b]], buckets[next[target]]);
+			next[target]++;
+		}
+	}
+
+	// ranges of childs.
+	offset = 0;
+	for (size_t b=0; b<count; b++) {
+		ranges.emplace_back(parent.begin() + offset, parent.begin() + offset + bucket_count[b]);
+		offset += bucket_count[b];
+	}
+}
+
+// random feature subspace of the node. (train_param::feature_subspace)
+// returns the mask of `subspace` features chosen from feature_count features. empty if all features are used.
+// the random generator is seeded with the seed and the child positions of the path from the root,
+// so the subset of a node does not depend on the order of training. (threads, level-wise)
+inline std::vector<bool> get_feature_subspace(_in const tree_node& node, _in size_t feature_count, _in size_t subspace, _in int seed) {
+	if ((subspace == 0) or (subspace >= feature_count)) return {};
+
+	// hash of the path. (fnv-1a of child positions)
+	uint64_t h = 14695981039346656037ULL ^ static_cast<uint64_t>(static_cast<uint32_t>(seed));
+	for (auto* current=&node; current->parent; current=current->parent) {
+		h = (h ^ (static_cast<uint64_t>(current->position) + 1)) * 1099511628211ULL;
+	}
+
+	// partial fisher-yates shuffle.
+	// the modulo of mt19937_64 output is used instead of std::uniform_int_distribution(implementation-defined),
+	// so the subset is the same on every platform.
+	std::mt19937_64 g(h);
+	std::vector<size_t> indexes(feature_count);
+	std::iota(indexes.begin(), indexes.end(), 0);
+	std::vector<bool> mask(feature_count, false);
+	for (size_t i=0; i<subspace; i++) {
+		std::swap(indexes[i], indexes[i + static_cast<size_t>(g() % (feature_count - i))]);
+		mask[indexes[i]] = true;
+	}
+	return mask;
+}
+
 // traverse
 
 // ex)
@@ -212,6 +403,39 @@ inline void get_actual_label_index(_in const std::vector<std::map<std::string,st
 	}
 }
 
+// string index converter between two string tables.
+// the string index of `from` is converted to the string index of `to` with the same string.
+// each string index is looked up only once, and cached.
+// the string not in `to` is converted to max size_t.
+class string_index_map {
+public:
+	string_index_map() = delete;
+	inline string_index_map(_in const common::string_table& from, _in const common::string_table& to): from{from}, to{to} {
+		cache.resize(static_cast<size_t>(from.get_last_id() + 1), unresolved);
+	}
+
+public:
+	inline size_t get(_in size_t index) {
+		if (index >= cache.size()) return lookup(index);
+		auto& v = cache[index];
+		if (v == unresolved) v = lookup(index);
+		return v;
+	}
+
+protected:
+	inline size_t lookup(_in size_t index) const {
+		if (index > static_cast<size_t>(std::numeric_limits<int>::max())) return std::numeric_limits<size_t>::max();
+		const auto& s = from.get_string_noexept(index);
+		return to.get_id_size_t(s);
+	}
+
+protected:
+	static constexpr size_t unresolved = std::numeric_limits<size_t>::max() - 1;
+	const common::string_table& from;
+	const common::string_table& to;
+	std::vector<size_t> cache;
+};
+
 // called from decsion_tree_t::eval(...)
 inline void get_actual_label_index(_in const dataset::dataframe& tests, _in const std::string& y_name, _in const common::string_table& strings, _out std::vector<size_t>& actuals) {
 	// clear output
@@ -229,6 +453,15 @@ inline void get_actual_label_index(_in const dataset::dataframe& tests, _in cons
 	}
 	if (not found) THROW_GAENARI_ERROR("not found label column.");
 
+	// nominal label column, read the string index directly.
+	if (common::is_nominal(tests.columns()[label_index].data_type)) {
+		string_index_map index_map{tests.get_shared_data_const().strings, strings};
+		const size_t rows = tests.rows();
+		actuals.resize(rows);
+		for (size_t row_index=0; row_index<rows; row_index++) actuals[row_index] = index_map.get(tests.get_raw(row_index, label_index).index);
+		return;
+	}
+
 	// get label value as string and index of each rows
 	for (auto& test: tests.iter_string()) {
 		const auto& label_value = test.values[label_index];
@@ -74,7 +74,9 @@ inline std::string tree(_in const decision_tree::tree_node& root, _in const std:
 		ret += ' ' + stringfy::util::get_op(treenode.rule.type) + ' ';
 
 		// value
-		ret += clr.value1 + value_to_string(treenode.rule.args[0], strings, _) + clr.value2;
+		// cmp_other has no value, the grouped rare values.
+		if (treenode.rule.type == decision_tree::rule_t::rule_type::cmp_other) ret += clr.value1 + "<other>" + clr.value2;
+		else ret += clr.value1 + value_to_string(treenode.rule.args[0], strings, _) + clr.value2;
 
 		// leaf node
 		if (treenode.leaf) {
@@ -18,6 +18,7 @@ inline std::string get_op(_in const decision_tree::rule_t::rule_type& ruleype) {
 	if (ruleype == decision_tree::rule_t::rule_type::cmp_lt)  return "<";
 	if (ruleype == decision_tree::rule_t::rule_type::cmp_gt)  return ">";
 	if (ruleype == decision_tree::rule_t::rule_type::cmp_gte) return ">=";
+	if (ruleype == decision_tree::rule_t::rule_type::cmp_other) return "=";
 	return "<err>";
 }
 
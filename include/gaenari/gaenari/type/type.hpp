@@ -101,6 +101,7 @@ enum class value_type {value_type_unknown = 0, value_type_int = 1, value_type_in
 struct value : public value_raw {
 	inline value() {this->index = 0; this->valueype = value_type::value_type_unknown;}
 	inline value(_in const value_raw& v, _in value_type valueype): valueype{valueype} {this->index = v.index;}
+	inline value(_in const value& v): valueype{v.valueype} {this->index = v.index;}
 	inline value(_in const value& v,     _in value_type valueype): valueype{valueype} {this->index = v.index;}
 	inline value(_in const size_t& v):  valueype{value_type::value_type_size_t} {this->index = v;}
 	inline value(_in const double& v):  valueype{value_type::value_type_double} {this->numeric_double = v;}
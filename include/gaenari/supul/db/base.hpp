@@ -232,7 +232,10 @@ public:
   	//		INNER JOIN "treenode"		ON "treenode".id					= "instance_info".ref_leaf_treenode_id
   	//		INNER JOIN "leaf_info"		ON "leaf_info".id					= "treenode".ref_leaf_info_id
 	// WHERE "leaf_info".go_to_ref_generation_id=?
-	virtual auto get_instance_by_go_to_generation_id(_in int64_t go_to_ref_generation_id) -> gaenari::dataset::dataframe = 0;
+	// with spill_path, the memory of dataframe is bounded by memory_budget_bytes.
+	// over the budget, the rows are written to spill_path, and the dataframe is memory mapped.
+	// (the spill file is removed when the dataframe is cleared.)
+	virtual auto get_instance_by_go_to_generation_id(_in int64_t go_to_ref_generation_id, _option_in const std::string& spill_path = "", _option_in size_t memory_budget_bytes = 0) -> gaenari::dataset::dataframe = 0;
 
 	// get_correct_instance_count_by_go_to_generation_id.
 	// SELECT COUNT(*) FROM "instance"
@@ -262,6 +265,22 @@ public:
 	// SELECT ref_generation_id FROM treenode WHERE id=?
 	virtual int64_t get_generation_id_by_treenode_id(_in int64_t treenode_id) = 0;
 
+	// get instances by leaf treenode id.
+	// fieldnames are defined in attributes.json.
+	// SELECT "instance".* FROM "instance"
+	//     INNER JOIN "instance_info" ON "instance".id = "instance_info".ref_instance_id
+	// WHERE "instance_info".ref_leaf_treenode_id=?
+	virtual void get_instance_by_leaf_treenode_id(_in int64_t leaf_treenode_id, _in callback_query cb) = 0;
+
+	// update treenode leaf_info.
+	// set -1 to make a leaf treenode to a non-leaf treenode.
+	// UPDATE treenode SET ref_leaf_info_id=? WHERE id=?
+	virtual void update_treenode_leaf_info_id(_in int64_t treenode_id, _in int64_t ref_leaf_info_id) = 0;
+
+	// delete leaf_info_by_id.
+	// DELETE FROM leaf_info WHERE id=?
+	virtual void delete_leaf_info_by_id(_in int64_t leaf_info_id) = 0;
+
 	// get leaf_info by chunk_id.
 	// SELECT instance."%y" as "instance.actual",
 	//		  instance_info.weak_count as "instance_info.weak_count", 
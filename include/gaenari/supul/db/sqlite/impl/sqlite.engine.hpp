@@ -216,6 +216,14 @@ inline void sqlite_t::execute(_in stmt stmt_type, _in const type::vector_variant
 // ex) select ... from ... where id=? and cars=?
 //     params : {3, 2} (id=3, cars=2)
 inline gaenari::dataset::dataframe sqlite_t::execute(_in stmt stmt_type, _in const type::vector_variant& params) {
+	return execute(stmt_type, params, "", 0);
+}
+
+// same, but the memory of the dataframe is bounded by memory_budget_bytes.
+// over the budget, the rows are spilled to spill_path, and the dataframe is memory mapped.
+// the spill file is removed when the dataframe is cleared.
+// empty spill_path reads the whole rows to memory.
+inline gaenari::dataset::dataframe sqlite_t::execute(_in stmt stmt_type, _in const type::vector_variant& params, _in const std::string& spill_path, _in size_t memory_budget_bytes) {
 	int rc = 0;
 	gaenari::dataset::dataframe df;
 
@@ -245,7 +253,8 @@ inline gaenari::dataset::dataframe sqlite_t::execute(_in stmt stmt_type, _in con
 	repository::context context = {stmt_type, params, this};
 
 	// read from repository.
-	df.read<repository>({}, usecols, &context);
+	if (spill_path.empty()) df.read<repository>({}, usecols, &context);
+	else df.read_spill<repository>({}, usecols, &context, spill_path, memory_budget_bytes);
 
 	// return dataframe.
 	return df;
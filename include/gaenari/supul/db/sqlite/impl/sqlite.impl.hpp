@@ -365,6 +365,29 @@ inline void sqlite_t::build_stmt_pool(void) {
 						stmt_info{get_stmt(sql),
 						schema.fields_include(type::table::treenode, {"ref_generation_id"})}});
 
+	// get instances by leaf treenode id.
+	_names = common::get_names(_instance_table.fields, {}, false, "${instance}", true, "");	// `${instance}."f1" as "f1", ...`
+	sql = schema.get_sql(
+			"SELECT " + _names + " FROM ${instance} " +
+				"INNER JOIN ${instance_info} " "ON ${instance}.id " "= ${instance_info}.ref_instance_id " +
+			"WHERE ${instance_info}.ref_leaf_treenode_id=?"
+	);
+	stmt_pool.insert({	stmt::get_instance_by_leaf_treenode_id,
+						stmt_info{get_stmt(sql),
+						schema.fields_include(type::table::instance, {})}});
+
+	// update treenode leaf_info_id.
+	sql = schema.get_sql("UPDATE ${treenode} SET ref_leaf_info_id=? WHERE id=?");
+	stmt_pool.insert({	stmt::update_treenode_leaf_info_id,
+						stmt_info{get_stmt(sql),
+						{}}});
+
+	// delete leaf_info_by_id.
+	sql = schema.get_sql("DELETE FROM ${leaf_info} WHERE id=?");
+	stmt_pool.insert({	stmt::delete_leaf_info_by_id,
+						stmt_info{get_stmt(sql),
+						{}}});
+
 	// get leaf_info_by_chunk_id.
 	auto& _leaf_info_table = schema.get_table_info(type::table::leaf_info);
 	_names = common::get_names(_leaf_info_table.fields, {}, false, "${leaf_info}", true, "");	// ${leaf_info}."f1" as "f1", ...
@@ -751,12 +774,12 @@ inline void sqlite_t::update_leaf_info_by_go_to_generation_id(_in int64_t genera
 	if (not result.empty()) THROW_SUPUL_INTERNAL_ERROR0;
 }
 
-inline auto sqlite_t::get_instance_by_go_to_generation_id(_in int64_t go_to_ref_generation_id) -> gaenari::dataset::dataframe {
-	// TO_DO:
-	// : if we are unlucky, it may be allocated very large dataframe.
-	//   a capacity limit is required.
+inline auto sqlite_t::get_instance_by_go_to_generation_id(_in int64_t go_to_ref_generation_id, _option_in const std::string& spill_path, _option_in size_t memory_budget_bytes) -> gaenari::dataset::dataframe {
+	// if we are unlucky, it may be allocated very large dataframe.
+	// with spill_path, the rows over memory_budget_bytes are spilled to the file.
 	gaenari::dataset::dataframe df;
-	df = execute(stmt::get_instance_by_go_to_generation_id, {go_to_ref_generation_id});
+	if (spill_path.empty()) df = execute(stmt::get_instance_by_go_to_generation_id, {go_to_ref_generation_id});
+	else df = execute(stmt::get_instance_by_go_to_generation_id, {go_to_ref_generation_id}, spill_path, memory_budget_bytes);
 	return df;
 }
 
@@ -791,6 +814,20 @@ inline int64_t sqlite_t::get_generation_id_by_treenode_id(_in int64_t treenode_i
 	return common::get_variant_int64(result, "ref_generation_id");
 }
 
+inline void sqlite_t::get_instance_by_leaf_treenode_id(_in int64_t leaf_treenode_id, _in callback_query cb) {
+	execute(stmt::get_instance_by_leaf_treenode_id, {leaf_treenode_id}, cb);
+}
+
+inline void sqlite_t::update_treenode_leaf_info_id(_in int64_t treenode_id, _in int64_t ref_leaf_info_id) {
+	auto result = execute(stmt::update_treenode_leaf_info_id, {ref_leaf_info_id, treenode_id}, true);	// order changed!
+	if (not result.empty()) THROW_SUPUL_INTERNAL_ERROR0;
+}
+
+inline void sqlite_t::delete_leaf_info_by_id(_in int64_t leaf_info_id) {
+	auto result = execute(stmt::delete_leaf_info_by_id, {leaf_info_id}, true);
+	if (not result.empty()) THROW_SUPUL_INTERNAL_ERROR0;
+}
+
 inline void sqlite_t::get_leaf_info_by_chunk_id(_in int64_t chunk_id, _in callback_query cb) {
 	execute(stmt::get_leaf_info_by_chunk_id, {chunk_id}, cb);
 }
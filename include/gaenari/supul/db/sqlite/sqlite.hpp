@@ -51,13 +51,16 @@ public:
 	virtual void    update_leaf_info(_in int64_t leaf_info_id, _in int64_t increment_correct_count, _in int64_t increment_total_count);
 	virtual auto    get_weak_treenode(_in double leaf_node_accuracy_upperbound, _in int64_t leaf_node_total_count_lowerbound) -> std::vector<int64_t>;
 	virtual void    update_leaf_info_by_go_to_generation_id(_in int64_t generation_id, _in double leaf_node_accuracy_upperbound, _in int64_t leaf_node_total_count_lowerbound);
-	virtual auto    get_instance_by_go_to_generation_id(_in int64_t go_to_ref_generation_id) -> gaenari::dataset::dataframe;
+	virtual auto    get_instance_by_go_to_generation_id(_in int64_t go_to_ref_generation_id, _option_in const std::string& spill_path = "", _option_in size_t memory_budget_bytes = 0) -> gaenari::dataset::dataframe;
 	virtual auto    get_correct_instance_count_by_go_to_generation_id(_in int64_t go_to_ref_generation_id) -> int64_t;
 	virtual void    update_instance_info_with_weak_count_increment(_in int64_t instance_id, _in int64_t ref_leaf_treenode_id, _in bool correct);
 	virtual int64_t get_root_ref_treenode_id(_in int64_t generation_id);
 	virtual int64_t copy_rule(_in int64_t src_rule_id);
 	virtual void    update_rule_value_integer(_in int64_t rule_id, _in int64_t value_integer);
 	virtual int64_t get_generation_id_by_treenode_id(_in int64_t treenode_id);
+	virtual void    get_instance_by_leaf_treenode_id(_in int64_t leaf_treenode_id, _in callback_query cb);
+	virtual void    update_treenode_leaf_info_id(_in int64_t treenode_id, _in int64_t ref_leaf_info_id);
+	virtual void    delete_leaf_info_by_id(_in int64_t leaf_info_id);
 	virtual void	get_leaf_info_by_chunk_id(_in int64_t chunk_id, _in callback_query cb);
 	virtual int64_t	get_total_count_by_chunk_id(_in int64_t chunk_id);
 	virtual void	delete_instance_by_chunk_id(_in int64_t chunk_id);
@@ -93,6 +96,7 @@ protected:
 	auto execute(_in stmt stmt_type, _in const type::vector_variant& params, _option_in bool error_on_multiple_row) -> type::map_variant;
 	void execute(_in stmt stmt_type, _in const type::vector_variant& params, _out std::vector<type::map_variant>& results, _option_in size_t max_row_counts = 1024);
 	auto execute(_in stmt stmt_type, _in const type::vector_variant& params) -> gaenari::dataset::dataframe;
+	auto execute(_in stmt stmt_type, _in const type::vector_variant& params, _in const std::string& spill_path, _in size_t memory_budget_bytes) -> gaenari::dataset::dataframe;
 	auto execute_column_based(_in stmt stmt_type, _in const type::vector_variant& params) -> std::unordered_map<std::string, std::vector<type::value_variant>>;
 
 	// only one column is returned as a vector of a specific name and type.
@@ -46,6 +46,9 @@ enum class stmt {
 	copy_rule,
 	update_rule_value_integer,
 	get_generation_id_by_treenode_id,
+	get_instance_by_leaf_treenode_id,
+	update_treenode_leaf_info_id,
+	delete_leaf_info_by_id,
 	get_leaf_info_by_chunk_id,
 	get_total_count_by_chunk_id,
 	delete_instance_by_chunk_id,
@@ -0,0 +1,636 @@
+#ifndef HEADER_GAENARI_SUPUL_SNAPSHOT_SNAPSHOT_HPP
+#define HEADER_GAENARI_SUPUL_SNAPSHOT_SNAPSHOT_HPP
+
+// flattened generational forest of supul.
+//
+// the model is a forest of generations stored across treenode, rule, leaf_info and generation tables.
+// predict walks the childs of a treenode, and a go_to_generation leaf jumps to the root of another generation.
+// (see supul_t::model::predict_main(...))
+// forest flattens it to one node array, and the jumps are resolved to the childs of the target root.
+//
+//   treenode                                 forest nodes
+//                                            index : 0      1      2      3      4
+//   generation 1      generation 2                  [root] [a<=3] [a>3] [b==1] [b==2]
+//   [root]            [root]                          |      ^      |     ^
+//    ├ a <= 3 : leaf   ├ b == 1 : leaf                '------'      '-----' childs of the root of generation 2
+//    └ a >  3 : go_to  └ b == 2 : leaf
+//
+// - a go_to_generation node has both the childs of the target root and its leaf info.
+//   if no child is matched after the jump, its leaf info is the result. (predict_status::middle_node)
+// - the childs of a nominal split(`==` of the same integer feature, and cmp_other) are sorted by value,
+//   and the matched child is found by binary search.
+// - the cmp_other child is the last child, and matched when no sibling is matched.
+// - the row is pre-typed by feature index. (the order of attributes.json fields without `id`)
+//
+// snapshot file.
+//
+// forest::write(...) writes the nodes, the leaves, the features and the string table to one read-only file.
+// mapped_forest maps the file, and predicts without the database and the treenode cache.
+//
+//   offset          | content
+//   ----------------+----------------------------------------------------------------------
+//   0               | header. (file_header, 96 bytes)
+//   96              | features. {field type(4), name length(4), name(...)} * feature count, y name length(4), y name(...)
+//   nodes offset    | nodes. node count * node. (64-byte aligned)
+//   leaves offset   | leaves. leaf count * leaf.
+//   strings offset  | string table. (see gaenari::common::mapped_strings)
+//   ----------------+----------------------------------------------------------------------
+//
+// the values are in the native byte order, so the file is for the machines of the same platform.
+//
+// supul.api.model.export_snapshot("/temp/model.snapshot");
+// ...
+// supul::snapshot::mapped_forest f;
+// f.open("/temp/model.snapshot");
+// auto result = f.predict({{"age", "30"}, {"car", "sedan"}});
+
+namespace supul {
+namespace snapshot {
+
+// one node. (plain old data, 32 bytes)
+struct node {
+	union {
+		int64_t integer;		// value_type 0.
+		double  real;			// value_type 1.
+	} value;					// rule value.
+	uint32_t child_begin;		// index of the first child.
+	uint32_t child_count;		// child count. 0 means leaf.
+	uint32_t leaf;				// index of leaves. none if not leaf or go_to_generation.
+	int32_t  feature_index;		// feature index of the rule.
+	uint8_t  rule_type;			// rule_t::rule_type.
+	uint8_t  value_type;		// 0: integer, 1: real.
+	uint8_t  nominal;			// childs are nominal split sorted by value.integer.
+	uint8_t  reserved[5];
+
+	static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+};
+
+// leaf info of a leaf or go_to_generation node. (plain old data, 48 bytes)
+struct leaf {
+	int64_t treenode_id;
+	int64_t leaf_info_id;
+	int64_t correct_count;
+	int64_t total_count;
+	double  accuracy;
+	int32_t label_index;
+	uint8_t type;				// type::leaf_info_type.
+	uint8_t reserved[3];
+};
+
+static_assert(sizeof(node) == 32, "invalid snapshot::node size.");
+static_assert(sizeof(leaf) == 48, "invalid snapshot::leaf size.");
+
+// pre-typed value of a row.
+// integer for INTEGER, BIGINT, SMALLINT, TINYINT and TEXT_ID(string table id), real for REAL.
+struct value {
+	union {
+		int64_t integer;
+		double  real;
+	};
+	bool exist;
+};
+
+struct feature {
+	std::string name;
+	type::field_type type = type::field_type::UNKNOWN;
+};
+
+// predict result.
+// - leaf_node   : matched is the leaf.
+// - middle_node : matched is the last go_to_generation node.
+// - not_found   : matched is nullptr.
+struct result {
+	type::predict_status status = type::predict_status::unknown;
+	const leaf* matched = nullptr;
+};
+
+// predict on the node array whose nodes[0] is root.
+// it's shared by forest and the memory mapped nodes of a snapshot file.
+// exception if a feature of the matching rule does not exist in row.
+inline result predict(_in const node* nodes, _in const leaf* leaves, _in const feature* features, _in const value* row);
+
+// in-memory forest.
+class forest {
+public:
+	forest()  = default;
+	~forest() = default;
+
+	using get_childs_t = std::function<std::vector<type::treenode_db>(_in int64_t parent_treenode_id)>;
+	using get_root_t   = std::function<int64_t(_in int64_t generation_id)>;
+
+public:
+	// flatten the forest from the first root treenode.
+	// - features   : the fields of attributes.json without `id`. (index is the feature index of rules)
+	// - get_childs : childs of a treenode.
+	// - get_root   : root treenode id of a generation.
+	void build(_in int64_t root_treenode_id, _in const std::vector<feature>& features, _in const std::string& y_name, _in const get_childs_t& get_childs, _in const get_root_t& get_root);
+
+	void clear(void);
+	bool empty(void) const;
+
+	// predict with pre-typed row. (features.size() items)
+	result predict(_in const value* row) const;
+
+	// convert (name, value) map of supul to pre-typed row.
+	// names not in the features are ignored, and the missing features do not exist in row.
+	// exception(invalid data type) if the variant type does not match the field type.
+	void get_typed_row(_in const type::map_variant& x, _out std::vector<value>& row) const;
+
+	// write to a snapshot file. strings is the string table of supul.
+	void write(_in const std::string& path, _in const gaenari::common::string_table& strings) const;
+
+public:
+	std::vector<node> nodes;		// nodes[0] is root.
+	std::vector<leaf> leaves;
+	std::vector<feature> features;
+	std::string y_name;
+};
+
+// memory mapped snapshot file.
+class mapped_forest {
+public:
+	mapped_forest()  = default;
+	~mapped_forest() {close();}
+	mapped_forest(const mapped_forest&) = delete;
+	mapped_forest& operator=(const mapped_forest&) = delete;
+
+	static constexpr char     magic[8] = {'S','P','L','S','N','A','P','\0'};
+	static constexpr uint32_t version = 1;
+	static constexpr uint32_t byte_order = 0x01020304;
+	static constexpr size_t   node_alignment = 64;
+
+	struct file_header {
+		char     magic[8];
+		uint32_t version;
+		uint32_t byte_order;		// detects the file of a different byte order.
+		uint32_t node_size;			// sizeof(node)
+		uint32_t leaf_size;			// sizeof(leaf)
+		uint32_t feature_count;
+		uint32_t reserved;
+		uint64_t node_count;
+		uint64_t leaf_count;
+		uint64_t string_count;
+		uint64_t features_offset;
+		uint64_t nodes_offset;
+		uint64_t leaves_offset;
+		uint64_t strings_offset;
+		uint64_t file_size;
+	};
+
+public:
+	// map the snapshot file.
+	// - verify : check the child ranges, the leaf indexes and the rule types of all nodes.
+	//            it reads all nodes once, set false for a trusted file to be loaded without reading the nodes.
+	void open(_in const std::string& path, _in bool verify = true);
+
+	// unmap.
+	void close(void);
+
+	inline bool is_open(void) const {return nodes != nullptr;}
+
+	// predict with pre-typed row. (get_features().size() items)
+	result predict(_in const value* row) const;
+
+	// predict with (name, value) map like supul.api.model.predict(...).
+	// the value of map is a string, which is converted to a value according to the field type.
+	// on error, error is set with errormsg.
+	auto predict(_in const std::unordered_map<std::string, std::string>& x) const noexcept -> type::predict_result;
+
+	// convert (name, value) map to pre-typed row.
+	// names not in the features are ignored, and the missing features do not exist in row.
+	void get_typed_row(_in const std::unordered_map<std::string, std::string>& x, _out std::vector<value>& row) const;
+
+	// string of the string table id. (ex: label index)
+	std::string get_string(_in int64_t id) const;
+
+	inline const std::vector<feature>& get_features(void) const {return features;}
+	inline const std::string& get_y_name(void) const {return y_name;}
+	inline size_t node_count(void) const {return nodes_size;}
+
+protected:
+	gaenari::common::mapped_file file;
+	gaenari::common::mapped_strings strings;
+	const node* nodes = nullptr;		// points the mapped memory.
+	const leaf* leaves = nullptr;		// points the mapped memory.
+	size_t nodes_size = 0;
+	std::vector<feature> features;
+	std::string y_name;
+};
+
+static_assert(sizeof(mapped_forest::file_header) == 96, "invalid mapped_forest::file_header size.");
+
+// implementation.
+
+namespace detail {
+
+// value_type of a field type. 0: integer, 1: real.
+inline int get_value_type(_in type::field_type t) {
+	switch (t) {
+	case type::field_type::INTEGER:
+	case type::field_type::BIGINT:
+	case type::field_type::SMALLINT:
+	case type::field_type::TINYINT:
+	case type::field_type::TEXT_ID:
+		return 0;
+	case type::field_type::REAL:
+		return 1;
+	default:
+		break;
+	}
+	return -1;
+}
+
+// convert (name, value) map to pre-typed row.
+// names not in the features are ignored, and the missing features do not exist in row.
+// the value of the map is converted by to_integer(feature, value) or to_real(feature, value) according to the field type.
+// it's shared by forest(variant value) and mapped_forest(string value).
+template <typename map_t, typename to_integer_t, typename to_real_t>
+inline void get_typed_row(_in const std::vector<feature>& features, _in const map_t& x, _in const to_integer_t& to_integer, _in const to_real_t& to_real, _out std::vector<value>& row) {
+	row.assign(features.size(), value{});
+	for (size_t i=0; i<features.size(); i++) {
+		const auto& f = features[i];
+		auto find = x.find(f.name);
+		if (find == x.end()) continue;
+		auto& v = row[i];
+		switch (get_value_type(f.type)) {
+		case 0:
+			v.integer = to_integer(f, find->second);
+			break;
+		case 1:
+			v.real = to_real(f, find->second);
+			break;
+		default:
+			THROW_SUPUL_INVALID_DATA_TYPE(f.name);
+		}
+		v.exist = true;
+	}
+}
+
+inline bool match(_in const node& n, _in const value& v) {
+	using rule_type = gaenari::method::decision_tree::rule_t::rule_type;
+	const auto r = static_cast<rule_type>(n.rule_type);
+	if (n.value_type == 0) {
+		switch (r) {
+		case rule_type::cmp_equ:   return v.integer == n.value.integer;
+		case rule_type::cmp_lte:   return v.integer <= n.value.integer;
+		case rule_type::cmp_lt:    return v.integer <  n.value.integer;
+		case rule_type::cmp_gt:    return v.integer >  n.value.integer;
+		case rule_type::cmp_gte:   return v.integer >= n.value.integer;
+		case rule_type::cmp_other: return true;
+		default: break;
+		}
+	} else {
+		switch (r) {
+		case rule_type::cmp_equ:   return v.real == n.value.real;
+		case rule_type::cmp_lte:   return v.real <= n.value.real;
+		case rule_type::cmp_lt:    return v.real <  n.value.real;
+		case rule_type::cmp_gt:    return v.real >  n.value.real;
+		case rule_type::cmp_gte:   return v.real >= n.value.real;
+		default: break;
+		}
+	}
+	THROW_SUPUL_INTERNAL_ERROR0;
+}
+
+} // detail
+
+inline result predict(_in const node* nodes, _in const leaf* leaves, _in const feature* features, _in const value* row) {
+	using rule_type = gaenari::method::decision_tree::rule_t::rule_type;
+	result ret;
+	const leaf* last_matched = nullptr;
+	const node* current = nodes;
+
+	for (;;) {
+		// which child is matched?
+		const node* child = nodes + current->child_begin;
+		const node* end   = child + current->child_count;
+		const node* other = (end[-1].rule_type == static_cast<uint8_t>(rule_type::cmp_other)) ? end - 1 : end;
+		const value& v = row[child->feature_index];
+		if (not v.exist) THROW_SUPUL_ERROR1("field not found: %0.", features[child->feature_index].name);
+		if (current->nominal) {
+			// binary search by value.
+			child = std::lower_bound(child, other, v.integer, [](const node& n, int64_t i) {return n.value.integer < i;});
+			if ((child == other) or (child->value.integer != v.integer)) child = other;
+		} else {
+			for (; child != other; child++) {
+				const value& cv = row[child->feature_index];
+				if (not cv.exist) THROW_SUPUL_ERROR1("field not found: %0.", features[child->feature_index].name);
+				if (detail::match(*child, cv)) break;
+			}
+		}
+
+		if (child == end) {
+			// oh, no matching.
+			// not found, or found it in the middle of generation.
+			ret.status  = last_matched ? type::predict_status::middle_node : type::predict_status::not_found;
+			ret.matched = last_matched;
+			return ret;
+		}
+
+		// non-leaf node, go to matched child.
+		if (child->leaf == node::none) {
+			current = child;
+			continue;
+		}
+
+		// leaf node, last choice or generation move.
+		const leaf& l = leaves[child->leaf];
+		if (l.type == static_cast<uint8_t>(type::leaf_info_type::leaf)) {
+			ret.status  = type::predict_status::leaf_node;
+			ret.matched = &l;
+			return ret;
+		}
+
+		// go to generation. the childs are the childs of the target root.
+		last_matched = &l;
+		current = child;
+	}
+}
+
+inline void forest::build(_in int64_t root_treenode_id, _in const std::vector<feature>& features, _in const std::string& y_name, _in const get_childs_t& get_childs, _in const get_root_t& get_root) {
+	using rule_type = gaenari::method::decision_tree::rule_t::rule_type;
+	std::deque<std::pair<size_t, int64_t>> queue;						// (node index, treenode id whose childs are the childs of the node)
+	std::unordered_map<int64_t, std::pair<uint32_t, uint32_t>> ranges;	// treenode id -> (child_begin, child_count)
+
+	clear();
+	this->features = features;
+	this->y_name   = y_name;
+
+	// root has no rule.
+	node root;
+	memset(&root, 0, sizeof(root));
+	root.leaf = node::none;
+	nodes.push_back(root);
+	queue.emplace_back(0, root_treenode_id);
+
+	// breadth-first order.
+	while (not queue.empty()) {
+		const auto [index, treenode_id] = queue.front();
+		queue.pop_front();
+
+		// the same generation root is shared by go_to_generation nodes.
+		auto find = ranges.find(treenode_id);
+		if (find != ranges.end()) {
+			nodes[index].child_begin = find->second.first;
+			nodes[index].child_count = find->second.second;
+			continue;
+		}
+
+		auto childs = get_childs(treenode_id);
+		if (childs.empty()) THROW_SUPUL_INTERNAL_ERROR0;
+		if (nodes.size() + childs.size() > node::none) THROW_SUPUL_ERROR("too many treenodes for snapshot.");
+
+		// the cmp_other child goes to the last.
+		std::stable_partition(childs.begin(), childs.end(), [](const type::treenode_db& t) {return t.rule.rule_type != static_cast<int>(rule_type::cmp_other);});
+		const size_t other_count = (childs.back().rule.rule_type == static_cast<int>(rule_type::cmp_other)) ? 1 : 0;
+		if ((other_count == 1) and (childs.size() >= 2) and (childs[childs.size() - 2].rule.rule_type == static_cast<int>(rule_type::cmp_other))) THROW_SUPUL_INTERNAL_ERROR0;
+
+		// nominal split with many childs, sorted by value for binary search.
+		// stable, the first child is kept when the values are duplicated, like the linear scan.
+		bool nominal = (childs.size() >= type::treenode_childs::nominal_index_min_childs);
+		for (size_t i=0; nominal and (i<childs.size()-other_count); i++) {
+			const auto& rule = childs[i].rule;
+			if ((rule.rule_type != static_cast<int>(rule_type::cmp_equ)) or (rule.value_type != 0) or (rule.feature_index != childs[0].rule.feature_index)) nominal = false;
+		}
+		if (nominal) std::stable_sort(childs.begin(), childs.end() - other_count, [](const type::treenode_db& a, const type::treenode_db& b) {return a.rule.value_integer < b.rule.value_integer;});
+
+		const auto begin = static_cast<uint32_t>(nodes.size());
+		const auto count = static_cast<uint32_t>(childs.size());
+		ranges[treenode_id] = {begin, count};
+		nodes[index].child_begin = begin;
+		nodes[index].child_count = count;
+		nodes[index].nominal     = nominal ? 1 : 0;
+
+		for (const auto& child: childs) {
+			// rule.
+			const auto& rule = child.rule;
+			if ((rule.feature_index < 0) or (static_cast<size_t>(rule.feature_index) >= features.size())) THROW_SUPUL_INTERNAL_ERROR0;
+			if ((rule.rule_type <= static_cast<int>(rule_type::unknown)) or (rule.rule_type > static_cast<int>(rule_type::cmp_other))) THROW_SUPUL_INTERNAL_ERROR0;
+			const auto& f = features[rule.feature_index];
+			if (detail::get_value_type(f.type) != rule.value_type) THROW_SUPUL_INVALID_DATA_TYPE(f.name);
+			if ((rule.value_type == 1) and (rule.rule_type == static_cast<int>(rule_type::cmp_other))) THROW_SUPUL_INVALID_DATA_TYPE(f.name);
+			node n;
+			memset(&n, 0, sizeof(n));
+			if (rule.value_type == 0) n.value.integer = rule.value_integer;
+			else n.value.real = rule.value_real;
+			n.feature_index = rule.feature_index;
+			n.rule_type     = static_cast<uint8_t>(rule.rule_type);
+			n.value_type    = static_cast<uint8_t>(rule.value_type);
+			n.leaf          = node::none;
+
+			if (not child.is_leaf_node) {
+				// childs of the treenode.
+				queue.emplace_back(nodes.size(), child.id);
+			} else {
+				const auto& info = child.leaf_info;
+				leaf l;
+				memset(&l, 0, sizeof(l));
+				l.treenode_id   = child.id;
+				l.leaf_info_id  = info.id;
+				l.correct_count = info.correct_count;
+				l.total_count   = info.total_count;
+				l.accuracy      = info.accuracy;
+				l.label_index   = info.label_index;
+				l.type          = static_cast<uint8_t>(info.type);
+				if (leaves.size() >= node::none) THROW_SUPUL_ERROR("too many treenodes for snapshot.");
+				n.leaf = static_cast<uint32_t>(leaves.size());
+				leaves.push_back(l);
+				// go to generation, the childs of the target root.
+				if (info.type == type::leaf_info_type::go_to_generation) queue.emplace_back(nodes.size(), get_root(info.go_to_ref_generation_id));
+				else if (info.type != type::leaf_info_type::leaf) THROW_SUPUL_INTERNAL_ERROR0;
+			}
+			nodes.push_back(n);
+		}
+	}
+}
+
+inline void forest::clear(void) {
+	nodes.clear();
+	leaves.clear();
+	features.clear();
+	y_name.clear();
+}
+
+inline bool forest::empty(void) const {
+	return nodes.empty();
+}
+
+inline result forest::predict(_in const value* row) const {
+	if (nodes.empty()) THROW_SUPUL_ERROR("snapshot is not built.");
+	return snapshot::predict(nodes.data(), leaves.data(), features.data(), row);
+}
+
+inline void forest::get_typed_row(_in const type::map_variant& x, _out std::vector<value>& row) const {
+	if (nodes.empty()) THROW_SUPUL_ERROR("snapshot is not built.");
+	auto to_integer = [](_in const feature& f, _in const type::value_variant& v) {
+		if (v.index() != 1) THROW_SUPUL_INVALID_DATA_TYPE(f.name);
+		return std::get<1>(v);
+	};
+	auto to_real = [](_in const feature& f, _in const type::value_variant& v) {
+		if (v.index() != 2) THROW_SUPUL_INVALID_DATA_TYPE(f.name);
+		return std::get<2>(v);
+	};
+	detail::get_typed_row(features, x, to_integer, to_real, row);
+}
+
+inline void forest::write(_in const std::string& path, _in const gaenari::common::string_table& strings) const {
+	using header_t = mapped_forest::file_header;
+	gaenari::common::binary_file_writer file;
+	header_t header;
+	memset(&header, 0, sizeof(header));
+
+	if (nodes.empty()) THROW_SUPUL_ERROR("snapshot is not built.");
+	if (not file.open(path, sizeof(header))) THROW_SUPUL_ERROR("fail to create snapshot file: " + path);
+
+	// features.
+	header.features_offset = static_cast<uint64_t>(file.tell());
+	for (const auto& f: features) {
+		file.write_value(static_cast<uint32_t>(f.type));
+		file.write_string(f.name);
+	}
+	file.write_string(y_name);
+
+	// nodes and leaves.
+	header.nodes_offset = static_cast<uint64_t>(file.padding(mapped_forest::node_alignment));
+	file.write_bytes(nodes.data(), sizeof(node) * nodes.size());
+	header.leaves_offset = static_cast<uint64_t>(file.tell());
+	file.write_bytes(leaves.data(), sizeof(leaf) * leaves.size());
+
+	// strings.
+	header.string_count = static_cast<uint64_t>(file.write_strings(strings, header.strings_offset));
+
+	// complete the header.
+	memcpy(header.magic, mapped_forest::magic, sizeof(header.magic));
+	header.version       = mapped_forest::version;
+	header.byte_order    = mapped_forest::byte_order;
+	header.node_size     = static_cast<uint32_t>(sizeof(node));
+	header.leaf_size     = static_cast<uint32_t>(sizeof(leaf));
+	header.feature_count = static_cast<uint32_t>(features.size());
+	header.node_count    = static_cast<uint64_t>(nodes.size());
+	header.leaf_count    = static_cast<uint64_t>(leaves.size());
+	if (not file.close(header)) THROW_SUPUL_ERROR("fail to write snapshot file: " + path);
+}
+
+inline void mapped_forest::open(_in const std::string& path, _in bool verify) {
+	using rule_type = gaenari::method::decision_tree::rule_t::rule_type;
+	close();
+	file.open(path);
+
+	const auto* base = static_cast<const char*>(file.data());
+	const size_t size = file.size();
+	gaenari::common::binary_file_reader reader(base, size);
+	auto invalid = [&](void) {close(); THROW_SUPUL_ERROR("invalid snapshot file: " + path);};
+
+	// header.
+	file_header header;
+	switch (reader.read_header(magic, version, byte_order, header)) {
+	case gaenari::common::binary_file_status::ok:
+		break;
+	case gaenari::common::binary_file_status::not_supported_version:
+		close(); THROW_SUPUL_ERROR1("not supported snapshot file version: %0.", header.version);
+	case gaenari::common::binary_file_status::different_byte_order:
+		close(); THROW_SUPUL_ERROR("snapshot file of a different platform: " + path);
+	default:
+		invalid();
+	}
+	if ((header.node_size != sizeof(node)) or (header.leaf_size != sizeof(leaf))) {close(); THROW_SUPUL_ERROR("snapshot file of a different platform: " + path);}
+	if ((header.node_count == 0) or (header.nodes_offset % node_alignment != 0)) invalid();
+	if ((header.features_offset > header.nodes_offset) or (header.nodes_offset > header.leaves_offset) or (header.leaves_offset > header.strings_offset) or (header.strings_offset > size)) invalid();
+	if ((header.leaves_offset - header.nodes_offset) / sizeof(node) < header.node_count) invalid();
+	if ((header.strings_offset - header.leaves_offset) / sizeof(leaf) < header.leaf_count) invalid();
+
+	// features.
+	reader.seek(header.features_offset, header.nodes_offset);
+	for (uint32_t i=0; i<header.feature_count; i++) {
+		feature f;
+		uint32_t t = 0;
+		if ((not reader.read_value(t)) or (not reader.read_string(f.name))) invalid();
+		f.type = static_cast<type::field_type>(t);
+		features.push_back(std::move(f));
+	}
+	if (not reader.read_string(y_name)) invalid();
+
+	// strings.
+	if (not reader.attach_strings(strings, header.strings_offset, header.string_count)) invalid();
+
+	// nodes and leaves.
+	nodes  = reinterpret_cast<const node*>(base + header.nodes_offset);
+	leaves = reinterpret_cast<const leaf*>(base + header.leaves_offset);
+	nodes_size = static_cast<size_t>(header.node_count);
+	if (verify) {
+		for (size_t i=0; i<nodes_size; i++) {
+			const auto& n = nodes[i];
+			if (i > 0) {
+				if ((n.feature_index < 0) or (static_cast<size_t>(n.feature_index) >= features.size())) invalid();
+				if ((n.rule_type <= static_cast<uint8_t>(rule_type::unknown)) or (n.rule_type > static_cast<uint8_t>(rule_type::cmp_other))) invalid();
+				if (static_cast<int>(n.value_type) != detail::get_value_type(features[n.feature_index].type)) invalid();
+			}
+			if ((n.leaf != node::none) and (n.leaf >= header.leaf_count)) invalid();
+			if ((n.child_count == 0) and (n.leaf == node::none)) invalid();
+			if ((n.child_count > 0) and (n.child_begin + static_cast<size_t>(n.child_count) > nodes_size)) invalid();
+			if ((n.child_count == 0) and (leaves[n.leaf].type != static_cast<uint8_t>(type::leaf_info_type::leaf))) invalid();
+		}
+	}
+}
+
+inline void mapped_forest::close(void) {
+	file.close();
+	strings.detach();
+	nodes = nullptr;
+	leaves = nullptr;
+	nodes_size = 0;
+	features.clear();
+	y_name.clear();
+}
+
+inline result mapped_forest::predict(_in const value* row) const {
+	if (not nodes) THROW_SUPUL_ERROR("snapshot file is not opened.");
+	return snapshot::predict(nodes, leaves, features.data(), row);
+}
+
+inline auto mapped_forest::predict(_in const std::unordered_map<std::string, std::string>& x) const noexcept -> type::predict_result {
+	type::predict_result ret;
+	try {
+		std::vector<value> row;
+		get_typed_row(x, row);
+		auto r = predict(row.data());
+		if (r.status == type::predict_status::not_found) THROW_SUPUL_RULE_NOT_MATCHED_ERROR("no rule matched.");
+		if (not r.matched) THROW_SUPUL_INTERNAL_ERROR0;
+
+		// set ret.
+		ret.label_index   = r.matched->label_index;
+		ret.label         = get_string(r.matched->label_index);
+		ret.correct_count = r.matched->correct_count;
+		ret.total_count   = r.matched->total_count;
+		ret.accuracy      = r.matched->accuracy;
+		return ret;
+	} catch(...) {
+		ret.clear();
+		ret.error = true;
+		ret.errormsg = exceptions::catch_all();
+		return ret;
+	}
+}
+
+inline void mapped_forest::get_typed_row(_in const std::unordered_map<std::string, std::string>& x, _out std::vector<value>& row) const {
+	if (not nodes) THROW_SUPUL_ERROR("snapshot file is not opened.");
+	if (x.empty()) THROW_SUPUL_ERROR("empty data.");
+	auto to_integer = [this](_in const feature& f, _in const std::string& s) {
+		if (f.type != type::field_type::TEXT_ID) return static_cast<int64_t>(std::stoll(s));
+		const auto id = strings.get_id(s);
+		if (id == std::numeric_limits<size_t>::max()) THROW_SUPUL_ERROR1("not found in string table: %0.", s);
+		return static_cast<int64_t>(id);
+	};
+	auto to_real = [](_in const feature& /*f*/, _in const std::string& s) {return std::stod(s);};
+	detail::get_typed_row(features, x, to_integer, to_real, row);
+}
+
+inline std::string mapped_forest::get_string(_in int64_t id) const {
+	if (id < 0) THROW_SUPUL_ERROR1("not found string table id(%0).", id);
+	return strings.get_string(static_cast<size_t>(id));
+}
+
+} // snapshot
+} // supul
+
+#endif // HEADER_GAENARI_SUPUL_SNAPSHOT_SNAPSHOT_HPP
@@ -29,6 +29,9 @@
 #include "db/sqlite/sqlite.type.hpp"
 #include "db/sqlite/sqlite.hpp"
 
+// snapshot.
+#include "snapshot/snapshot.hpp"
+
 // supul.
 #include "supul/supul.hpp"
 
@@ -227,6 +227,22 @@ inline auto supul_t::api::model::predict(_in const std::unordered_map<std::strin
 	}
 }
 
+// export the current model to one read-only snapshot file.
+// all go_to_generation links are resolved, and snapshot::mapped_forest predicts from the file
+// without opening the database.
+// it takes as long as the size of the current model.
+inline bool supul_t::api::model::export_snapshot(_in const std::string& file_path) noexcept {
+	common::function_logger l{__func__, "model"};
+	try {
+		api.supul.model.export_snapshot(file_path);
+		return true;
+	} catch(...) {
+		l.failed();
+		api.errormsg = exceptions::catch_all();
+		return false;
+	}
+}
+
 // returns the report as a json string.
 // option format:
 // {
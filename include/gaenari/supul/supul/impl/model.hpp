@@ -131,10 +131,41 @@ inline void supul_t::model::insert_chunk_csv(_in const std::string& csv_file_pat
 	transaction.commit();
 	gaenari::logger::info("completed to save({0} row(s)).", {row_count});
 
+	// chunk_limit(...) changed the leaf counts.
+	if (use) refresh_forest();
+
 	// success.
 	return;
 }
 
+// declare before update() for auto return.
+// online split of weak leaf treenodes in update(). (hoeffding tree)
+inline auto supul_t::model::get_hoeffding_condition(void) {
+	struct ret_t {
+		bool	use				= false;
+		double	weak_accuracy	= 0.0;	// model.weak_treenode_condition.accuracy.
+		int64_t	grace_period	= 0;
+		double	delta			= 0.0;
+		double	tie_threshold	= 0.0;
+		int64_t	min_instances	= 2;	// same as build and rebuild.
+		int64_t	nominal_min_support = 0;	// model.train.nominal_min_support.
+	} ret;
+
+	// get values.
+	// the property is not reloaded, it's read with the other conditions. (open, insert_chunk_csv and rebuild reload it)
+	ret.use = supul.prop.get("model.hoeffding.use", false);
+	if (not ret.use) return ret;
+	ret.weak_accuracy	= supul.prop.get("model.weak_treenode_condition.accuracy", -1.1);
+	ret.grace_period	= supul.prop.get("model.hoeffding.grace_period", 200LL);
+	ret.delta			= supul.prop.get("model.hoeffding.delta", 0.0000001);
+	ret.tie_threshold	= supul.prop.get("model.hoeffding.tie_threshold", 0.05);
+	ret.nominal_min_support = supul.prop.get("model.train.nominal_min_support", 0LL);
+	if (ret.weak_accuracy < 0) THROW_SUPUL_ERROR("invalid weak_treenode_condition.");
+	if ((ret.grace_period <= 0) or (ret.delta <= 0.0) or (ret.delta >= 1.0) or (ret.tie_threshold < 0.0)) THROW_SUPUL_ERROR("invalid model.hoeffding condition.");
+	if (ret.nominal_min_support < 0) THROW_SUPUL_ERROR("invalid model.train.nominal_min_support.");
+	return ret;
+}
+
 inline void supul_t::model::update(void) {
 	bool build_first_tree_completed = false;
 	int64_t increment_total_count = 0;
@@ -145,6 +176,12 @@ inline void supul_t::model::update(void) {
 	// (leaf_info.id, (increment correct_count, increment total_count)) map.
 	std::unordered_map<int64_t, std::pair<int64_t, int64_t>> increment_count;
 
+	// online split.
+	// sufficient statistics of weak leaf treenodes, and weak leaf treenodes touched in a chunk.
+	std::unordered_map<int64_t, type::leaf_statistics> leaf_statistics;	// [leaf treenode id] = statistics.
+	std::map<int64_t, type::treenode_db> touched_leaf_treenodes;			// [leaf treenode id] = leaf treenode.
+	std::vector<type::field_type> feature_types;
+
 	// transaction begin.
 	db::transaction_guard transaction{get_db(), true};
 
@@ -164,6 +201,12 @@ inline void supul_t::model::update(void) {
 		build_first_tree_completed = true;
 	}
 
+	// online split is not needed on the first tree.
+	// it has just been trained with all instances.
+	auto hoeffding = get_hoeffding_condition();
+	bool online_split = hoeffding.use and (not build_first_tree_completed);
+	if (online_split) feature_types = get_feature_types();
+
 	// get instances that have not yet been updated with a query.
 	// callback, not dataframe.
 	for (auto& chunk_id: not_updated_chunk_ids) {
@@ -171,7 +214,8 @@ inline void supul_t::model::update(void) {
 		int64_t total_count = 0;
 
 		// instances loop in chunk.
-		get_db().get_instance_by_chunk_id(chunk_id, [&supul=supul, &increment_count, &correct_count, &total_count, &confusion_matrix](auto& row) -> bool {
+		get_db().get_instance_by_chunk_id(chunk_id, [&supul=supul, &increment_count, &correct_count, &total_count, &confusion_matrix,
+													 online_split, &hoeffding, &feature_types, &leaf_statistics, &touched_leaf_treenodes](auto& row) -> bool {
 			// predict instance and get its leaf node.
 			auto instance_id = common::get_variant_int64(row, "id");
 			bool middle_leaf_by_not_matched = false;
@@ -208,6 +252,14 @@ inline void supul_t::model::update(void) {
 				}
 			}
 
+			// count the statistics of weak leaf treenode.
+			// the statistics of a newly touched leaf treenode are read from the database after the chunk.
+			if (online_split and (not new_leaf_node_added) and (leaf_treenode.leaf_info.accuracy <= hoeffding.weak_accuracy)) {
+				auto find = leaf_statistics.find(leaf_treenode.id);
+				if (find != leaf_statistics.end()) supul.model.add_leaf_statistics(feature_types, row, find->second);
+				touched_leaf_treenodes[leaf_treenode.id] = leaf_treenode;
+			}
+
 			return true;
 		});
 
@@ -227,6 +279,35 @@ inline void supul_t::model::update(void) {
 		// set increment values.
 		increment_total_count += total_count;
 		increment_total_correct_count += correct_count;
+
+		// online split of touched weak leaf treenodes.
+		// the instances of the chunk are already routed, so they are not changed in the middle of the query.
+		for (const auto& it: touched_leaf_treenodes) {
+			const auto& leaf = it.second;
+			auto find = leaf_statistics.find(leaf.id);
+			if (find == leaf_statistics.end()) {
+				// first touch. read all instances of the leaf treenode, including this chunk.
+				auto& statistics = leaf_statistics[leaf.id];
+				statistics.feature_count.resize(feature_types.size());
+				get_db().get_instance_by_leaf_treenode_id(leaf.id, [&](const auto& row) -> bool {
+					add_leaf_statistics(feature_types, row, statistics);
+					return true;
+				});
+				find = leaf_statistics.find(leaf.id);
+			}
+
+			// check every grace_period instances.
+			auto& statistics = find->second;
+			if (statistics.total_count - statistics.checked_count < hoeffding.grace_period) continue;
+			statistics.checked_count = statistics.total_count;
+
+			// split?
+			auto split = get_leaf_split(statistics, feature_types, hoeffding.delta, hoeffding.tie_threshold, hoeffding.min_instances, hoeffding.nominal_min_support);
+			if (not split) continue;
+			split_leaf_treenode(leaf, statistics, split.value(), feature_types, confusion_matrix, increment_count, increment_total_correct_count);
+			leaf_statistics.erase(leaf.id);
+		}
+		touched_leaf_treenodes.clear();
 	}
 
 	// update leaf_info count.
@@ -279,6 +360,9 @@ inline void supul_t::model::update(void) {
 	transaction.commit();
 	gaenari::logger::info("update completed.");
 
+	// predict uses the updated model.
+	refresh_forest();
+
 	// success.
 	return;
 }
@@ -401,6 +485,280 @@ inline type::treenode_db& supul_t::model::get_leaf_treenode_with_rule_add(_in _o
 	THROW_SUPUL_INTERNAL_ERROR0;
 }
 
+// field type of each feature in attributes.json order.
+inline auto supul_t::model::get_feature_types(void) const -> std::vector<type::field_type> {
+	std::vector<type::field_type> ret;
+	auto& fields = supul.schema.get_table_info(type::table::instance).fields;
+	for (const auto& feature_name: supul.attributes.x) {
+		auto find = fields.find(feature_name);
+		if (find == fields.end()) THROW_SUPUL_INTERNAL_ERROR0;
+		ret.emplace_back(find->second);
+	}
+	return ret;
+}
+
+// count an instance to the statistics of its leaf treenode.
+inline void supul_t::model::add_leaf_statistics(_in const std::vector<type::field_type>& feature_types, _in const type::map_variant& instance, _in _out type::leaf_statistics& statistics) const {
+	auto label = common::get_variant_int(instance, supul.attributes.y);
+	if (statistics.feature_count.size() != feature_types.size()) THROW_SUPUL_INTERNAL_ERROR0;
+	for (size_t feature_index=0; feature_index<feature_types.size(); feature_index++) {
+		auto& feature_name = supul.attributes.x[feature_index];
+		double value = 0.0;
+		switch (feature_types[feature_index]) {
+		case type::field_type::INTEGER:
+		case type::field_type::BIGINT:
+		case type::field_type::SMALLINT:
+		case type::field_type::TINYINT:
+		case type::field_type::TEXT_ID:
+			value = static_cast<double>(common::get_variant_int64(instance, feature_name));
+			break;
+		case type::field_type::REAL:
+			value = common::get_variant_double(instance, feature_name);
+			break;
+		default:
+			THROW_SUPUL_INVALID_DATA_TYPE(feature_name);
+		}
+		statistics.feature_count[feature_index][value][label]++;
+	}
+	statistics.label_count[label]++;
+	statistics.total_count++;
+}
+
+// choose the split of a leaf treenode with hoeffding bound.
+// the split is scored like the offline training engine.
+// - nominal : multi-way split. information gain ratio. the rare values are grouped into the `other` child with nominal_min_support.
+// - numeric : binary split of the minimum entropy threshold. information gain. (not divided by the split information)
+// a split with a child of less instances than min_instances is not chosen.
+// split when the best score is larger than the second best score by epsilon,
+// or epsilon is too small to break the tie.
+//   epsilon = sqrt(R^2 * ln(1/delta) / 2n), R = log2(label count).
+// the bound is of the information gain, and it's applied to the gain ratio of nominal splits as well.
+inline auto supul_t::model::get_leaf_split(_in const type::leaf_statistics& statistics, _in const std::vector<type::field_type>& feature_types, _in double delta, _in double tie_threshold, _in int64_t min_instances, _in int64_t nominal_min_support) const -> std::optional<type::leaf_split> {
+	auto entropy = [](_in const std::map<int, int64_t>& label_count, _in int64_t total_count) -> double {
+		double ret = 0.0;
+		if (total_count <= 0) return ret;
+		for (const auto& it: label_count) {
+			if (it.second <= 0) continue;
+			double p = static_cast<double>(it.second) / static_cast<double>(total_count);
+			ret -= p * std::log2(p);
+		}
+		return ret;
+	};
+
+	// pure leaf treenode.
+	auto n = statistics.total_count;
+	if ((n <= 0) or (statistics.label_count.size() < 2)) return std::nullopt;
+	if (statistics.feature_count.size() != feature_types.size()) THROW_SUPUL_INTERNAL_ERROR0;
+	double h = entropy(statistics.label_count, n);
+
+	type::leaf_split best;
+	double second_gain = 0.0;
+	best.gain = 0.0;
+	for (size_t feature_index=0; feature_index<statistics.feature_count.size(); feature_index++) {
+		const auto& values = statistics.feature_count[feature_index];
+		if (values.size() < 2) continue;
+		bool numeric = (feature_types[feature_index] != type::field_type::TEXT_ID);
+		double gain = 0.0;
+		double threshold = 0.0;
+		if (not numeric) {
+			// multi-way split.
+			double e = 0.0;
+			double split_information = 0.0;
+			bool too_small = false;
+			auto add_child = [&](_in const std::map<int, int64_t>& label_count, _in int64_t count) {
+				double p = static_cast<double>(count) / static_cast<double>(n);
+				e += p * entropy(label_count, count);
+				split_information -= p * std::log2(p);
+				if (count < min_instances) too_small = true;
+			};
+			std::map<int, int64_t> other;
+			int64_t other_count = 0;
+			for (const auto& it: values) {
+				int64_t count = 0;
+				for (const auto& it2: it.second) count += it2.second;
+				if (count < nominal_min_support) {
+					for (const auto& it2: it.second) other[it2.first] += it2.second;
+					other_count += count;
+					continue;
+				}
+				add_child(it.second, count);
+			}
+			if (other_count > 0) add_child(other, other_count);
+
+			// one child, or a too small child.
+			if ((split_information == 0.0) or too_small) continue;
+			gain = (h - e) / split_information;
+		} else {
+			// binary split. values are sorted, scan the thresholds.
+			std::map<int, int64_t> lte = {};
+			std::map<int, int64_t> gt  = statistics.label_count;
+			int64_t lte_count = 0;
+			int64_t best_lte_count = 0;
+			double best_e = 0.0;
+			bool found = false;
+			size_t i = 0;
+			for (const auto& it: values) {
+				if (++i == values.size()) break;
+				for (const auto& it2: it.second) {
+					lte[it2.first] += it2.second;
+					gt [it2.first] -= it2.second;
+					lte_count      += it2.second;
+				}
+				double e = static_cast<double>(lte_count)     / static_cast<double>(n) * entropy(lte, lte_count) +
+						   static_cast<double>(n - lte_count) / static_cast<double>(n) * entropy(gt,  n - lte_count);
+				if ((not found) or (e < best_e)) {
+					found = true;
+					best_e = e;
+					best_lte_count = lte_count;
+					threshold = it.first;
+				}
+			}
+
+			// a too small child.
+			if ((not found) or (best_lte_count < min_instances) or (n - best_lte_count < min_instances)) continue;
+			gain = h - best_e;
+		}
+
+		// best and second best.
+		if (gain > best.gain) {
+			second_gain        = best.gain;
+			best.feature_index = static_cast<int>(feature_index);
+			best.numeric       = numeric;
+			best.threshold     = threshold;
+			best.gain          = gain;
+		} else if (gain > second_gain) {
+			second_gain = gain;
+		}
+	}
+	if (best.gain <= 0.0) return std::nullopt;
+	best.nominal_min_support = nominal_min_support;
+
+	// hoeffding bound.
+	double r = std::log2(static_cast<double>(statistics.label_count.size()));
+	double epsilon = std::sqrt(r * r * std::log(1.0 / delta) / (2.0 * static_cast<double>(n)));
+	if ((best.gain - second_gain > epsilon) or (epsilon < tie_threshold)) return best;
+	return std::nullopt;
+}
+
+// split a leaf treenode in place.
+// the leaf treenode becomes a non-leaf treenode, and childs with new rule and leaf_info are added.
+// a nominal split has the `other` child(cmp_other) at last, so a value not seen yet still matches a leaf.
+// the `other` child without instances predicts the label of the leaf treenode.
+// the instances of the leaf treenode move to childs.
+// the changes of counts are applied to the values of update().
+//   - confusion_matrix        : [actual][predicted] increment.
+//   - increment_count         : pending count of the removed leaf_info is erased.
+//   - increment_correct_count : instance_info.correct increment.
+inline void supul_t::model::split_leaf_treenode(_in const type::treenode_db& leaf, _in const type::leaf_statistics& statistics, _in const type::leaf_split& split, _in const std::vector<type::field_type>& feature_types,
+												_in _out std::unordered_map<int, std::unordered_map<int, int64_t>>& confusion_matrix, _in _out std::unordered_map<int64_t, std::pair<int64_t, int64_t>>& increment_count, _in _out int64_t& increment_correct_count) {
+	struct child_t {
+		int rule_type = 0;
+		double value = 0.0;
+		std::map<int, int64_t> label_count;
+		int64_t total_count = 0;
+	};
+	std::vector<child_t> childs;
+	using rule_type = gaenari::method::decision_tree::rule_t::rule_type;
+
+	if (not leaf.is_leaf_node) THROW_SUPUL_INTERNAL_ERROR0;
+	if ((split.feature_index < 0) or (static_cast<size_t>(split.feature_index) >= feature_types.size())) THROW_SUPUL_INTERNAL_ERROR0;
+	const auto& values = statistics.feature_count[split.feature_index];
+	bool is_double = (feature_types[split.feature_index] == type::field_type::REAL);
+	if ((not split.numeric) and is_double) THROW_SUPUL_INTERNAL_ERROR0;
+
+	// rare value of nominal split.
+	auto is_rare = [&](_in const std::map<int, int64_t>& label_count) {
+		int64_t count = 0;
+		for (const auto& it: label_count) count += it.second;
+		return count < split.nominal_min_support;
+	};
+
+	// childs and their counts.
+	// the value of cmp_other rule is -1, the same as the training.
+	if (split.numeric) {
+		childs.resize(2);
+		childs[0].rule_type = static_cast<int>(rule_type::cmp_lte);
+		childs[1].rule_type = static_cast<int>(rule_type::cmp_gt);
+		childs[0].value = childs[1].value = split.threshold;
+	} else {
+		for (const auto& it: values) {
+			if (is_rare(it.second)) continue;
+			childs.emplace_back();
+			childs.back().rule_type = static_cast<int>(rule_type::cmp_equ);
+			childs.back().value = it.first;
+		}
+		childs.emplace_back();
+		childs.back().rule_type = static_cast<int>(rule_type::cmp_other);
+		childs.back().value = -1;
+	}
+	size_t i = 0;
+	for (const auto& it: values) {
+		auto& child = split.numeric ? childs[(it.first <= split.threshold) ? 0 : 1] : (is_rare(it.second) ? childs.back() : childs[i++]);
+		for (const auto& it2: it.second) {
+			child.label_count[it2.first] += it2.second;
+			child.total_count += it2.second;
+		}
+	}
+
+	// add childs.
+	auto generation_id = get_db().get_generation_id_by_treenode_id(leaf.id);
+	for (const auto& child: childs) {
+		// majority label.
+		// the empty `other` child has the label of the leaf treenode.
+		int label_index = leaf.leaf_info.label_index;
+		int64_t correct_count = 0;
+		for (const auto& it: child.label_count) if (it.second > correct_count) { label_index = it.first; correct_count = it.second; }
+		bool other = (child.rule_type == static_cast<int>(rule_type::cmp_other));
+		if ((child.total_count <= 0) and (not other)) THROW_SUPUL_INTERNAL_ERROR0;
+		double accuracy = (child.total_count > 0) ? static_cast<double>(correct_count) / static_cast<double>(child.total_count) : 0.0;
+		auto rule_id = get_db().add_rule(split.feature_index, child.rule_type, is_double ? 1 : 0, is_double ? 0 : static_cast<int64_t>(child.value), is_double ? child.value : 0.0);
+		auto leaf_info_id = get_db().add_leaf_info(label_index, type::leaf_info_type::leaf, -1, correct_count, child.total_count, accuracy);
+		get_db().add_treenode(generation_id, leaf.id, rule_id, leaf_info_id);
+	}
+
+	// the leaf treenode is not a leaf any more.
+	// its leaf_info count is replaced by childs, so the pending count is erased.
+	get_db().update_treenode_leaf_info_id(leaf.id, -1);
+	get_db().delete_leaf_info_by_id(leaf.leaf_info.id);
+	increment_count.erase(leaf.leaf_info.id);
+
+	// parent treenode of the leaf is not known, so clear all cache.
+	clear_all_cache();
+	auto new_childs = get_treenode_from_cache(leaf.id);
+	if (new_childs.size() != childs.size()) THROW_SUPUL_INTERNAL_ERROR0;
+
+	// the `other` child is evaluated at last.
+	std::stable_partition(new_childs.begin(), new_childs.end(), [](const type::treenode_db& t) {return t.rule.rule_type != static_cast<int>(rule_type::cmp_other);});
+
+	// move instances to childs.
+	// do not update in the middle of query.
+	std::vector<std::tuple<int64_t, int64_t, bool>> moves;	// (instance id, child treenode id, correct).
+	std::unordered_map<int64_t, int64_t> child_total_count;
+	get_db().get_instance_by_leaf_treenode_id(leaf.id, [&](const auto& row) -> bool {
+		for (const auto& child: new_childs) {
+			if (not eval_treenode(child, row)) continue;
+			int actual = common::get_variant_int(row, supul.attributes.y);
+			bool before = (actual == leaf.leaf_info.label_index);
+			bool after  = (actual == child.leaf_info.label_index);
+			confusion_matrix[actual][leaf.leaf_info.label_index]--;
+			confusion_matrix[actual][child.leaf_info.label_index]++;
+			increment_correct_count += static_cast<int64_t>(after) - static_cast<int64_t>(before);
+			child_total_count[child.id]++;
+			moves.emplace_back(common::get_variant_int64(row, "id"), child.id, after);
+			return true;
+		}
+		THROW_SUPUL_INTERNAL_ERROR0;
+	});
+	for (const auto& [instance_id, child_id, correct]: moves) get_db().update_instance_info(instance_id, child_id, correct);
+
+	// the statistics must match the instances.
+	if (static_cast<int64_t>(moves.size()) != statistics.total_count) THROW_SUPUL_INTERNAL_ERROR0;
+	for (const auto& child: new_childs) if (child_total_count[child.id] != child.leaf_info.total_count) THROW_SUPUL_INTERNAL_ERROR0;
+
+	gaenari::logger::info("online split: treenode(id={0}) -> {1} child(s). (feature_name: {2}, instances: {3}, gain: {4})",
+						  {leaf.id, childs.size(), supul.attributes.x[split.feature_index], statistics.total_count, split.gain});
+}
+
 // declare before rebuild() for auto return.
 inline auto supul_t::model::get_weak_treenode_condition(void) {
 	struct ret_t {
@@ -419,6 +777,67 @@ inline auto supul_t::model::get_weak_treenode_condition(void) {
 	return ret;
 }
 
+// train parameters of build and rebuild.
+// control is set to the budget of property, and it logs the progress.
+inline auto supul_t::model::get_train_param(_in _out gaenari::method::decision_tree::train_control& control) const -> gaenari::method::decision_tree::train_param {
+	gaenari::method::decision_tree::train_param param;
+	auto time_budget_msec    = supul.prop.get("model.train.time_budget_msec", 0LL);
+	auto max_nodes           = supul.prop.get("model.train.max_nodes", 0LL);
+	if ((time_budget_msec < 0) or (max_nodes < 0)) THROW_SUPUL_ERROR("invalid model.train budget property.");
+	control.time_budget_msec       = static_cast<size_t>(time_budget_msec);
+	control.max_nodes              = static_cast<size_t>(max_nodes);
+	control.progress_interval_msec = 10000;
+	control.progress = [](const gaenari::method::decision_tree::train_progress& progress) {
+		if (progress.finished) return;
+		gaenari::logger::info("training... nodes: {0}, rows: {1}, depth: {2}, elapsed: {3} msec.", {progress.nodes, progress.rows, progress.depth, progress.elapsed_msec});
+	};
+	param.control = &control;
+	auto threads = supul.prop.get("model.train.threads", 1LL);
+	if (threads < 0) THROW_SUPUL_ERROR("invalid model.train.threads.");
+	param.threads = static_cast<size_t>(threads);
+	param.level_wise = supul.prop.get("model.train.level_wise", false);
+	auto sample_min_rows     = supul.prop.get("model.train.sample_min_rows", 0LL);
+	auto sample_rows         = supul.prop.get("model.train.sample_rows", 65536LL);
+	auto sample_top_features = supul.prop.get("model.train.sample_top_features", 2LL);
+	if ((sample_min_rows < 0) or (sample_rows <= 0) or (sample_top_features <= 0)) THROW_SUPUL_ERROR("invalid model.train.sample property.");
+	if (param.level_wise and (sample_min_rows > 0)) THROW_SUPUL_ERROR("model.train.sample_min_rows is not supported with model.train.level_wise.");
+	param.sample_min_rows     = static_cast<size_t>(sample_min_rows);
+	param.sample_rows         = static_cast<size_t>(sample_rows);
+	param.sample_top_features = static_cast<size_t>(sample_top_features);
+	auto nominal_min_support = supul.prop.get("model.train.nominal_min_support", 0LL);
+	if (nominal_min_support < 0) THROW_SUPUL_ERROR("invalid model.train.nominal_min_support.");
+	param.nominal_min_support = static_cast<size_t>(nominal_min_support);
+	auto feature_subspace      = supul.prop.get("model.train.feature_subspace", 0LL);
+	auto feature_subspace_seed = supul.prop.get("model.train.feature_subspace_seed", 0LL);
+	if (feature_subspace < 0) THROW_SUPUL_ERROR("invalid model.train.feature_subspace.");
+	param.feature_subspace      = static_cast<size_t>(feature_subspace);
+	param.feature_subspace_seed = static_cast<int>(feature_subspace_seed);
+	return param;
+}
+
+// split strategy of build and rebuild.
+// - default   : all distinct numeric values are the split points.
+// - histogram : numeric values are bucketed, and the bins are the split points. faster on large instances.
+inline auto supul_t::model::get_train_split_strategy(void) const -> gaenari::method::decision_tree::split_strategy {
+	auto split_strategy = supul.prop.get("model.train.split_strategy", "default");
+	if (split_strategy == "default")   return gaenari::method::decision_tree::split_strategy::split_strategy_default;
+	if (split_strategy == "histogram") return gaenari::method::decision_tree::split_strategy::split_strategy_histogram;
+	THROW_SUPUL_ERROR1("invalid model.train.split_strategy: %0.", split_strategy);
+}
+
+inline size_t supul_t::model::get_eval_threads(void) const {
+	auto threads = supul.prop.get("model.eval.threads", 0LL);
+	if (threads < 0) THROW_SUPUL_ERROR("invalid model.eval.threads.");
+	return static_cast<size_t>(threads);
+}
+
+// memory budget bytes of the instances to rebuild. 0 means unlimited.
+inline size_t supul_t::model::get_rebuild_memory_budget(void) const {
+	auto memory_budget_mb = supul.prop.get("model.rebuild.memory_budget_mb", 0LL);
+	if (memory_budget_mb < 0) THROW_SUPUL_ERROR("invalid model.rebuild.memory_budget_mb.");
+	return static_cast<size_t>(memory_budget_mb) << 20;
+}
+
 inline void supul_t::model::rebuild(void) {
 	int64_t increment_correct_count = 0;
 	std::unordered_map<int, std::unordered_map<int, int64_t>> before_confusion_matrix;	// [actual][predicted] = count.
@@ -458,7 +877,23 @@ inline void supul_t::model::rebuild(void) {
 	update_leaf_info_by_go_to_generation_id_to_cache(generation_id, condition.accuracy, condition.total_count);
 
 	// get instances.
-	auto df = get_db().get_instance_by_go_to_generation_id(generation_id);
+	// with the memory budget, the instances over the budget are spilled to a file, and memory mapped.
+	auto memory_budget = get_rebuild_memory_budget();
+	auto spill_path = (memory_budget == 0) ? std::string{} : common::path_join_const(supul.paths.base_dir, "rebuild.spill");
+
+	// the spill file path is fixed.
+	// a stale one of the previous rebuild(ex: killed process) is removed before,
+	// and it's removed after the dataframe is released, on all return and exception paths.
+	// (declared before df, so it's destroyed after df is unmapped.)
+	struct spill_remover_t {
+		std::string path;
+		void remove(void) {if (path.empty()) return; std::error_code ec; std::filesystem::remove(path, ec);}
+		~spill_remover_t() {remove();}
+	} spill_remover{spill_path};
+	spill_remover.remove();
+
+	auto df = get_db().get_instance_by_go_to_generation_id(generation_id, spill_path, memory_budget);
+	if (df.is_mapped()) gaenari::logger::info("instances are over the memory budget, spilled to {0}.", {spill_path});
 	df.set_string_table_reference_from(supul.string_table.get_table());
 	gaenari::method::stringfy::logger(df, "dataframe to rebuild.", 20);
 	if (df.empty()) THROW_SUPUL_INTERNAL_ERROR0;
@@ -474,8 +909,12 @@ inline void supul_t::model::rebuild(void) {
 	// train.
 	gaenari::common::elapsed_time elapsed;
 	gaenari::logger::info("start to train.");
-	dt.train(ds);
+	gaenari::method::decision_tree::train_control control;
+	dt.train(ds, get_train_split_strategy(), 2, 1.2, 0.0, get_train_param(control));
 	gaenari::logger::info("finished, elapsed: {0}", {elapsed.to_string()});
+	if (control.result().stopped != gaenari::method::decision_tree::train_progress::stop_reason::none) {
+		gaenari::logger::warn("training stopped by budget, not expanded tree nodes are leaves. (nodes: {0}, depth: {1})", {control.result().nodes, control.result().depth});
+	}
 
 	// check empty.
 	if (dt.empty()) {
@@ -496,7 +935,9 @@ inline void supul_t::model::rebuild(void) {
 	double after_weak_instance_accuracy = 0.0;
 	int64_t after_weak_instance_correct_count = 0;
 	std::map<size_t,std::map<size_t,size_t>> confusion;
-	dt.eval(df, after_weak_instance_accuracy, &confusion, nullptr, (size_t*)(&after_weak_instance_correct_count));
+	gaenari::method::decision_tree::confusion_matrix matrix;
+	dt.eval_parallel(df, after_weak_instance_accuracy, &matrix, nullptr, (size_t*)(&after_weak_instance_correct_count), get_eval_threads());
+	matrix.to_map(confusion);
 	auto cm = dt.to_string_confusion_matrix(confusion);
 	gaenari::logger::info(std::string("\n") + cm, true);
 
@@ -529,23 +970,24 @@ inline void supul_t::model::rebuild(void) {
 	if (find == std::nullopt) THROW_SUPUL_INTERNAL_ERROR0;
 	size_t id_label_index = find.value();
 
-	// every row in dataframe, do prediction.
+	// predict all rows at once.
 	size_t row_count = df.rows();
 	size_t row_index = 0;
-	std::map<std::string, gaenari::type::variant> row_map;
-	for (row_index=0; row_index<row_count; row_index++) {
-		// get each row as (name, variant value) map.
-		df.get_row_as_map(row_index, row_map, true, false);
+	std::vector<size_t> labels(row_count);
+	std::vector<int> treenode_ids(row_count);
+	dt.predict(df, labels.data(), treenode_ids.data());
 
+	// every row in dataframe.
+	for (row_index=0; row_index<row_count; row_index++) {
 		// instance id.
 		int64_t instance_id = df.get_raw(row_index, id_col_index).numeric_int64;
 
 		// before predicted.
 		int label_index = df.get_raw(row_index, id_label_index).numeric_int32;
 
-		// predict.
-		int treenode_id = 0;
-		auto label = dt.predict(row_map, &treenode_id);
+		// predicted.
+		int treenode_id = treenode_ids[row_index];
+		auto label = labels[row_index];
 		auto& ground_truth = ds.y.get_raw(row_index, 0);
 
 		// get correct, treenode id(db).
@@ -593,6 +1035,9 @@ inline void supul_t::model::rebuild(void) {
 	// transaction commit.
 	transaction.commit();
 	gaenari::logger::info("rebuild completed.");
+
+	// predict uses the rebuilt model.
+	refresh_forest();
 }
 
 inline void supul_t::model::build_first_tree(_out int64_t& instance_count) {
@@ -625,8 +1070,12 @@ inline void supul_t::model::build_first_tree(_out int64_t& instance_count) {
 	// train.
 	gaenari::common::elapsed_time elapsed;
 	gaenari::logger::info("start to train.");
-	dt.train(ds);
+	gaenari::method::decision_tree::train_control control;
+	dt.train(ds, get_train_split_strategy(), 2, 1.2, 0.0, get_train_param(control));
 	gaenari::logger::info("finished, elapsed: {0}", {elapsed.to_string()});
+	if (control.result().stopped != gaenari::method::decision_tree::train_progress::stop_reason::none) {
+		gaenari::logger::warn("training stopped by budget, not expanded tree nodes are leaves. (nodes: {0}, depth: {1})", {control.result().nodes, control.result().depth});
+	}
 
 	// print tree.
 	auto stringfy = dt.stringfy("text/colortag", true);
@@ -635,7 +1084,9 @@ inline void supul_t::model::build_first_tree(_out int64_t& instance_count) {
 	// confusion matrix.
 	double accuracy = 0.0;
 	std::map<size_t,std::map<size_t,size_t>> confusion;
-	dt.eval(df, accuracy, &confusion);
+	gaenari::method::decision_tree::confusion_matrix matrix;
+	dt.eval_parallel(df, accuracy, &matrix, nullptr, nullptr, get_eval_threads());
+	matrix.to_map(confusion);
 	auto cm = dt.to_string_confusion_matrix(confusion);
 	gaenari::logger::info(std::string("\n") + cm, true);
 
@@ -727,14 +1178,55 @@ inline int64_t supul_t::model::insert_tree(_in const gaenari::method::decision_t
 // references may be returned, but dangling reference is an issue in future multi-threaded environments.
 // just return the body without pre-locking.
 inline auto supul_t::model::get_treenode_from_cache(_in int64_t parent_treenode_id) -> const std::vector<type::treenode_db> {
-	// get value from cache.
-	auto ret = treenode_cache.get(parent_treenode_id, [&supul=supul](_in auto& k, _out auto& v) {
+	// lock while copying from the reference.
+	std::lock_guard<std::recursive_mutex> l(treenode_cache.get_mutex());
+	return get_treenode_childs_from_cache(parent_treenode_id).childs;
+}
+
+// returns the reference of the cache.
+// call after locking treenode_cache.get_mutex(), and do not use it after unlock.
+inline auto supul_t::model::get_treenode_childs_from_cache(_in int64_t parent_treenode_id) -> const type::treenode_childs& {
+	return treenode_cache.get_ref(parent_treenode_id, [&supul=supul](_in auto& k, _out auto& v) {
 		// not found in cache, get value from database.
-		v = supul.db->get_treenode(k);
-		v.shrink_to_fit();
+		v.childs = supul.db->get_treenode(k);
+		v.childs.shrink_to_fit();
+		v.build_nominal_index();
 	});
+}
 
-	return ret;
+// returns the child treenode matched with x.
+// only the matched child is copied from the cache, not all childs.
+// returns std::nullopt if no child is matched.
+inline auto supul_t::model::get_matched_treenode_from_cache(_in int64_t parent_treenode_id, _in const type::map_variant& x) -> std::optional<type::treenode_db> {
+	// lock while using the reference of the cache.
+	std::lock_guard<std::recursive_mutex> l(treenode_cache.get_mutex());
+	const auto& v = get_treenode_childs_from_cache(parent_treenode_id);
+	const auto& childs = v.childs;
+	if (childs.empty()) THROW_SUPUL_INTERNAL_ERROR0;
+
+	// nominal split with many childs, find the child by hash.
+	if (not v.nominal_index.empty()) {
+		// eval_treenode(...) of a `==` child checks the field of x and its type(int64_t),
+		// and throws the same errors as the linear scan.
+		const auto& equ = childs[v.nominal_index.begin()->second];
+		if (eval_treenode(equ, x)) return equ;
+		const auto& instance = supul.schema.get_table_info(type::table::instance);
+		auto fieldname = instance.fields.key(static_cast<size_t>(equ.rule.feature_index) + 1);
+		if (not fieldname.has_value()) THROW_SUPUL_INTERNAL_ERROR0;
+		auto find = v.nominal_index.find(std::get<1>(x.find(fieldname.value())->second));
+		if (find != v.nominal_index.end()) return childs[find->second];
+		if (v.other) return childs[v.other.value()];
+		return std::nullopt;
+	}
+
+	// does the variable x satisfy the condition?
+	// the order of childs is not defined, so the cmp_other child is evaluated at last.
+	for (size_t i=0; i<childs.size(); i++) {
+		if (v.other and (v.other.value() == i)) continue;
+		if (eval_treenode(childs[i], x)) return childs[i];
+	}
+	if (v.other and eval_treenode(childs[v.other.value()], x)) return childs[v.other.value()];
+	return std::nullopt;
 }
 
 inline int64_t supul_t::model::get_root_ref_treenode_id_from_cache(_in int64_t generation_id) {
@@ -807,6 +1299,15 @@ inline bool supul_t::model::eval_treenode(_in const type::treenode_db& treenode,
 			if (is_double) ret = std::get<2>(x_value) > treenode.rule.value_real;
 			else THROW_SUPUL_INVALID_DATA_TYPE(fieldname);
 		} else THROW_SUPUL_INTERNAL_ERROR0;
+	} else if (rule_type == gaenari::method::decision_tree::rule_t::rule_type::cmp_other) {
+		// grouped rare values of nominal split.
+		// it's matched when no sibling is matched, so the caller evaluates it at last.
+		if (index == 1) {			// int64_t.
+			if (is_double) THROW_SUPUL_INVALID_DATA_TYPE(fieldname);
+			else ret = true;
+		} else if (index == 2) {	// double.
+			THROW_SUPUL_INVALID_DATA_TYPE(fieldname);
+		} else THROW_SUPUL_INTERNAL_ERROR0;
 	} else if (rule_type == gaenari::method::decision_tree::rule_t::rule_type::cmp_gte) {
 		if (index == 1) {			// int64_t.
 			if (is_double) THROW_SUPUL_INVALID_DATA_TYPE(fieldname);
@@ -823,15 +1324,29 @@ inline bool supul_t::model::eval_treenode(_in const type::treenode_db& treenode,
 // returns a leaf treenode_db object reference with one x parameter row map(name, value) values.
 // x is a (string, variant) map and the variant type must match the type specified in attributes.json.
 inline auto supul_t::model::predict(_in const type::map_variant& x) -> type::treenode_db {
-	// call predict_main with read-only transaction.
-	// transaction begin.
-	// implicit rollback called. its error could be ignored.
-	db::transaction_guard transaction{get_db(), false};
-	auto predict_info = predict_main(x);
-	if (predict_info.status == type::predict_status::leaf_node) return predict_info.leaf_treenode;
-	if (predict_info.status == type::predict_status::middle_node) return predict_info.middle_treenode;
-	if (predict_info.status == type::predict_status::not_found) THROW_SUPUL_RULE_NOT_MATCHED_ERROR("no rule matched.");
-	THROW_SUPUL_INTERNAL_ERROR0;
+	// predict with the compiled forest of the last committed model.
+	// the go_to_generation jumps are resolved and the rules are pre-typed,
+	// so the database, the caches and the field name lookups are not used.
+	// the result is the same as predict_main(...).
+	auto forest = get_forest();
+	std::vector<snapshot::value> row;
+	forest->get_typed_row(x, row);
+	auto r = forest->predict(row.data());
+	if (r.status == type::predict_status::not_found) THROW_SUPUL_RULE_NOT_MATCHED_ERROR("no rule matched.");
+	if (not r.matched) THROW_SUPUL_INTERNAL_ERROR0;
+
+	// leaf treenode.
+	// the rule and go_to_ref_generation_id are not in the forest, and not set.
+	type::treenode_db ret;
+	ret.id = r.matched->treenode_id;
+	ret.is_leaf_node = true;
+	ret.leaf_info.id            = r.matched->leaf_info_id;
+	ret.leaf_info.label_index   = r.matched->label_index;
+	ret.leaf_info.type          = static_cast<type::leaf_info_type>(r.matched->type);
+	ret.leaf_info.correct_count = r.matched->correct_count;
+	ret.leaf_info.total_count   = r.matched->total_count;
+	ret.leaf_info.accuracy      = r.matched->accuracy;
+	return ret;
 }
 
 // predict main function.
@@ -915,22 +1430,9 @@ inline auto supul_t::model::predict_main(_in const type::map_variant& x) -> type
 	}
 
 	for (;;) {
-		// get childs.
-		// minimize db access by cache.
-		auto childs = get_treenode_from_cache(cur_treenode_id);
-		if (childs.empty()) {
-			THROW_SUPUL_INTERNAL_ERROR0;
-		}
-
-		// does the variable x satisfy the condition?
 		// get matched treenode in childs.
-		std::optional<std::reference_wrapper<const type::treenode_db>> _matched_treenode;
-		for (const auto& child: childs) {
-			if (eval_treenode(child, x) == true) {
-				_matched_treenode = child;
-				break;
-			}
-		}
+		// minimize db access by cache.
+		auto _matched_treenode = get_matched_treenode_from_cache(cur_treenode_id, x);
 
 		if (not _matched_treenode.has_value()) {
 			// oh, no matching.
@@ -949,7 +1451,7 @@ inline auto supul_t::model::predict_main(_in const type::map_variant& x) -> type
 			return ret;
 		}
 
-		auto& matched_treenode = _matched_treenode.value().get();
+		auto& matched_treenode = _matched_treenode.value();
 
 		// non-leaf node, go to matched child.
 		if (not matched_treenode.is_leaf_node) {
@@ -979,6 +1481,79 @@ inline auto supul_t::model::predict_main(_in const type::map_variant& x) -> type
 	}
 }
 
+// flattens the current generational forest to a snapshot file.
+// read-only database operation.
+// see snapshot::forest.
+inline void supul_t::model::export_snapshot(_in const std::string& file_path) {
+	// write the compiled forest of predict.
+	auto forest = get_forest();
+	forest->write(file_path, supul.string_table.get_table());
+	gaenari::logger::info("snapshot exported: {0}, {1} nodes", {file_path, forest->nodes.size()});
+}
+
+// build the flattened forest from the first root treenode.
+// the treenodes and the root treenode ids of generations are read with the caches.
+inline void supul_t::model::build_snapshot(_out snapshot::forest& forest) {
+	// features are instance fields without `id`.
+	// so, the feature_index of rules is the index of features.
+	const auto& instance = supul.schema.get_table_info(type::table::instance);
+	std::vector<snapshot::feature> features;
+	for (size_t i=1; i<instance.fields.size(); i++) {
+		auto name = instance.fields.key(i);
+		if (not name.has_value()) THROW_SUPUL_INTERNAL_ERROR0;
+		features.push_back({name.value(), instance.fields.find(name.value())->second});
+	}
+
+	// get root treenode id.
+	if (not this->first_root_ref_treenode_id) this->first_root_ref_treenode_id = supul.db->get_first_root_ref_treenode_id();
+
+	forest.build(this->first_root_ref_treenode_id.value(), features, supul.attributes.y,
+				 [this](_in int64_t parent_treenode_id) {return get_treenode_from_cache(parent_treenode_id);},
+				 [this](_in int64_t generation_id) {return get_root_ref_treenode_id_from_cache(generation_id);});
+}
+
+// get the compiled forest for predict.
+// it's built with read-only transaction on the first call.
+inline auto supul_t::model::get_forest(void) -> std::shared_ptr<const snapshot::forest> {
+	{
+		std::lock_guard<std::mutex> lock(forest_mutex);
+		if (forest) return forest;
+	}
+
+	// read-only transaction.
+	// implicit rollback called. its error could be ignored.
+	db::transaction_guard transaction{get_db(), false};
+	auto built = std::make_shared<snapshot::forest>();
+	build_snapshot(*built);
+
+	std::lock_guard<std::mutex> lock(forest_mutex);
+	if (not forest) forest = std::move(built);
+	return forest;
+}
+
+// rebuild the compiled forest after the model is committed.
+// predict in progress keeps the previous forest, and the new one is swapped in.
+// the committed operation does not fail on error,
+// the forest is dropped, and get_forest() builds it again on the next predict.
+inline void supul_t::model::refresh_forest(void) {
+	std::shared_ptr<const snapshot::forest> built;
+	try {
+		// read-only transaction.
+		// implicit rollback called. its error could be ignored.
+		db::transaction_guard transaction{get_db(), false};
+		if (not get_db().get_is_generation_empty()) {
+			auto f = std::make_shared<snapshot::forest>();
+			build_snapshot(*f);
+			built = std::move(f);
+		}
+	} catch(...) {
+		gaenari::logger::warn("fail to build the forest for predict: {0}", {exceptions::catch_all()});
+	}
+
+	std::lock_guard<std::mutex> lock(forest_mutex);
+	forest = std::move(built);
+}
+
 inline bool supul_t::model::is_correct(_in const type::map_variant& instance, _in const type::treenode_db& leaf_treenode, _option_out int* label_index, _option_out int* predicted_label_index) const {
 	// get y fieldname.
 	const auto& y = supul.attributes.y;
@@ -1009,7 +1584,7 @@ inline void supul_t::model::update_leaf_info_to_cache(_in int64_t leaf_info_id,
 
 	for (auto& it: cache_items) {
 		const int64_t& treenode_id = it.first;
-		auto& treenode_dbs = it.second.first;
+		auto& treenode_dbs = it.second.first.childs;
 		for (auto& treenode: treenode_dbs) {
 			if (treenode.leaf_info.id == leaf_info_id) {
 				treenode.leaf_info.correct_count += increment_correct_count;
@@ -1034,7 +1609,7 @@ inline void supul_t::model::update_leaf_info_by_go_to_generation_id_to_cache(_in
 	// WHERE leaf_info.accuracy <= ? AND leaf_info.total_count >= ? AND leaf_info.type = 1
 	for (auto& it: cache_items) {
 		const int64_t& treenode_id = it.first;
-		auto& treenode_dbs = it.second.first;
+		auto& treenode_dbs = it.second.first.childs;
 		for (auto& treenode: treenode_dbs) {
 			if ((treenode.leaf_info.accuracy <= leaf_node_accuracy_upperbound) and
 				(treenode.leaf_info.total_count >= leaf_node_total_count_lowerbound) and
@@ -1065,7 +1640,13 @@ inline void supul_t::model::verify_cache(void) {
 			const auto& parent_treenode_id = it.first;
 			const auto& data_cache = it.second.first;
 			const auto  data_db = get_db().get_treenode(parent_treenode_id);
-			if (data_cache != data_db) THROW_SUPUL_INTERNAL_ERROR0;
+			if (data_cache.childs != data_db) THROW_SUPUL_INTERNAL_ERROR0;
+
+			// nominal_index is built from the childs.
+			type::treenode_childs built;
+			built.childs = data_db;
+			built.build_nominal_index();
+			if ((data_cache.nominal_index != built.nominal_index) or (data_cache.other != built.other)) THROW_SUPUL_INTERNAL_ERROR0;
 		}
 	}
 
@@ -53,6 +53,23 @@ inline void supul_t::init(_in const std::string& base_dir) {
 					"the lower value, the more aggresive rebuild, and the more complex the tree.";
 	auto comment3 = "if the total number of instances is greater than this, older chunks are removed.";
 	auto comment4 = "minimum number of instances to keep.";
+	auto comment5 = "numeric split strategy of build and rebuild : default, histogram. histogram buckets the numeric values, and it is faster on large instances.";
+	auto comment6 = "thread count to train the tree in build and rebuild. 1 means single thread, 0 means the number of cpu cores. the tree is the same as the single thread.";
+	auto comment7 = "thread count to evaluate the tree after build and rebuild. 0 means the number of cpu cores.";
+	auto comment8 = "train the tree depth by depth with one scan of the instances per depth. the tree is the same, and histogram split strategy is recommended.";
+	auto comment9 = "split weak leaf treenodes online in update() with hoeffding bound, without waiting for rebuild.";
+	auto comment10 = "the number of instances a weak leaf treenode should observe between split attempts.";
+	auto comment11 = "allowed probability of choosing the wrong split. the lower value, the more instances to split.";
+	auto comment12 = "split anyway when the hoeffding bound is less than this, even if the best and second best split are tied.";
+	auto comment13 = "the split of a tree node with rows more than or equal to this is searched on a stratified sample in build and rebuild. 0 means disabled. not supported with level_wise.";
+	auto comment14 = "row count of the sample.";
+	auto comment15 = "the top features of the sample are evaluated again with all rows, and the best one is chosen.";
+	auto comment16 = "training time budget of build and rebuild in milliseconds. when it is over, the tree nodes not expanded yet become leaves. 0 means unlimited.";
+	auto comment17 = "tree node budget of build and rebuild. when it is over, the tree nodes not expanded yet become leaves. 0 means unlimited.";
+	auto comment18 = "nominal values with less instances than this in a tree node are grouped into one `other` child. 0 means disabled.";
+	auto comment19 = "feature count to be evaluated per tree node in build and rebuild. the features are chosen randomly per tree node. 0 means all features.";
+	auto comment20 = "random seed of model.train.feature_subspace. the same seed builds the same tree.";
+	auto comment21 = "memory budget(mb) of the instances to rebuild. over it, the instances are spilled to a file in the project directory, and memory mapped. 0 means unlimited.";
 
 	// set default property with comment.
 	if (create_mode or property_update) {
@@ -62,6 +79,23 @@ inline void supul_t::init(_in const std::string& base_dir) {
 		prop.set_default({{"db.tablename.prefix",						"",						"set table name prefix."}});
 		prop.set_default({{"model.weak_treenode_condition.accuracy",	"0.8",					comment1}});
 		prop.set_default({{"model.weak_treenode_condition.total_count",	"5",					comment2}});
+		prop.set_default({{"model.eval.threads",						"0",					comment7}});
+		prop.set_default({{"model.hoeffding.use",						"false",				comment9}});
+		prop.set_default({{"model.hoeffding.grace_period",				"200",					comment10}});
+		prop.set_default({{"model.hoeffding.delta",						"0.0000001",			comment11}});
+		prop.set_default({{"model.hoeffding.tie_threshold",				"0.05",					comment12}});
+		prop.set_default({{"model.train.threads",						"1",					comment6}});
+		prop.set_default({{"model.train.split_strategy",				"default",				comment5}});
+		prop.set_default({{"model.train.level_wise",					"false",				comment8}});
+		prop.set_default({{"model.train.sample_min_rows",				"0",					comment13}});
+		prop.set_default({{"model.train.sample_rows",					"65536",				comment14}});
+		prop.set_default({{"model.train.sample_top_features",			"2",					comment15}});
+		prop.set_default({{"model.train.time_budget_msec",				"0",					comment16}});
+		prop.set_default({{"model.train.max_nodes",						"0",					comment17}});
+		prop.set_default({{"model.train.nominal_min_support",			"0",					comment18}});
+		prop.set_default({{"model.train.feature_subspace",				"0",					comment19}});
+		prop.set_default({{"model.train.feature_subspace_seed",			"0",					comment20}});
+		prop.set_default({{"model.rebuild.memory_budget_mb",			"0",					comment21}});
 		prop.set_default({{"limit.chunk.use",							"false",				"use chunk instance size limit."}});
 		prop.set_default({{"limit.chunk.instance_upper_bound",			"2000000",				comment3}});
 		prop.set_default({{"limit.chunk.instance_lower_bound",			"1000000",				comment4}});
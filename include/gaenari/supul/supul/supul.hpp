@@ -39,6 +39,10 @@
 //
 //   - supul.api.predict((name, value) map)
 //     . return predict result with one unlabeled instance row.
+//
+//   - supul.api.model.export_snapshot(file_path)
+//     . flattens the current generational forest to one read-only snapshot file.
+//     . snapshot::mapped_forest predicts from the file without the database.
 
 namespace supul {
 namespace supul {
@@ -78,6 +82,7 @@ public:
 		void update(void);
 		void rebuild(void);
 		auto predict(_in const type::map_variant& x) -> type::treenode_db;
+		void export_snapshot(_in const std::string& file_path);
 
 		// other functions of the model.
 		//   - call in the transaction.
@@ -92,14 +97,29 @@ public:
 		bool eval_treenode(_in const type::treenode_db& treenode, _in const type::map_variant& x) const;
 		bool is_correct(_in const type::map_variant& instance, _in const type::treenode_db& leaf_treenode, _option_out int* label_index = nullptr, _option_out int* predicted_label_index = nullptr) const;
 		auto predict_main(_in const type::map_variant& x) -> type::predict_info;
+		void build_snapshot(_out snapshot::forest& forest);
+		auto get_forest(void) -> std::shared_ptr<const snapshot::forest>;
+		void refresh_forest(void);
 		auto get_weak_treenode_condition(void);
+		size_t get_eval_threads(void) const;
+		size_t get_rebuild_memory_budget(void) const;
+		auto get_train_param(_in _out gaenari::method::decision_tree::train_control& control) const -> gaenari::method::decision_tree::train_param;
+		auto get_train_split_strategy(void) const -> gaenari::method::decision_tree::split_strategy;
 		auto get_treenode_from_cache(_in int64_t parent_treenode_id) -> const std::vector<type::treenode_db>;
+		auto get_treenode_childs_from_cache(_in int64_t parent_treenode_id) -> const type::treenode_childs&;
+		auto get_matched_treenode_from_cache(_in int64_t parent_treenode_id, _in const type::map_variant& x) -> std::optional<type::treenode_db>;
 		void update_leaf_info_to_cache(_in int64_t leaf_info_id, _in int64_t increment_correct_count, _in int64_t increment_total_count);
 		void update_leaf_info_by_go_to_generation_id_to_cache(_in int64_t generation_id, _in double leaf_node_accuracy_upperbound, _in int64_t leaf_node_total_count_lowerbound);
 		int64_t get_root_ref_treenode_id_from_cache(_in int64_t generation_id);
 		type::treenode_db& get_leaf_treenode_with_rule_add(_in _out type::predict_info& predict_info, _in const type::map_variant& instance, _out bool& added);
 		void update_generation_etc(_in int64_t generation_id, _in const type::map_variant& before_global, _in const int64_t weak_instance_count, _in const int64_t before_weak_instance_correct_count, _in const int64_t after_weak_instance_correct_count);
 		void chunk_limit(_in int64_t lower_bound, _in int64_t upper_bound);
+		auto get_hoeffding_condition(void);
+		auto get_feature_types(void) const -> std::vector<type::field_type>;
+		void add_leaf_statistics(_in const std::vector<type::field_type>& feature_types, _in const type::map_variant& instance, _in _out type::leaf_statistics& statistics) const;
+		auto get_leaf_split(_in const type::leaf_statistics& statistics, _in const std::vector<type::field_type>& feature_types, _in double delta, _in double tie_threshold, _in int64_t min_instances, _in int64_t nominal_min_support) const -> std::optional<type::leaf_split>;
+		void split_leaf_treenode(_in const type::treenode_db& leaf, _in const type::leaf_statistics& statistics, _in const type::leaf_split& split, _in const std::vector<type::field_type>& feature_types,
+								 _in _out std::unordered_map<int, std::unordered_map<int, int64_t>>& confusion_matrix, _in _out std::unordered_map<int64_t, std::pair<int64_t, int64_t>>& increment_count, _in _out int64_t& increment_correct_count);
 
 	protected:
 		supul_t& supul;
@@ -115,8 +135,14 @@ public:
 		void verify_cache(void);
 		void verify_global(void);
 		void verify_etc(void);
-		gaenari::common::cache<int64_t, std::vector<type::treenode_db>> treenode_cache;
+		gaenari::common::cache<int64_t, type::treenode_childs> treenode_cache;
 		gaenari::common::cache<int64_t, int64_t> get_root_ref_treenode_id_cache;
+
+		// compiled forest of the last committed model for predict.
+		// it's not a cache of the transaction, so clear_all_cache() does not clear it.
+		// it's swapped after commit, and predict in progress keeps the previous one.
+		std::shared_ptr<const snapshot::forest> forest;
+		std::mutex forest_mutex;
 	};
 
 	// string table api category.
@@ -211,6 +237,7 @@ public:
 			bool update(void) noexcept;
 			bool rebuild(void) noexcept;
 			auto predict(_in const std::unordered_map<std::string, std::string>& x) noexcept -> type::predict_result;
+			bool export_snapshot(_in const std::string& file_path) noexcept;
 		} model;
 
 		// report.
@@ -144,6 +144,42 @@ struct treenode_db {
 	}
 };
 
+// childs of a treenode in the treenode cache.
+// nominal_index is (value_integer -> index of childs) of the nominal split with many childs.
+// the child of a nominal value is found by hash instead of evaluating the rules of all childs.
+// empty, linear scan.
+// other is the index of cmp_other child(grouped rare values), matched when no sibling is matched.
+struct treenode_childs {
+	std::vector<treenode_db> childs;
+	std::unordered_map<int64_t, size_t> nominal_index;
+	std::optional<size_t> other;
+
+	// minimum child count of nominal_index. a few childs are faster with linear scan.
+	static constexpr size_t nominal_index_min_childs = 8;
+
+	// build nominal_index if all childs are `feature == value_integer` of the same feature.
+	// the first child is kept when the values are duplicated, like the linear scan.
+	void build_nominal_index(void) {
+		using rule_type = gaenari::method::decision_tree::rule_t::rule_type;
+		nominal_index.clear();
+		other.reset();
+		for (size_t i=0; i<childs.size(); i++) {
+			if (childs[i].rule.rule_type == static_cast<int>(rule_type::cmp_other)) other = i;
+		}
+		if (childs.size() < nominal_index_min_childs) return;
+		for (size_t i=0; i<childs.size(); i++) {
+			const auto& child = childs[i];
+			if (other and (other.value() == i)) continue;
+			if ((child.rule.rule_type != static_cast<int>(rule_type::cmp_equ)) or
+				(child.rule.value_type != 0) or (child.rule.feature_index != childs[0].rule.feature_index)) {
+				nominal_index.clear();
+				return;
+			}
+			nominal_index.emplace(child.rule.value_integer, i);
+		}
+	}
+};
+
 // predict result status.
 // - leaf_node
 //   apply rules up to leaf nodes (normal case).
@@ -172,6 +208,28 @@ struct predict_info {
 	treenode_db new_treenode;
 };
 
+// sufficient statistics of a leaf treenode for the online split.
+// counted from the instances of the leaf treenode.
+// feature values are stored as double. (integer values are exact up to 2^53.)
+struct leaf_statistics {
+	int64_t total_count   = 0;
+	int64_t checked_count = 0;												// total_count at the last split check.
+	std::map<int, int64_t> label_count;										// [label_index] = count.
+	std::vector<std::map<double, std::map<int, int64_t>>> feature_count;	// [feature_index][value][label_index] = count.
+};
+
+// online split of a leaf treenode.
+// - numeric : two childs, (value <= threshold) and (value > threshold).
+// - nominal : one child per value of leaf_statistics::feature_count, and the `other` child(cmp_other) at last.
+//             the values with less instances than nominal_min_support and the values not seen yet go to the `other` child.
+struct leaf_split {
+	int     feature_index       = 0;
+	bool    numeric             = false;
+	double  threshold           = 0.0;
+	double  gain                = 0.0;	// information gain ratio. (numeric: information gain)
+	int64_t nominal_min_support = 0;
+};
+
 // (name, variant) insert_order_map.
 using map_variant = gaenari::common::insert_order_map<std::string, type::value_variant>;
 
@@ -6,6 +6,24 @@
 //	- create_project_test()
 //	- insert_update_test()
 //	- rebuild_test()
+//	- codegen_test()
+//	- level_wise_test()
+//	- hoeffding_test()
+//	- train_control_test()
+//	- nominal_min_support_test()
+//	- nominal_min_support_supul_test()
+//	- nominal_index_supul_test()
+//	- forest_predict_test()
+//	- spill_test()
+//	- spill_rebuild_test()
+//	- binary_tree_test()
+//	- snapshot_test()
+//	- parallel_subtree_test()
+//	- parallel_feature_test()
+//	- sample_split_test()
+//	- feature_subspace_test()
+//	- eval_parallel_test()
+//	- post_processing_test()
 
 // is it a testable environment?
 inline void ready_test(void) {
@@ -299,4 +317,1306 @@ inline void global_variable_test_double(_in const std::string& projectname, _in
 	TEST_FAIL3("global value mis-match, name=%0, expected=%1, value=%2.", name, expected_value, vd);
 }
 
+// codegen test.
+// the c++ code generated from a trained tree is compiled with the compiler of the tests,
+// and its predict must be the same as decision_tree::predict(...) for all rows.
+inline void codegen_test(_in int instances, _in int func, _in size_t nominal_min_support) {
+#ifndef GAENARI_TESTS_CXX_COMPILER
+	(void)instances; (void)func; (void)nominal_min_support;
+	gaenari::logger::warn("GAENARI_TESTS_CXX_COMPILER is not defined, skip codegen_test.");
+#else
+	using namespace gaenari::dataset;
+	namespace dt = gaenari::method::decision_tree;
+
+	// train.
+	dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	dataset ds(df);
+	dt::decision_tree tree;
+	dt::train_param param;
+	param.nominal_min_support = nominal_min_support;
+	tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+
+	// expected.
+	std::vector<size_t> labels(df.rows());
+	std::vector<int> ids(df.rows());
+	tree.predict(df, labels.data(), ids.data());
+
+	// file paths.
+	auto name      = gaenari::common::f("codegen_f%0_m%1", {func, nominal_min_support});
+	auto hpp_path  = supul::common::path_join_const(temp_dir, name + ".hpp");
+	auto cpp_path  = supul::common::path_join_const(temp_dir, name + ".cpp");
+	auto rows_path = supul::common::path_join_const(temp_dir, name + ".txt");
+	auto exe_path  = supul::common::path_join_const(temp_dir, name + ".exe");
+
+	// generated header.
+	std::ofstream(hpp_path) << tree.to_cpp("predictor");
+
+	// rows. typed features of the input struct in order, and the expected label and id.
+	const auto& columns = ds.x.columns();
+	auto fields = dt::codegen::get_field_names(columns);
+	std::ofstream rows(rows_path);
+	rows.precision(17);
+	for (size_t row_index=0; row_index<df.rows(); row_index++) {
+		for (const auto& column: columns) {
+			const auto& v = df.get_raw(row_index, df.find_column_index(column.name).value());
+			if      (column.data_type == data_type_t::data_type_double) rows << v.numeric_double << ' ';
+			else if (column.data_type == data_type_t::data_type_int)    rows << v.numeric_int32  << ' ';
+			else                                                        rows << v.index          << ' ';
+		}
+		rows << labels[row_index] << ' ' << ids[row_index] << '\n';
+	}
+	rows.close();
+
+	// main to compare.
+	std::ofstream cpp(cpp_path);
+	cpp << "#include \"" << name << ".hpp\"\n";
+	cpp << "#include <fstream>\n";
+	cpp << "int main(int argc, char** argv) {\n";
+	cpp << "\tif (argc != 2) return 2;\n";
+	cpp << "\tstd::ifstream f(argv[1]);\n";
+	cpp << "\tsize_t rows = 0, mismatched = 0;\n";
+	cpp << "\tfor (;;) {\n";
+	cpp << "\t\tpredictor::input x;\n";
+	cpp << "\t\tsize_t label = 0;\n";
+	cpp << "\t\tint id = 0, predicted_id = 0;\n";
+	cpp << "\t\tif (not (f";
+	for (const auto& field: fields) cpp << " >> x." << field;
+	cpp << " >> label >> id)) break;\n";
+	cpp << "\t\tif ((predictor::predict(x, &predicted_id) != label) or (predicted_id != id)) mismatched++;\n";
+	cpp << "\t\trows++;\n";
+	cpp << "\t}\n";
+	cpp << "\treturn ((mismatched == 0) and (rows == " << df.rows() << ")) ? 0 : 1;\n";
+	cpp << "}\n";
+	cpp.close();
+
+	// compile and run.
+	int exitcode = 0;
+#ifdef _MSC_VER
+	auto cmd = gaenari::common::f("\"\"%0\" /nologo /std:c++17 /EHsc /permissive- /O1 /Fo\"%1\\\\\" /Fe\"%2\" \"%3\"\"", {GAENARI_TESTS_CXX_COMPILER, temp_dir, exe_path, cpp_path});
+#else
+	auto cmd = gaenari::common::f("\"%0\" -std=c++17 -O1 -o \"%1\" \"%2\" 2>&1", {GAENARI_TESTS_CXX_COMPILER, exe_path, cpp_path});
+#endif
+	auto output = supul::common::exec(cmd, &exitcode);
+	if (exitcode != 0) TEST_FAIL2("fail to compile the generated code, %0\n%1", cmd, output);
+	supul::common::exec(gaenari::common::f("\"%0\" \"%1\"", {exe_path, rows_path}), &exitcode);
+	if (exitcode != 0) TEST_FAIL1("the generated code predicts differently, %0.", name);
+	gaenari::logger::info("codegen_test matched, {0} rows.", {df.rows()});
+#endif
+}
+
+// level-wise training test.
+// the tree of level-wise training must be the same as the depth-first training.
+inline void level_wise_test(_in int instances, _in int func, _in gaenari::method::decision_tree::split_strategy split_strategy) {
+	namespace dt = gaenari::method::decision_tree;
+
+	// read.
+	gaenari::dataset::dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	gaenari::dataset::dataset ds(df);
+
+	// train depth-first and level-wise.
+	dt::decision_tree depth_first;
+	dt::decision_tree level_wise;
+	dt::train_param param;
+	depth_first.train(ds, split_strategy, 2, 1.2, 0.0, param);
+	param.level_wise = true;
+	level_wise.train(ds, split_strategy, 2, 1.2, 0.0, param);
+
+	// compare with the tree node ids.
+	auto expected = depth_first.stringfy("text/plain", true);
+	auto tested   = level_wise.stringfy("text/plain", true);
+	if (expected != tested) TEST_FAIL2("level-wise tree is different.\n**depth-first**\n%0\n**level-wise**\n%1", expected, tested);
+	gaenari::logger::info("level_wise_test matched, {0} bytes.", {expected.size()});
+}
+
+// online split test.
+// insert and update with model.hoeffding.use, the weak leaf treenodes are split in update().
+// the global values must be consistent, and the unseen instances must be predicted without error.
+// - the global confusion matrix is increased by the inserted instances, and the moved instances of the split are re-counted.
+// - the leaf_info counts of the leaf treenodes(the childs of the online split included) are the same as their instances.
+// - an unseen value of the online nominal split goes to the `other` child.
+inline void hoeffding_test(_in const std::string& projectname, _in int trials, _in int instances, _in int func, _in int start_seed, _in double perturbation, _in bool expected_split) {
+	using rule_type = gaenari::method::decision_tree::rule_t::rule_type;
+
+	// open project.
+	auto supul = open_supul_project_for_agrawal(projectname);
+	if (supul->api.property.get_property("model.hoeffding.use", "false") != "true") TEST_FAIL("model.hoeffding.use is not true.");
+
+	// get db.
+	supul_tester tester{*supul};
+	auto& db = tester.get_db();
+	const auto& attributes = tester.get_attributes();
+
+	// (actual, predicted) -> count of the global confusion matrix.
+	auto get_confusion = [&db]() {
+		std::map<std::pair<int64_t,int64_t>,int64_t> confusion;
+		for (const auto& it: db.get_global_confusion_matrix()) {
+			auto actual    = supul::common::get_variant_int64(it, "actual");
+			auto predicted = supul::common::get_variant_int64(it, "predicted");
+			confusion[{actual, predicted}] += supul::common::get_variant_int64(it, "count");
+		}
+		return confusion;
+	};
+
+	// get global, confusion matrix and split treenodes.
+	auto global_before = db.get_global();
+	auto confusion_before = get_confusion();
+	auto split_treenodes_before = count_split_treenodes(supul);
+
+	// seed.
+	int seed = start_seed;
+
+	for (int i=0; i<trials; i++) {
+		insert_agrawal_chunk(supul, instances, func, seed, perturbation);
+		seed++;
+		if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+	}
+
+	// get global for validation.
+	auto global_after = db.get_global();
+	auto before_instance_count	= supul::common::get_variant_int64(global_before,"instance_count");
+	auto instance_count			= supul::common::get_variant_int64(global_after, "instance_count");
+	auto updated_instance_count	= supul::common::get_variant_int64(global_after, "updated_instance_count");
+	auto instance_correct_count	= supul::common::get_variant_int64(global_after, "instance_correct_count");
+	auto instance_accuracy		= supul::common::get_variant_double(global_after,"instance_accuracy");
+	if (updated_instance_count == 0) TEST_FAIL("update_instance_count is zero.");
+	auto instance_accuracy_calc	= static_cast<double>(instance_correct_count) / static_cast<double>(updated_instance_count);
+
+	// test global values.
+	// the instances moved to the split treenodes are re-evaluated, so the correct count is not precomputed.
+	// it must be the same as the instances.
+	int64_t trials_instance = static_cast<int64_t>(trials) * static_cast<int64_t>(instances);
+	if (instance_count != trials_instance + before_instance_count)			 TEST_FAIL2("fail(instance_count): %0 != %1.", instance_count, trials_instance + before_instance_count);
+	if (updated_instance_count != instance_count)							 TEST_FAIL2("fail(updated_instance_count): %0 != %1.", updated_instance_count, instance_count);
+	if (instance_correct_count != db.get_instance_correct_count())			 TEST_FAIL2("fail(instance_correct_count): %0 != %1.", instance_correct_count, db.get_instance_correct_count());
+	if (not is_approximate_equal(instance_accuracy, instance_accuracy_calc)) TEST_FAIL2("fail(instance_accuracy): %0 != %1.", instance_accuracy, instance_accuracy_calc);
+
+	// test split.
+	auto split_treenodes_after = count_split_treenodes(supul);
+	gaenari::logger::info("split treenodes: {0} -> {1}.", {split_treenodes_before, split_treenodes_after});
+	if (split_treenodes_after < split_treenodes_before) TEST_FAIL2("split treenodes decreased: %0 -> %1.", split_treenodes_before, split_treenodes_after);
+	if (expected_split and (split_treenodes_after == split_treenodes_before)) TEST_FAIL1("no online split: %0.", split_treenodes_after);
+
+	// predict unseen instances.
+	// an unseen nominal value of the split treenode goes to the `other` child, so no error.
+	auto result = predict_csv(supul, create_agrawal_dataset(instances, func, seed, perturbation));
+	if (result.error_count != 0) TEST_FAIL2("predict error: %0 of %1.", result.error_count, result.total_count);
+
+	// test the deltas of the confusion matrix.
+	// all = inserted instances, correct = delta of instance_correct_count.
+	// and it's the same as the scan of all instances.
+	auto confusion_after = get_confusion();
+	int64_t delta_all = 0;
+	int64_t delta_correct = 0;
+	for (const auto& it: confusion_after) {
+		auto find = confusion_before.find(it.first);
+		auto delta = it.second - ((find == confusion_before.end()) ? 0 : find->second);
+		delta_all += delta;
+		if (it.first.first == it.first.second) delta_correct += delta;
+	}
+	auto before_instance_correct_count = supul::common::get_variant_int64(global_before, "instance_correct_count");
+	if (delta_all != trials_instance) TEST_FAIL2("fail(confusion matrix delta): %0 != %1.", delta_all, trials_instance);
+	if (delta_correct != instance_correct_count - before_instance_correct_count) TEST_FAIL2("fail(confusion matrix correct delta): %0 != %1.", delta_correct, instance_correct_count - before_instance_correct_count);
+	auto scanned = db.get_confusion_matrix_by_all_instances();
+	for (const auto& it: confusion_after) {
+		auto count = scanned[static_cast<int>(it.first.first)][static_cast<int>(it.first.second)];
+		if (it.second != count) TEST_FAIL3("fail(confusion matrix): actual %0, predicted %1, %2 != scanned %3.", it.first.first, it.first.second, it.second);
+	}
+
+	// test the leaf_info counts with the instances of the leaf treenodes.
+	// and collect the `other` childs. (parent treenode id, `other` child)
+	std::vector<std::pair<int64_t, supul::type::treenode_db>> others;
+	std::vector<int64_t> stack = {db.get_first_root_ref_treenode_id()};
+	while (not stack.empty()) {
+		auto treenode_id = stack.back();
+		stack.pop_back();
+		for (const auto& child: db.get_treenode(treenode_id)) {
+			if (not child.is_leaf_node) {stack.push_back(child.id); continue;}
+			if (child.leaf_info.type != supul::type::leaf_info_type::leaf) continue;
+			if (child.rule.rule_type == static_cast<int>(rule_type::cmp_other)) others.emplace_back(treenode_id, child);
+			int64_t total_count = 0;
+			int64_t correct_count = 0;
+			db.get_instance_by_leaf_treenode_id(child.id, [&](const auto& row) -> bool {
+				total_count++;
+				if (supul::common::get_variant_int(row, attributes.y) == child.leaf_info.label_index) correct_count++;
+				return true;
+			});
+			if ((child.leaf_info.total_count != total_count) or (child.leaf_info.correct_count != correct_count))
+				TEST_FAIL5("fail(leaf_info of treenode %0): %1/%2 != instances %3/%4.", child.id, child.leaf_info.correct_count, child.leaf_info.total_count, correct_count, total_count);
+		}
+	}
+
+	// an instance of a sibling with the value of the split feature not in the string table.
+	// it goes to the `other` child in predict_main(...) and the compiled forest.
+	size_t other_tested = 0;
+	for (const auto& [parent_id, other]: others) {
+		std::optional<supul::type::map_variant> x;
+		for (const auto& sibling: db.get_treenode(parent_id)) {
+			if ((not sibling.is_leaf_node) or (sibling.id == other.id) or x) continue;
+			db.get_instance_by_leaf_treenode_id(sibling.id, [&x](const auto& row) -> bool {x = row; return false;});
+		}
+		if (not x) continue;
+		x.value()[attributes.x[other.rule.feature_index]] = static_cast<int64_t>(1) << 40;
+		auto expected = tester.predict_main(x.value());
+		auto tested   = tester.predict(x.value());
+		if ((expected.id != other.id) or (tested.id != other.id)) TEST_FAIL3("unseen value is not predicted by the `other` child %0: %1, %2.", other.id, expected.id, tested.id);
+		other_tested++;
+	}
+	gaenari::logger::info("`other` childs of online split: {0}, tested: {1}.", {others.size(), other_tested});
+
+	// verify all.
+	if (not supul->api.test.verify()) TEST_FAIL("fail to supul.api.test.verify().");
+}
+
+// training control test.
+// the node budget, the time budget and the cancellation stop the training,
+// and the stopped tree predicts all rows.
+// - mode : 0(sequential), 1(parallel subtree), 2(level-wise).
+inline void train_control_test(_in int instances, _in int func, _in int mode) {
+	namespace dt = gaenari::method::decision_tree;
+	using stop_reason = dt::train_progress::stop_reason;
+
+	// read.
+	gaenari::dataset::dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	gaenari::dataset::dataset ds(df);
+
+	// train with the control, and returns the last progress.
+	auto train = [&](_in _out dt::train_control& control) -> dt::train_progress {
+		dt::decision_tree tree;
+		dt::train_param param;
+		param.threads    = (mode == 1) ? 4 : 1;
+		param.level_wise = (mode == 2);
+		param.control    = &control;
+		tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+		std::vector<size_t> labels(df.rows());
+		std::vector<int> ids(df.rows());
+		tree.predict(df, labels.data(), ids.data());
+		if (not control.result().finished) TEST_FAIL("the last progress is not finished.");
+		return control.result();
+	};
+
+	// full training.
+	dt::train_control full;
+	auto full_nodes = train(full).nodes;
+	if (full.result().stopped != stop_reason::none) TEST_FAIL("full training is stopped.");
+	if (full_nodes <= 30) TEST_FAIL1("too small tree: %0.", full_nodes);
+
+	// node budget. the budget must not be exceeded.
+	for (size_t max_nodes: {2, 30, 100}) {
+		dt::train_control control;
+		control.max_nodes = max_nodes;
+		auto progress = train(control);
+		gaenari::logger::info("max_nodes: {0}, nodes: {1}.", {max_nodes, progress.nodes});
+		if (progress.nodes > max_nodes) TEST_FAIL2("over the node budget: %0 > %1.", progress.nodes, max_nodes);
+		if ((max_nodes < full_nodes) and (progress.stopped != stop_reason::node_budget)) TEST_FAIL1("not stopped by the node budget: %0.", max_nodes);
+	}
+
+	// time budget. the progress callback takes the time.
+	{
+		dt::train_control control;
+		control.time_budget_msec = 1;
+		control.progress_interval_msec = 0;
+		control.progress = [](_in const dt::train_progress&) {std::this_thread::sleep_for(std::chrono::milliseconds(2));};
+		auto progress = train(control);
+		gaenari::logger::info("time budget, nodes: {0}.", {progress.nodes});
+		if (progress.stopped != stop_reason::time_budget) TEST_FAIL("not stopped by the time budget.");
+		if (progress.nodes >= full_nodes) TEST_FAIL2("not stopped early by the time budget: %0 >= %1.", progress.nodes, full_nodes);
+	}
+
+	// cancel in the progress callback.
+	{
+		dt::train_control control;
+		control.progress_interval_msec = 0;
+		control.progress = [&control](_in const dt::train_progress& p) {if (p.nodes >= 10) control.cancel();};
+		auto progress = train(control);
+		gaenari::logger::info("canceled, nodes: {0}.", {progress.nodes});
+		if (progress.stopped != stop_reason::canceled) TEST_FAIL("not canceled.");
+		if (progress.nodes >= full_nodes) TEST_FAIL2("not stopped early by the cancellation: %0 >= %1.", progress.nodes, full_nodes);
+	}
+}
+
+// nominal_min_support test of decision_tree.
+// color: red(40, yes), blue(40, no), green(3, maybe).
+// with nominal_min_support(10), green is grouped into the `other` child,
+// and it's predicted through the `other` child by the tree nodes and the compiled tree.
+// a value not in the string table(purple) goes to the `other` child, too, in all predict paths.
+// without it, green has its own child, and purple does not match.
+inline void nominal_min_support_test(void) {
+	using namespace gaenari::dataset;
+	namespace dt = gaenari::method::decision_tree;
+
+	// write csv files.
+	auto train_path = supul::common::path_join_const(temp_dir, "nominal_min_support_train.csv");
+	auto test_path  = supul::common::path_join_const(temp_dir, "nominal_min_support_test.csv");
+	std::ofstream train_csv(train_path);
+	train_csv << "color,size,class\n";
+	for (int i=0; i<40; i++) train_csv << "red,"   << i % 7 << ",yes\n";
+	for (int i=0; i<40; i++) train_csv << "blue,"  << i % 7 << ",no\n";
+	for (int i=0; i<3;  i++) train_csv << "green," << i % 7 << ",maybe\n";
+	train_csv.close();
+	std::ofstream(test_path) << "color,size,class\nred,1,yes\ngreen,1,maybe\npurple,1,maybe\n";
+
+	// read.
+	auto read = [](_in const std::string& csv_path, _out dataframe& df) {
+		if (not df.read<repository_csv>({{"csv_file_path", csv_path}}, {
+			usecols::names({"size"}, data_type_t::data_type_int),
+			usecols::names({"color", "class"}, data_type_t::data_type_string)})) TEST_FAIL1("fail to read csv %0.", csv_path);
+	};
+	dataframe train_df;
+	dataframe test_df;
+	read(train_path, train_df);
+	read(test_path, test_df);
+	dataset ds(train_df);
+
+	for (size_t nominal_min_support: {10, 0}) {
+		// train.
+		dt::decision_tree tree;
+		dt::train_param param;
+		param.nominal_min_support = nominal_min_support;
+		tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+
+		// predict with the compiled tree. (red, green, purple)
+		std::vector<int> ids(3, -1);
+		std::vector<size_t> labels(3);
+		tree.predict(test_df, labels.data(), ids.data());
+
+		// predict with the tree nodes and with the pre-typed row on the compiled tree. (red, green, purple)
+		// purple is not in the string table of the tree.
+		tree.compile();
+		for (size_t i=0; i<3; i++) {
+			const std::map<std::string, std::string> test{{"color", std::vector<std::string>{"red", "green", "purple"}[i]}, {"size", "1"}};
+			int id = -1;
+			auto label = tree.predict(test, &id);
+			if ((id != ids[i]) or (label != labels[i])) TEST_FAIL3("tree nodes mis-match at row %0, id %1 != %2.", i, id, ids[i]);
+			std::vector<gaenari::type::value_raw> row;
+			tree.get_typed_row(test, row);
+			id = -1;
+			label = tree.predict(row.data(), &id);
+			if ((id != ids[i]) or (label != labels[i])) TEST_FAIL3("pre-typed row mis-match at row %0, id %1 != %2.", i, id, ids[i]);
+		}
+		if ((ids[2] == -1) and (labels[2] != std::numeric_limits<size_t>::max())) TEST_FAIL("not matched purple has a label.");
+
+		// test.
+		if ((ids[0] == -1) or (ids[1] == -1)) TEST_FAIL("red or green is not matched.");
+		if ((ids[0] == ids[1]) or (labels[0] == labels[1])) TEST_FAIL("red and green are predicted the same.");
+		if (nominal_min_support > 0) {
+			// green and purple are in the `other` child.
+			if (ids[1] != ids[2]) TEST_FAIL2("green(%0) and purple(%1) are not the same `other` leaf.", ids[1], ids[2]);
+		} else {
+			// no `other` child.
+			if (ids[2] != -1) TEST_FAIL1("purple is matched without nominal_min_support: %0.", ids[2]);
+		}
+	}
+}
+
+// nominal_min_support test of supul.
+// elevel decides the group, and level3 and level4 are rare.
+// with model.train.nominal_min_support(20), they are grouped into the `other` child of build,
+// and level5 inserted after build goes to the `other` child, too.
+// the compiled forest and predict_main(eval_treenode) predict the same leaf.
+inline void nominal_min_support_supul_test(_in const std::string& projectname) {
+	using rule_type = gaenari::method::decision_tree::rule_t::rule_type;
+
+	// open project.
+	auto supul = open_supul_project_for_agrawal(projectname);
+	if (supul->api.property.get_property("model.train.nominal_min_support", "0") != "20") TEST_FAIL("model.train.nominal_min_support is not 20.");
+
+	// write agrawal csv with the elevels.
+	auto write_csv = [](_in const std::string& csv_path, _in const std::vector<int>& elevels) {
+		std::ofstream csv(csv_path);
+		csv << "salary,commission,age,elevel,car,zipcode,hvalue,hyears,loan,group\n";
+		for (size_t i=0; i<elevels.size(); i++) {
+			int age = 20 + static_cast<int>(i % 60);
+			bool a = (elevels[i] == 0) or ((elevels[i] == 2) and (age < 40));
+			csv << 20000 + (i * 7919) % 130000 << ",0," << age << ",level" << elevels[i] << ",car" << 1 + i % 20 << ",zipcode" << 1 + i % 9 << ',';
+			csv << 100000 + i * 1000 << ',' << 1 + i % 30 << ',' << i * 1000 << ',' << (a ? "groupA" : "groupB") << '\n';
+		}
+	};
+	std::vector<int> build_elevels;
+	for (int i=0; i<300; i++) build_elevels.push_back(i % 3);
+	for (int i=0; i<10;  i++) build_elevels.push_back(3 + i % 2);
+	auto build_path  = supul::common::path_join_const(temp_dir, "nominal_min_support_build.csv");
+	auto insert_path = supul::common::path_join_const(temp_dir, "nominal_min_support_insert.csv");
+	write_csv(build_path,  build_elevels);
+	write_csv(insert_path, std::vector<int>(5, 5));
+
+	// build.
+	if (not supul->api.model.insert_chunk_csv(build_path)) TEST_FAIL("fail to supul.api.insert_chunk_csv().");
+	if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+
+	// the rare elevels are predicted through the `other` child, and the others are not.
+	auto leaves = compare_predict_csv(supul, build_path);
+	if (leaves.size() != build_elevels.size()) TEST_FAIL2("predicted count: %0 != %1.", leaves.size(), build_elevels.size());
+	for (size_t i=0; i<leaves.size(); i++) {
+		bool other = (leaves[i].rule.rule_type == static_cast<int>(rule_type::cmp_other));
+		if (other != (build_elevels[i] >= 3)) TEST_FAIL2("level%0 at row %1 is predicted through the wrong child.", build_elevels[i], i);
+	}
+
+	// level5 is not seen in build.
+	if (not supul->api.model.insert_chunk_csv(insert_path)) TEST_FAIL("fail to supul.api.insert_chunk_csv().");
+	if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+	for (const auto& leaf: compare_predict_csv(supul, insert_path)) {
+		if (leaf.rule.rule_type != static_cast<int>(rule_type::cmp_other)) TEST_FAIL("level5 is not predicted through the `other` child.");
+	}
+
+	// verify all.
+	if (not supul->api.test.verify()) TEST_FAIL("fail to supul.api.test.verify().");
+}
+
+// high-cardinality nominal split test of supul.
+// the label depends only on car(60 values), so the tree is split by car with many childs,
+// and the child is found by hash. (type::treenode_childs::nominal_index)
+// the hashed child must be the same as evaluating the rules of all childs(eval_treenode),
+// for the values of the childs, a value without a child, and an id not in the string table.
+inline void nominal_index_supul_test(_in const std::string& projectname) {
+	// open project.
+	auto supul = open_supul_project_for_agrawal(projectname);
+	supul_tester tester{*supul};
+
+	// write agrawal csv, only car is informative.
+	auto csv_path = supul::common::path_join_const(temp_dir, "nominal_index.csv");
+	std::vector<std::unordered_map<std::string, std::string>> instances;
+	std::ofstream csv(csv_path);
+	csv << "salary,commission,age,elevel,car,zipcode,hvalue,hyears,loan,group\n";
+	for (int i=0; i<600; i++) {
+		int car = i % 60;
+		std::string group = (car % 3 == 0) ? "groupA" : "groupB";
+		csv << "50000,0,40,level0,car" << car << ",zipcode1,100000,10,1000," << group << '\n';
+		instances.push_back({{"salary", "50000"}, {"commission", "0"}, {"age", "40"}, {"elevel", "level0"}, {"car", "car" + std::to_string(car)},
+							 {"zipcode", "zipcode1"}, {"hvalue", "100000"}, {"hyears", "10"}, {"loan", "1000"}});
+	}
+	csv.close();
+
+	// build.
+	if (not supul->api.model.insert_chunk_csv(csv_path)) TEST_FAIL("fail to supul.api.insert_chunk_csv().");
+	if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+
+	// typed instances, and the ones with a value without a child(zipcode1) and an id not in the string table.
+	std::vector<supul::type::map_variant> xs;
+	for (const auto& instance: instances) xs.push_back(tester.to_map_variant(instance));
+	for (int64_t car: {std::get<1>(xs[0]["zipcode"]), static_cast<int64_t>(1) << 40}) {
+		auto x = xs[0];
+		x["car"] = car;
+		xs.push_back(std::move(x));
+	}
+
+	// compare the hashed child and the linear scan of all split treenodes. (root ref treenode included)
+	auto& db = tester.get_db();
+	size_t hashed = 0;
+	std::vector<int64_t> stack = {db.get_first_root_ref_treenode_id()};
+	while (not stack.empty()) {
+		auto treenode_id = stack.back();
+		stack.pop_back();
+		for (const auto& child: db.get_treenode(treenode_id)) if (not child.is_leaf_node) stack.push_back(child.id);
+		if (not tester.has_nominal_index(treenode_id)) continue;
+		hashed++;
+		for (size_t i=0; i<xs.size(); i++) {
+			auto expected = tester.get_matched_treenode_linear(treenode_id, xs[i]);
+			auto tested   = tester.get_matched_treenode(treenode_id, xs[i]);
+			if (expected.has_value() != tested.has_value()) TEST_FAIL2("match mis-match of treenode %0 at row %1.", treenode_id, i);
+			if (expected and (expected.value().id != tested.value().id)) TEST_FAIL4("treenode %0 at row %1: hashed child %2 != %3.", treenode_id, i, tested.value().id, expected.value().id);
+		}
+	}
+	if (hashed == 0) TEST_FAIL("no nominal split with many childs.");
+
+	// the compiled forest is the same.
+	compare_predict_csv(supul, csv_path);
+
+	// verify all.
+	if (not supul->api.test.verify()) TEST_FAIL("fail to supul.api.test.verify().");
+}
+
+// compiled forest predict test.
+// the compiled forest of predict must be the same as predict_main(...) after each committed change.
+// one supul object predicts before and after the changes, so a stale forest is found.
+// - update, rebuild, and insert with chunk limit.
+inline void forest_predict_test(_in const std::string& projectname, _in int instances) {
+	// open project.
+	auto supul = open_supul_project_for_agrawal(projectname);
+
+	// instances to predict.
+	auto csv_path = create_agrawal_dataset(instances, 2, 100, 0.05);
+
+	// build.
+	insert_agrawal_chunk(supul, instances, 1, 0);
+	if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+	compare_predict_csv(supul, csv_path);
+
+	// update. concept drifted, the leaf counts are changed.
+	insert_agrawal_chunk(supul, instances, 2, 1);
+	if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+	compare_predict_csv(supul, csv_path);
+
+	// rebuild. a new generation.
+	if (not supul->api.model.rebuild()) TEST_FAIL("fail to supul.api.model.rebuild().");
+	compare_predict_csv(supul, csv_path);
+
+	// insert with chunk limit. the old chunks are removed, and the leaf counts are changed.
+	if (not supul->api.property.set_property("limit.chunk.instance_upper_bound", std::to_string(instances * 2))) TEST_FAIL("fail to set_property.");
+	if (not supul->api.property.set_property("limit.chunk.instance_lower_bound", std::to_string(instances)))	 TEST_FAIL("fail to set_property.");
+	if (not supul->api.property.set_property("limit.chunk.use", "true"))										 TEST_FAIL("fail to set_property.");
+	if (not supul->api.property.save()) TEST_FAIL("fail to property save.");
+	auto& db = supul_tester(*supul).get_db();
+	auto before_instance_count = supul::common::get_variant_int64(db.get_global(), "instance_count");
+	insert_agrawal_chunk(supul, instances, 2, 2);
+	auto instance_count = supul::common::get_variant_int64(db.get_global(), "instance_count");
+	if (instance_count >= before_instance_count + instances) TEST_FAIL2("no chunk is removed: %0 -> %1.", before_instance_count, instance_count);
+	compare_predict_csv(supul, csv_path);
+
+	// update the inserted chunk.
+	if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+	compare_predict_csv(supul, csv_path);
+
+	// verify all.
+	if (not supul->api.test.verify()) TEST_FAIL("fail to supul.api.test.verify().");
+}
+
+// dataframe spill test.
+// - read_spill within the budget is in memory, and over the budget is spilled and memory mapped.
+// - write_spill and open_spill round trip.
+// - the spill file is removed on clear with remove_on_clear.
+// - the corrupted files are rejected by open_spill.
+// all dataframes must have the same values and train the same tree as in memory.
+inline void spill_test(_in int instances, _in int func) {
+	using namespace gaenari::dataset;
+	namespace dt = gaenari::method::decision_tree;
+
+	// in memory.
+	auto csv_path = create_agrawal_dataset(instances, func, 0, 0.05);
+	dataframe df;
+	read_agrawal_dataframe(csv_path, df);
+	if (df.is_mapped()) TEST_FAIL("in memory dataframe is mapped.");
+
+	// train and stringfy.
+	auto train = [](_in const dataframe& df) {
+		dataset ds(df);
+		dt::decision_tree tree;
+		dt::train_param param;
+		tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+		return tree.stringfy("text/plain", true);
+	};
+	const auto expected = train(df);
+
+	// the same values and tree as in memory.
+	auto check = [&](_in const std::string& name, _in const dataframe& tested) {
+		if ((tested.rows() != df.rows()) or (tested.cols() != df.cols())) TEST_FAIL3("%0: size mis-match, %1 != %2.", name, tested.rows(), df.rows());
+		for (size_t row=0; row<df.rows(); row++) {
+			for (size_t col=0; col<df.cols(); col++) {
+				if (tested.get(row, col) != df.get(row, col)) TEST_FAIL3("%0: value mis-match at (%1, %2).", name, row, col);
+			}
+		}
+		if (train(tested) != expected) TEST_FAIL1("%0: different tree.", name);
+	};
+	auto spill_path = supul::common::path_join_const(temp_dir, "spill_test.spill");
+	std::filesystem::remove(spill_path);
+
+	// read_spill within the budget.
+	{
+		dataframe tested;
+		if (tested.read_spill<repository_csv>({{"csv_file_path", csv_path}}, get_agrawal_usecols(), nullptr, spill_path, 1 << 30)) TEST_FAIL("spilled within the budget.");
+		if (tested.is_mapped() or std::filesystem::exists(spill_path)) TEST_FAIL("spill file within the budget.");
+		check("read_spill(in memory)", tested);
+	}
+
+	// read_spill over the budget. removed on clear.
+	{
+		dataframe tested;
+		if (not tested.read_spill<repository_csv>({{"csv_file_path", csv_path}}, get_agrawal_usecols(), nullptr, spill_path, 4096)) TEST_FAIL("not spilled over the budget.");
+		if ((not tested.is_mapped()) or (not std::filesystem::exists(spill_path))) TEST_FAIL("no spill file over the budget.");
+		check("read_spill(spilled)", tested);
+		tested.clear();
+		if (std::filesystem::exists(spill_path)) TEST_FAIL("spill file is not removed on clear.");
+	}
+
+	// write_spill and open_spill.
+	{
+		df.write_spill(spill_path);
+		dataframe tested;
+		tested.open_spill(spill_path);
+		if (not tested.is_mapped()) TEST_FAIL("open_spill is not mapped.");
+		check("open_spill", tested);
+		tested.clear();
+		if (not std::filesystem::exists(spill_path)) TEST_FAIL("spill file is removed without remove_on_clear.");
+
+		// remove_on_clear.
+		tested.open_spill(spill_path, true);
+		check("open_spill(remove_on_clear)", tested);
+		tested.clear();
+		if (std::filesystem::exists(spill_path)) TEST_FAIL("spill file is not removed on clear.");
+	}
+
+	// rejected files. (extra data bytes, columns over the data offset)
+	{
+		df.write_spill(spill_path);
+		std::ifstream in(spill_path, std::ios::binary);
+		std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.close();
+		std::filesystem::remove(spill_path);
+		uint64_t cols = 0, data_offset = 0, strings_offset = 0;
+		memcpy(&cols, bytes.data() + 24, sizeof(cols));
+		memcpy(&data_offset, bytes.data() + 32, sizeof(data_offset));
+		memcpy(&strings_offset, bytes.data() + 40, sizeof(strings_offset));
+		if ((cols < 2) or (strings_offset > bytes.size())) TEST_FAIL("unexpected spill file.");
+
+		auto corrupted_path = supul::common::path_join_const(temp_dir, "spill_test.corrupted.spill");
+		auto reject = [&](_in const std::string& what, _in const std::vector<char>& corrupted) {
+			std::ofstream(corrupted_path, std::ios::binary | std::ios::trunc).write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+			dataframe tested;
+			bool rejected = false;
+			try {
+				tested.open_spill(corrupted_path, true);
+			} catch (const gaenari::exceptions::error& /*e*/) {
+				rejected = true;
+			}
+			if (not rejected) TEST_FAIL1("%0 spill file is not rejected.", what);
+			if (tested.is_mapped()) TEST_FAIL1("%0 spill file is mapped.", what);
+			tested.clear();
+			std::filesystem::remove(corrupted_path);
+		};
+
+		// one value more than rows * cols. (the quotient is still rows)
+		{
+			auto corrupted = bytes;
+			corrupted.insert(corrupted.begin() + static_cast<std::ptrdiff_t>(strings_offset), sizeof(gaenari::type::value_raw), 0);
+			const uint64_t moved = strings_offset + sizeof(gaenari::type::value_raw);
+			memcpy(corrupted.data() + 40, &moved, sizeof(moved));
+			reject("extra data", corrupted);
+		}
+
+		// the last column name is extended over the data offset, still in the file.
+		{
+			size_t pos = 48, last = 0;
+			uint32_t length = 0;
+			for (uint64_t i=0; i<cols; i++) {
+				last = pos + sizeof(uint32_t) + sizeof(uint64_t);
+				memcpy(&length, bytes.data() + last, sizeof(length));
+				pos = last + sizeof(length) + length;
+			}
+			auto corrupted = bytes;
+			length += static_cast<uint32_t>(data_offset - pos + 1);
+			memcpy(corrupted.data() + last, &length, sizeof(length));
+			reject("columns over the data", corrupted);
+		}
+	}
+}
+
+// supul rebuild with the memory budget test.
+// - the instances over the budget are spilled, and the rebuilt model is the same as in memory.
+// - a stale rebuild.spill is removed before, and the spill file is removed after the rebuild.
+// the project of projectname is rebuilt in memory, and the project of projectname + "_spill" with the budget.
+inline void spill_rebuild_test(_in const std::string& projectname, _in int instances) {
+	// insert instances over 1 MB, and rebuild all leaves.
+	auto rebuild = [&](_in supul_ptr& supul, _in const std::string& memory_budget_mb, _in const std::string& stale_spill_path) {
+		if (not supul->api.property.set_property("model.rebuild.memory_budget_mb", memory_budget_mb)) TEST_FAIL("fail to set_property.");
+		if (not supul->api.property.set_property("model.weak_treenode_condition.accuracy", "1.0"))	 TEST_FAIL("fail to set_property.");
+		if (not supul->api.property.set_property("model.weak_treenode_condition.total_count", "1"))	 TEST_FAIL("fail to set_property.");
+		if (not supul->api.property.save()) TEST_FAIL("fail to property save.");
+		insert_agrawal_chunk(supul, instances, 1, 0);
+		if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+		if (not stale_spill_path.empty()) {
+			std::ofstream(stale_spill_path, std::ios::binary | std::ios::trunc) << "stale spill file";
+			if (not std::filesystem::exists(stale_spill_path)) TEST_FAIL("fail to create the stale spill file.");
+		}
+		if (not supul->api.model.rebuild()) TEST_FAIL("fail to supul.api.model.rebuild().");
+		if (not supul->api.test.verify()) TEST_FAIL("fail to supul.api.test.verify().");
+		return supul::common::get_variant_int64(supul_tester(*supul).get_db().get_global(), "instance_correct_count");
+	};
+
+	// in memory.
+	auto supul = open_supul_project_for_agrawal(projectname);
+	const auto expected = rebuild(supul, "0", "");
+
+	// with the memory budget, and a stale spill file of the previous rebuild.
+	auto supul_spill = create_supul_project_for_agrawal(projectname + "_spill");
+	supul::type::paths paths;
+	supul::common::get_paths(get_project_dir(projectname + "_spill"), paths);
+	auto spill_path = supul::common::path_join_const(paths.base_dir, "rebuild.spill");
+	const auto tested = rebuild(supul_spill, "1", spill_path);
+	if (tested != expected) TEST_FAIL2("instance_correct_count mis-match, %0 != %1.", tested, expected);
+	if (std::filesystem::exists(spill_path)) TEST_FAIL("spill file is not removed after rebuild.");
+}
+
+// binary tree file test.
+// the mapped tree of write_binary(...) must predict the same as decision_tree::predict(...) for all rows,
+// and the truncated or corrupted files are rejected.
+inline void binary_tree_test(_in int instances, _in int func, _in size_t nominal_min_support) {
+	using namespace gaenari::dataset;
+	namespace dt = gaenari::method::decision_tree;
+
+	// train.
+	dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	dataset ds(df);
+	dt::decision_tree tree;
+	dt::train_param param;
+	param.nominal_min_support = nominal_min_support;
+	tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+
+	// write.
+	auto name = gaenari::common::f("binary_tree_f%0_m%1", {func, nominal_min_support});
+	auto path = supul::common::path_join_const(temp_dir, name + ".bin");
+	tree.write_binary(path);
+
+	// (feature name, value) map of the rows.
+	const auto& columns = ds.x.columns();
+	auto get_row = [&](_in size_t row_index) {
+		std::map<std::string, std::string> m;
+		for (const auto& column: columns) {
+			auto col = df.find_column_index(column.name).value();
+			std::ostringstream value;
+			value.precision(17);
+			if      (column.data_type == data_type_t::data_type_double) value << df.get_double(row_index, col);
+			else if (column.data_type == data_type_t::data_type_int)    value << df.get_int(row_index, col);
+			else                                                        value << df.get_string(row_index, col);
+			m[column.name] = value.str();
+		}
+		return m;
+	};
+
+	// the same predict for all rows.
+	for (bool verify: {true, false}) {
+		dt::mapped_tree mapped;
+		mapped.open(path, verify);
+		if (mapped.get_y_name() != ds.y.columns()[0].name) TEST_FAIL2("y name mis-match, %0 != %1.", mapped.get_y_name(), ds.y.columns()[0].name);
+		if (mapped.get_columns().size() != columns.size()) TEST_FAIL2("column count mis-match, %0 != %1.", mapped.get_columns().size(), columns.size());
+		for (size_t row_index=0; row_index<df.rows(); row_index++) {
+			auto m = get_row(row_index);
+			int id = -1;
+			int mapped_id = -1;
+			auto label = tree.predict(m, &id);
+			auto mapped_label = mapped.predict(m, &mapped_id);
+			if ((mapped_label != label) or (mapped_id != id)) TEST_FAIL3("mapped tree mis-match at row %0, id %1 != %2.", row_index, mapped_id, id);
+		}
+		mapped.close();
+		if (mapped.is_open()) TEST_FAIL("mapped tree is open after close.");
+	}
+
+	// file bytes.
+	std::ifstream in(path, std::ios::binary);
+	std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	if (bytes.size() < sizeof(dt::mapped_tree::file_header)) TEST_FAIL1("too small tree file, %0.", bytes.size());
+
+	// rejected files. (truncated, magic, version, byte order)
+	auto corrupted_path = supul::common::path_join_const(temp_dir, name + ".corrupted.bin");
+	auto reject = [&](_in const std::string& what, _in const std::vector<char>& corrupted) {
+		std::ofstream(corrupted_path, std::ios::binary | std::ios::trunc).write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+		dt::mapped_tree mapped;
+		bool rejected = false;
+		try {
+			mapped.open(corrupted_path);
+		} catch (const gaenari::exceptions::error& /*e*/) {
+			rejected = true;
+		}
+		if (not rejected) TEST_FAIL1("%0 tree file is not rejected.", what);
+		if (mapped.is_open()) TEST_FAIL1("%0 tree file is open.", what);
+	};
+	auto patch = [&](_in size_t offset, _in uint32_t value) {
+		auto corrupted = bytes;
+		memcpy(corrupted.data() + offset, &value, sizeof(value));
+		return corrupted;
+	};
+	reject("truncated", std::vector<char>(bytes.begin(), bytes.end() - 1));
+	reject("truncated header", std::vector<char>(bytes.begin(), bytes.begin() + sizeof(dt::mapped_tree::file_header) / 2));
+	{
+		auto corrupted = bytes;
+		corrupted[0] ^= 0xff;
+		reject("bad magic", corrupted);
+	}
+	reject("bad version", patch(offsetof(dt::mapped_tree::file_header, version), dt::mapped_tree::version + 1));
+	reject("bad byte order", patch(offsetof(dt::mapped_tree::file_header, byte_order), 0x04030201));
+
+	// the original file is still loaded.
+	dt::mapped_tree mapped;
+	mapped.open(path);
+	if (mapped.node_count() == 0) TEST_FAIL("no nodes.");
+}
+
+// snapshot file test.
+// the mapped forest of export_snapshot(...) must predict the same as supul.api.model.predict(...) for all rows,
+// after build, update and rebuild(go to generation), and the truncated or corrupted files are rejected.
+inline void snapshot_test(_in const std::string& projectname, _in int instances) {
+	// open project.
+	auto supul = open_supul_project_for_agrawal(projectname);
+
+	// instances to predict.
+	auto csv_path = create_agrawal_dataset(instances, 2, 100, 0.05);
+	auto path = supul::common::path_join_const(temp_dir, projectname + ".snapshot");
+
+	// export, and compare with supul.api.model.predict(...).
+	auto compare = [&](void) {
+		if (not supul->api.model.export_snapshot(path)) TEST_FAIL("fail to supul.api.model.export_snapshot().");
+		supul::snapshot::mapped_forest mapped;
+		mapped.open(path);
+		size_t row_index = 0;
+		size_t predicted = 0;
+		if (not gaenari::dataset::for_each_csv(csv_path, ',', nullptr, [&](auto& row, auto& header_map) -> bool {
+			std::unordered_map<std::string, std::string> instance;
+			for (const auto& it: header_map) instance[it.first] = row[it.second];
+			auto expected = supul->api.model.predict(instance);
+			auto tested   = mapped.predict(instance);
+			if (expected.error != tested.error) TEST_FAIL3("predict error mis-match at row %0: %1, %2.", row_index, expected.errormsg, tested.errormsg);
+			if ((expected.label_index != tested.label_index) or (expected.label != tested.label) or (expected.correct_count != tested.correct_count) or
+				(expected.total_count != tested.total_count) or (not is_approximate_equal(expected.accuracy, tested.accuracy)))
+				TEST_FAIL3("predict mis-match at row %0: label %1 != %2.", row_index, expected.label, tested.label);
+			if (not expected.error) predicted++;
+			row_index++;
+			return true;
+		})) TEST_FAIL1("fail to for_each_csv %0.", csv_path);
+		if (predicted == 0) TEST_FAIL1("no rows are predicted, %0 rows.", row_index);
+	};
+
+	// build.
+	insert_agrawal_chunk(supul, instances, 1, 0);
+	if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+	compare();
+
+	// update. concept drifted, the leaf counts are changed.
+	insert_agrawal_chunk(supul, instances, 2, 1);
+	if (not supul->api.model.update()) TEST_FAIL("fail to supul.api.model.update().");
+	compare();
+
+	// rebuild. a new generation.
+	if (not supul->api.model.rebuild()) TEST_FAIL("fail to supul.api.model.rebuild().");
+	compare();
+
+	// file bytes.
+	std::ifstream in(path, std::ios::binary);
+	std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	if (bytes.size() < sizeof(supul::snapshot::mapped_forest::file_header)) TEST_FAIL1("too small snapshot file, %0.", bytes.size());
+
+	// rejected files. (truncated, magic, version, byte order)
+	using header_t = supul::snapshot::mapped_forest::file_header;
+	auto corrupted_path = supul::common::path_join_const(temp_dir, projectname + ".corrupted.snapshot");
+	auto reject = [&](_in const std::string& what, _in const std::vector<char>& corrupted) {
+		std::ofstream(corrupted_path, std::ios::binary | std::ios::trunc).write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+		supul::snapshot::mapped_forest mapped;
+		bool rejected = false;
+		try {
+			mapped.open(corrupted_path);
+		} catch (...) {
+			rejected = true;
+		}
+		if (not rejected) TEST_FAIL1("%0 snapshot file is not rejected.", what);
+		if (mapped.is_open()) TEST_FAIL1("%0 snapshot file is open.", what);
+	};
+	auto patch = [&](_in size_t offset, _in uint32_t value) {
+		auto corrupted = bytes;
+		memcpy(corrupted.data() + offset, &value, sizeof(value));
+		return corrupted;
+	};
+	reject("truncated", std::vector<char>(bytes.begin(), bytes.end() - 1));
+	reject("truncated header", std::vector<char>(bytes.begin(), bytes.begin() + sizeof(header_t) / 2));
+	{
+		auto corrupted = bytes;
+		corrupted[0] ^= 0xff;
+		reject("bad magic", corrupted);
+	}
+	reject("bad version", patch(offsetof(header_t, version), supul::snapshot::mapped_forest::version + 1));
+	reject("bad byte order", patch(offsetof(header_t, byte_order), 0x04030201));
+
+	// verify all.
+	if (not supul->api.test.verify()) TEST_FAIL("fail to supul.api.test.verify().");
+}
+
+// parallel subtree test.
+// the tree of the parallel subtree training must be the same as the single thread training, tree node ids included.
+// an exception in the training stops the subtree tasks, and it's re-thrown by train(...).
+inline void parallel_subtree_test(_in int instances, _in int func) {
+	namespace dt = gaenari::method::decision_tree;
+
+	// read.
+	gaenari::dataset::dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	gaenari::dataset::dataset ds(df);
+
+	// single thread.
+	dt::decision_tree single;
+	dt::train_param param;
+	single.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+	auto expected = single.stringfy("text/plain", true);
+
+	// subtrees of the root(all rows) and of the childs.
+	for (size_t parallel_subtree_rows: {static_cast<size_t>(instances) + 1, static_cast<size_t>(instances) / 2}) {
+		dt::decision_tree parallel;
+		param.threads = 4;
+		param.parallel_subtree_rows = parallel_subtree_rows;
+		parallel.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+		auto tested = parallel.stringfy("text/plain", true);
+		if (expected != tested) TEST_FAIL2("parallel subtree tree is different.\n**single**\n%0\n**parallel**\n%1", expected, tested);
+	}
+
+	// the progress callback throws while the subtree tasks are running.
+	// the calling thread throws after a task has reported, and the tasks refer to the locals of train(...).
+	for (int repeat=0; repeat<10; repeat++) {
+		const auto main_thread = std::this_thread::get_id();
+		std::atomic<bool> task_reported{false};
+		dt::train_control control;
+		control.progress_interval_msec = 0;
+		control.progress = [&](_in const dt::train_progress& p) {
+			if (p.finished) return;
+			if (std::this_thread::get_id() != main_thread) task_reported = true;
+			if ((task_reported and (std::this_thread::get_id() == main_thread)) or (p.nodes >= 50)) throw std::runtime_error("parallel_subtree_test");
+		};
+		dt::decision_tree parallel;
+		param.threads = 4;
+		param.parallel_subtree_rows = static_cast<size_t>(instances) / 2;
+		param.control = &control;
+		bool thrown = false;
+		try {
+			parallel.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+		} catch (const std::runtime_error& e) {
+			thrown = (std::string(e.what()) == "parallel_subtree_test");
+		}
+		if (not thrown) TEST_FAIL1("the exception of the training is not re-thrown, repeat %0.", repeat);
+		param.control = nullptr;
+	}
+}
+
+// parallel feature evaluation test.
+// the tree of the multi-thread training must be the same as the single thread training, tree node ids included.
+// all nodes evaluate the features in parallel. (parallel_feature_min_rows = 1)
+inline void parallel_feature_test(_in int instances, _in int func, _in gaenari::method::decision_tree::split_strategy split_strategy) {
+	namespace dt = gaenari::method::decision_tree;
+
+	// read.
+	gaenari::dataset::dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	gaenari::dataset::dataset ds(df);
+
+	// single thread.
+	dt::decision_tree single;
+	dt::train_param param;
+	single.train(ds, split_strategy, 2, 1.2, 0.0, param);
+	auto expected = single.stringfy("text/plain", true);
+
+	// multi-thread.
+	for (size_t threads: {2, 4}) {
+		dt::decision_tree parallel;
+		param.threads = threads;
+		param.parallel_feature_min_rows = 1;
+		parallel.train(ds, split_strategy, 2, 1.2, 0.0, param);
+		auto tested = parallel.stringfy("text/plain", true);
+		if (expected != tested) TEST_FAIL3("the tree of %0 threads is different.\n**single**\n%1\n**parallel**\n%2", threads, expected, tested);
+	}
+	gaenari::logger::info("parallel_feature_test matched, {0} bytes.", {expected.size()});
+}
+
+// sampled split search test.
+// - the features are ranked on a small stratified sample, but the split of the chosen feature is of all rows.
+// - nothing to reduce(top features >= feature count, sample rows >= rows), the tree is the same as the full search.
+// - the sampled tree is the same regardless of the threads.
+// - level-wise training rejects the sampled split search.
+inline void sample_split_test(_in int instances, _in int func, _in size_t sample_rows) {
+	namespace dt = gaenari::method::decision_tree;
+
+	// read.
+	gaenari::dataset::dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	gaenari::dataset::dataset ds(df);
+	const auto feature_count = ds.x.columns().size();
+
+	// same split infos?
+	auto same_split_infos = [](const std::vector<dt::split_info>& a, const std::vector<dt::split_info>& b) {
+		if (a.size() != b.size()) return false;
+		for (size_t i=0; i<a.size(); i++) {
+			const auto& ra = a[i].rule;
+			const auto& rb = b[i].rule;
+			if ((ra.type != rb.type) or (ra.feature_indexes.size() != rb.feature_indexes.size()) or (ra.args.size() != rb.args.size())) return false;
+			if (not std::equal(ra.feature_indexes.begin(), ra.feature_indexes.end(), rb.feature_indexes.begin())) return false;
+			if (not std::equal(ra.args.begin(), ra.args.end(), rb.args.begin())) return false;
+			if (not std::equal(a[i].predicted_count.count.begin(), a[i].predicted_count.count.end(), b[i].predicted_count.count.begin(), b[i].predicted_count.count.end())) return false;
+		}
+		return true;
+	};
+
+	// split of the root with a small sample.
+	// the chosen feature is evaluated again with all rows,
+	// so the split infos are the same as the full search of the chosen feature only.
+	dt::dense_label labels;
+	labels.build(ds);
+	std::vector<size_t> rows(ds.x.rows());
+	for (size_t i=0; i<rows.size(); i++) rows[i] = i;
+	dt::row_range row_selections{rows.data(), rows.data() + rows.size()};
+	std::vector<size_t> label_count(labels.size(), 0);
+	labels.count(row_selections, label_count.data());
+	auto sampled = dt::engine::split_tree_sampled(ds, labels, row_selections, label_count.data(), dt::split_strategy::split_strategy_default, 2, 0, sample_rows, 1);
+	if (sampled.empty()) TEST_FAIL("no sampled split of the root.");
+	std::vector<bool> chosen(feature_count, false);
+	chosen[sampled[0].rule.feature_indexes[0]] = true;
+	auto full = dt::engine::split_tree(ds, labels, row_selections, label_count.data(), dt::split_strategy::split_strategy_default, 2, 0, nullptr, nullptr, &chosen);
+	if (not same_split_infos(sampled, full)) TEST_FAIL1("the sampled split of feature %0 is not of all rows.", sampled[0].rule.feature_indexes[0]);
+	size_t total = 0;
+	for (const auto& split_info: sampled) for (const auto& it: split_info.predicted_count.count) total += it.second;
+	if (total != rows.size()) TEST_FAIL2("the sampled split counts %0 rows, expected %1.", total, rows.size());
+
+	// full search.
+	dt::decision_tree expected_tree;
+	dt::train_param param;
+	expected_tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+	auto expected = expected_tree.stringfy("text/plain", true);
+
+	// nothing to reduce, it falls back to the full search.
+	param.sample_min_rows = 1;
+	for (auto [rows_of_sample, top_features]: std::vector<std::pair<size_t,size_t>>{{sample_rows, feature_count}, {static_cast<size_t>(instances), 1}}) {
+		dt::decision_tree tree;
+		param.sample_rows = rows_of_sample;
+		param.sample_top_features = top_features;
+		tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+		auto tested = tree.stringfy("text/plain", true);
+		if (expected != tested) TEST_FAIL4("the fall back tree of sample_rows=%0, sample_top_features=%1 is different.\n**full**\n%2\n**sampled**\n%3", rows_of_sample, top_features, expected, tested);
+	}
+
+	// small sample, single thread and multi-thread.
+	param.sample_rows = sample_rows;
+	param.sample_top_features = 2;
+	dt::decision_tree single;
+	single.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+	auto sampled_tree = single.stringfy("text/plain", true);
+	dt::decision_tree parallel;
+	param.threads = 4;
+	param.parallel_feature_min_rows = 1;
+	parallel.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+	auto tested = parallel.stringfy("text/plain", true);
+	if (sampled_tree != tested) TEST_FAIL2("the sampled tree of 4 threads is different.\n**single**\n%0\n**parallel**\n%1", sampled_tree, tested);
+
+	// level-wise training rejects it.
+	bool rejected = false;
+	param.level_wise = true;
+	try {
+		dt::decision_tree level_wise;
+		level_wise.train(ds, dt::split_strategy::split_strategy_histogram, 2, 1.2, 0.0, param);
+	} catch (const gaenari::exceptions::error& /*e*/) {
+		rejected = true;
+	}
+	if (not rejected) TEST_FAIL("level-wise training with sample_min_rows is not rejected.");
+	gaenari::logger::info("sample_split_test matched, {0} bytes.", {sampled_tree.size()});
+}
+
+// random feature subspace test.
+// - the mask has `subspace` features of feature_count, and it's empty if all features are used.
+// - the mask of a node depends only on the seed and the path, and the siblings have their own masks.
+// - the tree is the same regardless of the threads and level_wise.
+inline void feature_subspace_test(_in int instances, _in int func, _in size_t subspace, _in int seed) {
+	namespace dt = gaenari::method::decision_tree;
+
+	// read.
+	gaenari::dataset::dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	gaenari::dataset::dataset ds(df);
+	const auto feature_count = ds.x.columns().size();
+
+	// masks of the nodes of a small tree. (root, 3 childs and 9 grand childs)
+	int treenode_id = 0;
+	auto* root = dt::tree_node::build_root_node(treenode_id);
+	std::vector<dt::tree_node*> nodes = {root};
+	for (auto* child: dt::tree_node::build_child_nodes(*root, 3, treenode_id)) {
+		nodes.push_back(child);
+		for (auto* grand_child: dt::tree_node::build_child_nodes(*child, 3, treenode_id)) nodes.push_back(grand_child);
+	}
+	for (size_t all: {static_cast<size_t>(0), feature_count, feature_count + 1}) {
+		if (not dt::util::get_feature_subspace(*nodes.back(), feature_count, all, seed).empty()) TEST_FAIL1("the mask of subspace %0 is not empty.", all);
+	}
+	std::set<std::vector<bool>> masks;
+	for (auto* node: nodes) {
+		auto mask = dt::util::get_feature_subspace(*node, feature_count, subspace, seed);
+		auto count = static_cast<size_t>(std::count(mask.begin(), mask.end(), true));
+		if ((mask.size() != feature_count) or (count != subspace)) TEST_FAIL3("invalid mask of node %0, size %1, count %2.", node->id, mask.size(), count);
+		if (mask != dt::util::get_feature_subspace(*node, feature_count, subspace, seed)) TEST_FAIL1("the mask of node %0 is not deterministic.", node->id);
+		masks.insert(std::move(mask));
+	}
+	if (masks.size() < 2) TEST_FAIL("all nodes have the same mask.");
+	root->destroy_all_child_node(true);
+
+	// single thread.
+	dt::decision_tree single;
+	dt::train_param param;
+	param.feature_subspace = subspace;
+	param.feature_subspace_seed = seed;
+	single.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+	auto expected = single.stringfy("text/plain", true);
+
+	// multi-thread. (parallel subtrees and parallel features)
+	dt::decision_tree parallel;
+	param.threads = 4;
+	param.parallel_feature_min_rows = 1;
+	param.parallel_subtree_rows = static_cast<size_t>(instances) / 2;
+	parallel.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+	auto tested = parallel.stringfy("text/plain", true);
+	if (expected != tested) TEST_FAIL2("the subspace tree of 4 threads is different.\n**single**\n%0\n**parallel**\n%1", expected, tested);
+
+	// level-wise.
+	dt::decision_tree level_wise;
+	param.threads = 1;
+	param.level_wise = true;
+	level_wise.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+	tested = level_wise.stringfy("text/plain", true);
+	if (expected != tested) TEST_FAIL2("the level-wise subspace tree is different.\n**depth-first**\n%0\n**level-wise**\n%1", expected, tested);
+	gaenari::logger::info("feature_subspace_test matched, {0} bytes.", {expected.size()});
+}
+
+// parallel eval test.
+// eval_parallel(...) must be the same as eval(...) : accuracy, correct count, predicteds and confusion matrix.
+// some test rows have an elevel not seen in training(unknown predicted), and a label only in the test data.
+inline void eval_parallel_test(_in int instances, _in int func) {
+	namespace dt = gaenari::method::decision_tree;
+
+	// train.
+	gaenari::dataset::dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	gaenari::dataset::dataset ds(df);
+	dt::decision_tree tree;
+	dt::train_param param;
+	tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.2, 0.0, param);
+
+	// test csv of the other seed, with unseen elevels and labels.
+	// (salary,commission,age,elevel,car,zipcode,hvalue,hyears,loan,group)
+	auto csv_path = supul::common::path_join_const(temp_dir, "eval_parallel.csv");
+	std::ifstream in(create_agrawal_dataset(instances * 2, func, 1, 0.05));
+	std::ofstream out(csv_path);
+	std::string line;
+	for (size_t i=0; std::getline(in, line); i++) {
+		if ((i > 0) and ((i % 97 == 0) or (i % 101 == 0))) {
+			std::vector<std::string> values;
+			std::stringstream ss(line);
+			for (std::string value; std::getline(ss, value, ',');) values.push_back(value);
+			if (values.size() != 10) TEST_FAIL1("invalid agrawal csv line %0.", i);
+			if (i % 97  == 0) values[3] = "level_unseen";
+			if (i % 101 == 0) values[9] = "group_unseen";
+			line.clear();
+			for (size_t j=0; j<values.size(); j++) line += (j == 0 ? "" : ",") + values[j];
+		}
+		out << line << '\n';
+	}
+	in.close();
+	out.close();
+	gaenari::dataset::dataframe tests;
+	read_agrawal_dataframe(csv_path, tests);
+
+	// serial.
+	double expected_accuracy = 0.0;
+	size_t expected_correct_count = 0;
+	std::vector<size_t> expected_predicteds;
+	std::map<size_t,std::map<size_t,size_t>> expected_confusion;
+	tree.eval(tests, expected_accuracy, &expected_confusion, &expected_predicteds, &expected_correct_count);
+	if (std::count(expected_predicteds.begin(), expected_predicteds.end(), std::numeric_limits<size_t>::max()) == 0) gaenari::logger::warn("eval_parallel_test, no unknown predicted.");
+
+	// parallel. (multiple chunks with 4 threads)
+	for (size_t threads: {1, 4}) {
+		double accuracy = 0.0;
+		size_t correct_count = 0;
+		std::vector<size_t> predicteds;
+		dt::confusion_matrix confusion;
+		std::map<size_t,std::map<size_t,size_t>> confusion_map;
+		tree.eval_parallel(tests, accuracy, &confusion, &predicteds, &correct_count, threads);
+		confusion.to_map(confusion_map);
+		if (accuracy != expected_accuracy) TEST_FAIL3("accuracy of %0 threads: %1 != %2.", threads, accuracy, expected_accuracy);
+		if (correct_count != expected_correct_count) TEST_FAIL3("correct count of %0 threads: %1 != %2.", threads, correct_count, expected_correct_count);
+		if (predicteds != expected_predicteds) TEST_FAIL1("predicteds of %0 threads are different.", threads);
+		if (confusion_map != expected_confusion) TEST_FAIL3("confusion matrix of %0 threads is different.\n**eval**\n%1\n**eval_parallel**\n%2", threads, tree.to_string_confusion_matrix(expected_confusion), tree.to_string_confusion_matrix(confusion_map));
+	}
+	gaenari::logger::info("eval_parallel_test matched, accuracy {0}.", {expected_accuracy});
+}
+
+// post-processing test.
+// engine::post_processing(...) is one post-order pass of pruning and combining same labels.
+// it must be the same as the previous fixed-point loop, repeating post pruning and combining same labels
+// over the whole tree until nothing changes.
+// the trees are trained with the minimum pruning weight(1.0), and post-processed again with the weights.
+inline void post_processing_test(_in int instances, _in int func) {
+	namespace dt = gaenari::method::decision_tree;
+
+	// access the protected things.
+	struct tree_tester: public dt::decision_tree {
+		dt::tree_node& get_root(void) {return *root;}
+	};
+	struct engine_tester: public dt::engine {
+		using dt::engine::get_leaf_info;
+	};
+
+	// the previous post pruning. returns true if pruned.
+	auto post_pruning = [](dt::tree_node& root, double weight) {
+		bool found = false;
+		for (;;) {
+			bool pruned = false;
+			dt::util::traverse_tree_node(root, [&pruned,weight](dt::tree_node& node, int /*depth*/) -> bool {
+				if (not dt::util::is_terminal_node(node)) return true;
+				dt::leaf_info_t leaf_info;
+				engine_tester::get_leaf_info(node.predicted_count.count, leaf_info);
+				size_t child_total_count = 0;
+				size_t child_incorrect_count = 0;
+				for (const auto& child: node.childs) {
+					child_total_count += child->leaf_info.correct_count + child->leaf_info.incorrect_count;
+					child_incorrect_count += child->leaf_info.incorrect_count;
+				}
+				double current_error_rate = static_cast<double>(leaf_info.incorrect_count) / static_cast<double>(leaf_info.correct_count + leaf_info.incorrect_count);
+				double child_error_rate   = static_cast<double>(child_incorrect_count) / static_cast<double>(child_total_count) * weight;
+				if (current_error_rate < child_error_rate) {
+					node.leaf = true;
+					node.leaf_info = leaf_info;
+					node.destroy_all_child_node(false);
+					pruned = true;
+				}
+				return true;
+			});
+			if (not pruned) break;
+			found = true;
+		}
+		return found;
+	};
+
+	// the previous combining same labels(except root). returns true if combined.
+	auto combine_same_label = [](dt::tree_node& root) {
+		bool found = false;
+		for (;;) {
+			bool combined = false;
+			dt::util::traverse_tree_node(root, [&combined](dt::tree_node& node, int depth) -> bool {
+				if ((depth == 0) or node.leaf) return true;
+				for (const auto& child: node.childs) {
+					if ((not child->leaf) or (child->leaf_info.label_string_index != node.childs[0]->leaf_info.label_string_index)) return true;
+				}
+				node.leaf = true;
+				engine_tester::get_leaf_info(node.predicted_count.count, node.leaf_info);
+				node.destroy_all_child_node(false);
+				combined = true;
+				return true;
+			});
+			if (not combined) break;
+			found = true;
+		}
+		return found;
+	};
+
+	// read.
+	gaenari::dataset::dataframe df;
+	read_agrawal_dataframe(create_agrawal_dataset(instances, func, 0, 0.05), df);
+	gaenari::dataset::dataset ds(df);
+
+	for (double weight: {1.0, 1.2, 1.5, 2.0, 4.0}) {
+		tree_tester tested_tree;
+		tree_tester expected_tree;
+		dt::train_param param;
+		tested_tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.0, 0.0, param);
+		expected_tree.train(ds, dt::split_strategy::split_strategy_default, 2, 1.0, 0.0, param);
+
+		// one pass.
+		dt::engine::post_processing(tested_tree.get_root(), weight);
+
+		// fixed-point loop.
+		for (;;) {
+			auto pruned   = post_pruning(expected_tree.get_root(), weight);
+			auto combined = combine_same_label(expected_tree.get_root());
+			if (not pruned and not combined) break;
+		}
+
+		auto expected = expected_tree.stringfy("text/plain", true);
+		auto tested   = tested_tree.stringfy("text/plain", true);
+		if (expected != tested) TEST_FAIL3("post-processed tree of weight %0 is different.\n**fixed-point loop**\n%1\n**one pass**\n%2", weight, expected, tested);
+		gaenari::logger::info("post_processing_test matched, weight {0}, {1} bytes.", {weight, expected.size()});
+	}
+}
+
 #endif // HEADER_UNIT_TEST_HPP
@@ -47,6 +47,22 @@ int main(int argc, const char** argv) try
 		else if (scenario_name == "large")			scenario_largesize("large");
 		else if (scenario_name == "predict")		scenario_predict("predict");
 		else if (scenario_name == "limit_chunk")	scenario_limit_chunk("limit_chunk");
+		else if (scenario_name == "codegen")		scenario_codegen("codegen");
+		else if (scenario_name == "level_wise")		scenario_level_wise("level_wise");
+		else if (scenario_name == "hoeffding")		scenario_hoeffding("hoeffding");
+		else if (scenario_name == "train_control")	scenario_train_control("train_control");
+		else if (scenario_name == "nominal_min_support")	scenario_nominal_min_support("nominal_min_support");
+		else if (scenario_name == "forest_predict")	scenario_forest_predict("forest_predict");
+		else if (scenario_name == "spill")			scenario_spill("spill");
+		else if (scenario_name == "binary_tree")	scenario_binary_tree("binary_tree");
+		else if (scenario_name == "snapshot")		scenario_snapshot("snapshot");
+		else if (scenario_name == "parallel_subtree")	scenario_parallel_subtree("parallel_subtree");
+		else if (scenario_name == "parallel_feature")	scenario_parallel_feature("parallel_feature");
+		else if (scenario_name == "sample_split")		scenario_sample_split("sample_split");
+		else if (scenario_name == "feature_subspace")	scenario_feature_subspace("feature_subspace");
+		else if (scenario_name == "nominal_index")		scenario_nominal_index("nominal_index");
+		else if (scenario_name == "eval_parallel")		scenario_eval_parallel("eval_parallel");
+		else if (scenario_name == "post_processing")	scenario_post_processing("post_processing");
 		else	TEST_FAIL1("invalid scenario name: %0", scenario_name);
 	}
 
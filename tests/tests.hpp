@@ -5,6 +5,8 @@
 // - create_supul_project_for_agrawal()
 // - open_supul_project_for_agrawal()
 // - insert_agrawal_chunk()
+// - compare_predict_csv()
+// - count_split_treenodes()
 
 namespace supul::supul {
 // supul_tester.
@@ -20,6 +22,63 @@ public:
 	inline auto& get_db(void) {return supul.model.get_db();}
 	inline auto& get_model(void) {return supul.model;}
 	inline auto& get_attributes(void) {return supul.attributes;}
+
+public:
+	// predict with the compiled forest. (model::predict)
+	inline auto predict(_in const std::unordered_map<std::string, std::string>& x) -> type::treenode_db {
+		return predict(to_map_variant(x));
+	}
+	inline auto predict(_in const type::map_variant& typed_x) -> type::treenode_db {
+		return supul.model.predict(typed_x);
+	}
+
+	// predict with the treenodes of the database and the caches. (model::predict_main, eval_treenode)
+	inline auto predict_main(_in const std::unordered_map<std::string, std::string>& x) -> type::treenode_db {
+		return predict_main(to_map_variant(x));
+	}
+	inline auto predict_main(_in const type::map_variant& typed_x) -> type::treenode_db {
+		db::transaction_guard transaction{supul.model.get_db(), false};
+		auto predict_info = supul.model.predict_main(typed_x);
+		if (predict_info.status == type::predict_status::leaf_node) return predict_info.leaf_treenode;
+		if (predict_info.status == type::predict_status::middle_node) return predict_info.middle_treenode;
+		THROW_SUPUL_RULE_NOT_MATCHED_ERROR("no rule matched.");
+	}
+
+	// typed instance of x.
+	inline auto to_map_variant(_in const std::unordered_map<std::string, std::string>& x) -> type::map_variant {
+		type::map_variant typed_x;
+		common::to_map_variant(x, typed_x, supul.schema.get_table_info(type::table::instance).fields, supul.string_table.get_table());
+		return typed_x;
+	}
+
+	// is the child of the parent treenode found by hash? (type::treenode_childs::nominal_index)
+	inline bool has_nominal_index(_in int64_t parent_treenode_id) {
+		db::transaction_guard transaction{supul.model.get_db(), false};
+		std::lock_guard<std::recursive_mutex> l(supul.model.treenode_cache.get_mutex());
+		return not supul.model.get_treenode_childs_from_cache(parent_treenode_id).nominal_index.empty();
+	}
+
+	// the child of the parent treenode matched with x. (model::get_matched_treenode_from_cache)
+	inline auto get_matched_treenode(_in int64_t parent_treenode_id, _in const type::map_variant& x) -> std::optional<type::treenode_db> {
+		db::transaction_guard transaction{supul.model.get_db(), false};
+		return supul.model.get_matched_treenode_from_cache(parent_treenode_id, x);
+	}
+
+	// the child of the parent treenode matched with x by evaluating the rules of all childs, the cmp_other child at last. (model::eval_treenode)
+	inline auto get_matched_treenode_linear(_in int64_t parent_treenode_id, _in const type::map_variant& x) -> std::optional<type::treenode_db> {
+		using rule_type = gaenari::method::decision_tree::rule_t::rule_type;
+		db::transaction_guard transaction{supul.model.get_db(), false};
+		const auto childs = supul.model.get_treenode_from_cache(parent_treenode_id);
+		for (const auto& child: childs) {
+			if (child.rule.rule_type == static_cast<int>(rule_type::cmp_other)) continue;
+			if (supul.model.eval_treenode(child, x)) return child;
+		}
+		for (const auto& child: childs) {
+			if (child.rule.rule_type == static_cast<int>(rule_type::cmp_other)) return child;
+		}
+		return std::nullopt;
+	}
+
 public:
 	supul_t& supul;
 };
@@ -106,4 +165,49 @@ inline auto predict_csv(_in supul_ptr& supul, _in const std::string& csv_path) {
 	return ret;
 }
 
+// predict instances in csv with the compiled forest and predict_main(...), and they must be the same.
+// returns the leaf treenodes of predict_main(...). (with rule)
+inline auto compare_predict_csv(_in supul_ptr& supul, _in const std::string& csv_path) {
+	std::vector<supul::type::treenode_db> ret;
+	supul_tester tester{*supul};
+
+	if (not gaenari::dataset::for_each_csv(csv_path, ',', nullptr, [&](auto& row, auto& header_map) -> bool {
+		std::unordered_map<std::string, std::string> instance;
+		for (const auto& it: header_map) instance[it.first] = row[it.second];
+		std::optional<supul::type::treenode_db> expected;
+		std::optional<supul::type::treenode_db> tested;
+		try { expected = tester.predict_main(instance); } catch(...) {}
+		try { tested   = tester.predict(instance);      } catch(...) {}
+		if (expected.has_value() != tested.has_value()) TEST_FAIL1("predict error mis-match at row %0.", ret.size());
+		if (not expected) TEST_FAIL1("no rule matched at row %0.", ret.size());
+		const auto& e = expected.value().leaf_info;
+		const auto& t = tested.value().leaf_info;
+		if ((expected.value().id != tested.value().id) or (e.label_index != t.label_index) or (e.correct_count != t.correct_count) or
+			(e.total_count != t.total_count) or (not is_approximate_equal(e.accuracy, t.accuracy)))
+			TEST_FAIL3("predict mis-match at row %0: treenode %1 != %2.", ret.size(), expected.value().id, tested.value().id);
+		ret.emplace_back(std::move(expected.value()));
+		return true;
+	})) TEST_FAIL1("fail to for_each_csv %0.", csv_path);
+
+	return ret;
+}
+
+// count the non-leaf treenodes of the first generation.
+// zero if not trained.
+inline int64_t count_split_treenodes(_in supul_ptr& supul) {
+	auto& db = supul_tester(*supul).get_db();
+	int64_t count = 0;
+	if (db.get_is_generation_empty()) return 0;
+	std::vector<int64_t> stack;
+	for (const auto& root: db.get_treenode(db.get_first_root_ref_treenode_id())) if (not root.is_leaf_node) stack.push_back(root.id);
+	while (not stack.empty()) {
+		auto treenode_id = stack.back();
+		stack.pop_back();
+		auto childs = db.get_treenode(treenode_id);
+		count++;
+		for (const auto& child: childs) if (not child.is_leaf_node) stack.push_back(child.id);
+	}
+	return count;
+}
+
 #endif // HEADER_TESTS_HPP
@@ -108,6 +108,151 @@ inline void scenario_predict(_in const std::string& projectname) {
 	TESTCASE_OK("predict", predict_test2, projectname, instances, 4);
 }
 
+// train a tree -> generate c++ code -> compile, and compare with decision_tree::predict.
+inline void scenario_codegen(_in const std::string& /*projectname*/) {
+	// test parameter.
+	int instances = 10000;
+
+	// numeric and nominal splits.
+	TESTCASE_OK("codegen", codegen_test, instances, 1, 0);
+	TESTCASE_OK("codegen", codegen_test, instances, 2, 0);
+
+	// rare nominal values are grouped into the `other` child.
+	TESTCASE_OK("codegen_other", codegen_test, instances, 3, 100);
+}
+
+// train depth-first and level-wise, and the trees must be the same.
+inline void scenario_level_wise(_in const std::string& /*projectname*/) {
+	// test parameter.
+	int instances = 10000;
+
+	TESTCASE_OK("level_wise_default",   level_wise_test, instances, 1, gaenari::method::decision_tree::split_strategy::split_strategy_default);
+	TESTCASE_OK("level_wise_default",   level_wise_test, instances, 2, gaenari::method::decision_tree::split_strategy::split_strategy_default);
+	TESTCASE_OK("level_wise_histogram", level_wise_test, instances, 1, gaenari::method::decision_tree::split_strategy::split_strategy_histogram);
+	TESTCASE_OK("level_wise_histogram", level_wise_test, instances, 2, gaenari::method::decision_tree::split_strategy::split_strategy_histogram);
+}
+
+// the node budget, the time budget and the cancellation of training in each mode.
+inline void scenario_train_control(_in const std::string& /*projectname*/) {
+	// test parameter.
+	int instances = 10000;
+
+	TESTCASE_OK("train_control_sequential",       train_control_test, instances, 2, 0);
+	TESTCASE_OK("train_control_parallel_subtree", train_control_test, instances, 2, 1);
+	TESTCASE_OK("train_control_level_wise",       train_control_test, instances, 2, 2);
+}
+
+// dataframe spill files, and training on them.
+inline void scenario_spill(_in const std::string& projectname) {
+	TESTCASE_OK("spill", spill_test, 10000, 1);
+	TESTCASE_OK("spill", spill_test, 10000, 2);
+	TESTCASE_OK("create_project", create_project_test, projectname);
+	TESTCASE_OK("spill_rebuild", spill_rebuild_test, projectname, 20000);
+}
+
+// binary tree file, and predict on the mapped tree.
+inline void scenario_binary_tree(_in const std::string& /*projectname*/) {
+	TESTCASE_OK("binary_tree", binary_tree_test, 10000, 1, 0);
+	TESTCASE_OK("binary_tree", binary_tree_test, 10000, 2, 0);
+	TESTCASE_OK("binary_tree", binary_tree_test, 10000, 2, 100);
+}
+
+// export the snapshot file, and predict on the mapped forest.
+inline void scenario_snapshot(_in const std::string& projectname) {
+	TESTCASE_OK("create_project", create_project_test, projectname);
+	TESTCASE_OK("snapshot", snapshot_test, projectname, 1000);
+}
+
+// parallel subtree training.
+inline void scenario_parallel_subtree(_in const std::string& /*projectname*/) {
+	TESTCASE_OK("parallel_subtree", parallel_subtree_test, 10000, 1);
+	TESTCASE_OK("parallel_subtree", parallel_subtree_test, 10000, 2);
+	TESTCASE_OK("parallel_subtree", parallel_subtree_test, 10000, 3);
+}
+
+// parallel feature evaluation of training.
+inline void scenario_parallel_feature(_in const std::string& /*projectname*/) {
+	using dt_split_strategy = gaenari::method::decision_tree::split_strategy;
+	for (int func: {1, 2, 3}) {
+		TESTCASE_OK("parallel_feature_default",   parallel_feature_test, 10000, func, dt_split_strategy::split_strategy_default);
+		TESTCASE_OK("parallel_feature_histogram", parallel_feature_test, 10000, func, dt_split_strategy::split_strategy_histogram);
+	}
+}
+
+// sampled split search of training.
+inline void scenario_sample_split(_in const std::string& /*projectname*/) {
+	TESTCASE_OK("sample_split", sample_split_test, 10000, 1, 100);
+	TESTCASE_OK("sample_split", sample_split_test, 10000, 2, 100);
+	TESTCASE_OK("sample_split", sample_split_test, 10000, 3, 500);
+}
+
+// random feature subspace of training.
+inline void scenario_feature_subspace(_in const std::string& /*projectname*/) {
+	TESTCASE_OK("feature_subspace", feature_subspace_test, 10000, 1, 3, 0);
+	TESTCASE_OK("feature_subspace", feature_subspace_test, 10000, 2, 3, 7);
+	TESTCASE_OK("feature_subspace", feature_subspace_test, 10000, 3, 5, 11);
+}
+
+// parallel eval of dataframe.
+inline void scenario_eval_parallel(_in const std::string& /*projectname*/) {
+	TESTCASE_OK("eval_parallel", eval_parallel_test, 10000, 1);
+	TESTCASE_OK("eval_parallel", eval_parallel_test, 10000, 2);
+	TESTCASE_OK("eval_parallel", eval_parallel_test, 10000, 3);
+}
+
+// post-processing of training.
+inline void scenario_post_processing(_in const std::string& /*projectname*/) {
+	TESTCASE_OK("post_processing", post_processing_test, 10000, 1);
+	TESTCASE_OK("post_processing", post_processing_test, 10000, 2);
+	TESTCASE_OK("post_processing", post_processing_test, 10000, 3);
+}
+
+// predict with the compiled forest, and it must be the same as predict_main(...) after the model is changed.
+inline void scenario_forest_predict(_in const std::string& projectname) {
+	TESTCASE_OK("create_project", create_project_test, projectname);
+	TESTCASE_OK("forest_predict", forest_predict_test, projectname, 1000);
+}
+
+// rare nominal values grouped into the `other` child.
+inline void scenario_nominal_min_support(_in const std::string& projectname) {
+	// decision_tree.
+	TESTCASE_OK("nominal_min_support_decision_tree", nominal_min_support_test);
+
+	// supul.
+	TESTCASE_OK("create_project", create_project_test, projectname);
+	TESTCASE_OK("nominal_min_support_property_on", set_property_test, projectname, "model.train.nominal_min_support", "20");
+	TESTCASE_OK("nominal_min_support_supul", nominal_min_support_supul_test, projectname);
+}
+
+// high-cardinality nominal split of supul.
+inline void scenario_nominal_index(_in const std::string& projectname) {
+	TESTCASE_OK("create_project", create_project_test, projectname);
+	TESTCASE_OK("nominal_index_supul", nominal_index_supul_test, projectname);
+}
+
+// online split with model.hoeffding.*, and concept drifted.
+inline void scenario_hoeffding(_in const std::string& projectname) {
+	// create project.
+	TESTCASE_OK("create_project", create_project_test, projectname);
+
+	// aggressive parameters to split often.
+	TESTCASE_OK("hoeffding_property_on", set_property_test, projectname, "model.hoeffding.use", "true");
+	TESTCASE_OK("hoeffding_property_on", set_property_test, projectname, "model.hoeffding.grace_period", "10");
+	TESTCASE_OK("hoeffding_property_on", set_property_test, projectname, "model.hoeffding.delta", "0.3");
+	TESTCASE_OK("hoeffding_property_on", set_property_test, projectname, "model.hoeffding.tie_threshold", "0.5");
+
+	// test parameter.
+	int trials		= 5;
+	int instances	= 1000;
+	double pert		= 0.05;
+
+	// the first chunk is trained, and the next chunks may split.
+	TESTCASE_OK("no_concept_drifting", hoeffding_test, projectname, trials, instances, 1, 0, pert, false);
+
+	// concept drifted, the weak leaf treenodes must be split.
+	TESTCASE_OK("concept_drifted", hoeffding_test, projectname, trials, instances, 2, 0, pert, true);
+}
+
 inline void scenario_limit_chunk(_in const std::string& projectname) {
 	// create project.
 	TESTCASE_OK("create_project", create_project_test, projectname);
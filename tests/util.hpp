@@ -9,6 +9,8 @@
 //	- get_sha1()
 //	- http_download()
 //	- create_agrawal_dataset()
+//	- get_agrawal_usecols()
+//	- read_agrawal_dataframe()
 
 // if the <exe_dir/develop.txt> file exists in debug, development.hpp is run instead of test.
 inline bool is_develop_mode(void) {
@@ -189,6 +191,21 @@ inline std::string create_agrawal_dataset(_in int instances, _in int func, _in i
 	return ret_csv_path;
 }
 
+// usecols of agrawal csv.
+// salary, commission, hvalue, loan are double, age, hyears are int, and the others are string.
+inline std::vector<gaenari::dataset::usecols> get_agrawal_usecols(void) {
+	using namespace gaenari::dataset;
+	return {usecols::names({"salary", "commission", "hvalue", "loan"}, data_type_t::data_type_double),
+			usecols::names({"age", "hyears"}, data_type_t::data_type_int),
+			usecols::names({"elevel", "car", "zipcode", "group"}, data_type_t::data_type_string)};
+}
+
+// read agrawal csv to dataframe.
+inline void read_agrawal_dataframe(_in const std::string& csv_path, _out gaenari::dataset::dataframe& df) {
+	using namespace gaenari::dataset;
+	if (not df.read<repository_csv>({{"csv_file_path", csv_path}}, get_agrawal_usecols())) TEST_FAIL1("fail to read csv %0.", csv_path);
+}
+
 // create attributes.json for agrawal dataset.
 // {
 // 	"revision": 0,